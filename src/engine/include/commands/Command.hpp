@@ -33,6 +33,12 @@ struct Command {
     rfl::Field<"type_", rfl::Literal<"monitor_url">> type;
   };
 
+  /// Keeps the connection open after this command, so that the client can
+  /// send any number of further commands over the same connection.
+  struct SessionOp {
+    rfl::Field<"type_", rfl::Literal<"session">> type;
+  };
+
   struct ShutdownOp {
     rfl::Field<"type_", rfl::Literal<"shutdown">> type;
   };
@@ -40,7 +46,7 @@ struct Command {
   using ReflectionType =
       std::variant<ColumnCommand, DatabaseCommand, DataFrameCommand,
                    PipelineCommand, ProjectCommand, ViewCommand, IsAliveOp,
-                   MonitorURLOp, ShutdownOp>;
+                   MonitorURLOp, SessionOp, ShutdownOp>;
 
   using InputVarType = typename rfl::json::Reader::InputVarType;
 
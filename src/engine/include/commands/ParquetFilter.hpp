@@ -0,0 +1,36 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef COMMANDS_PARQUETFILTER_HPP_
+#define COMMANDS_PARQUETFILTER_HPP_
+
+#include "commands/Float.hpp"
+
+#include <rfl/Field.hpp>
+
+#include <optional>
+#include <string>
+
+namespace commands {
+
+/// Restricts the rows read from a parquet file to those for which the value
+/// in a column lies between lower and upper (both inclusive). Rows containing
+/// NULL values in that column are dropped.
+struct ParquetFilter {
+  /// The name of the column the filter applies to.
+  rfl::Field<"column_", std::string> column;
+
+  /// The smallest value to keep, if any.
+  rfl::Field<"lower_", std::optional<Float>> lower;
+
+  /// The greatest value to keep, if any.
+  rfl::Field<"upper_", std::optional<Float>> upper;
+};
+
+}  // namespace commands
+
+#endif  // COMMANDS_PARQUETFILTER_HPP_
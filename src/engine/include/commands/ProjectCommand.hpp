@@ -10,6 +10,7 @@
 
 #include "commands/DataContainer.hpp"
 #include "commands/DataFrameOrView.hpp"
+#include "commands/ParquetFilter.hpp"
 #include "commands/Pipeline.hpp"
 #include "helpers/Saver.hpp"
 
@@ -67,11 +68,13 @@ struct ProjectCommand {
     rfl::Field<"time_formats_", std::vector<std::string>> time_formats;
   };
 
-  /// The command to add a data frame from parquet.
+  /// The command to add a data frame from parquet. fname can also be a
+  /// directory or a glob pattern matching several files.
   struct AddDfFromParquetOp {
     using Tag = rfl::Literal<"DataFrame.read_parquet">;
     rfl::Flatten<helpers::SchemaImpl> schema;
     rfl::Field<"append_", bool> append;
+    rfl::Field<"filters_", std::optional<std::vector<ParquetFilter>>> filters;
     rfl::Field<"fname_", std::string> fname;
   };
 
@@ -23,6 +23,8 @@
 
 namespace communication {
 
+/// Receives data from the client. Numbers always arrive in network byte
+/// order and are swapped in place on little-endian hosts.
 struct Receiver {
   static constexpr const char *GETML_SEP = "$GETML_SEP";
 
@@ -31,6 +33,10 @@ struct Receiver {
   static void recv(const ULong _size, Poco::Net::StreamSocket *_socket,
                    T *_data);
 
+  /// Receives exactly _size bytes from the client.
+  static void recv_bytes(const ULong _size, Poco::Net::StreamSocket *_socket,
+                         char *_data);
+
   /// Receives a string from the client
   static std::string recv_string(Poco::Net::StreamSocket *_socket);
 
@@ -46,51 +52,16 @@ struct Receiver {
 template <class T>
 void Receiver::recv(const ULong _size, Poco::Net::StreamSocket *_socket,
                     T *_data) {
-  const ULong len = 4096;
-
-  ULong j = 0;
-
-  // -------------------------------------------------------------------
-  // Receive len bytes at most, write them into the buffer and then
-  // copy to the output data.
-
-  // This assumes that T* has enough data allocated.
-
-  // We also assume that the size of the data to be sent is known.
-
-  std::vector<char> buf(len);
-
-  while (true) {
-    const ULong current_len = std::min(len, _size - j);
-
-    if (current_len == 0) {
-      break;
-    }
-
-    if (current_len != len) {
-      buf.resize(current_len);
-    }
-
-    for (size_t num_bytes_received = 0; num_bytes_received < buf.size();) {
-      const auto nbytes = _socket->receiveBytes(
-          buf.data() + num_bytes_received,
-          static_cast<int>(buf.size() - num_bytes_received));
-
-      if (nbytes <= 0) {
-        throw std::runtime_error(
-            "Broken pipe while attempting to receive "
-            "data.");
-      }
-
-      num_bytes_received += static_cast<size_t>(nbytes);
-    }
+  // is_arithmetic includes numeric values and char.
+  // http://en.cppreference.com/w/cpp/types/is_arithmetic
+  static_assert(std::is_arithmetic<T>::value,
+                "Only arithmetic types allowed for recv<T>(...)!");
 
-    for (size_t i = 0; i < buf.size(); ++i, ++j) {
-      reinterpret_cast<char *>(_data)[j] = buf.data()[i];
-    }
-  }
+  assert_true(_size % sizeof(T) == 0);
 
-  assert_true(j == _size);
+  // This assumes that T* has enough data allocated. The data is received
+  // directly into it, without any intermediate buffer.
+  recv_bytes(_size, _socket, reinterpret_cast<char *>(_data));
 
   // -------------------------------------------------------------------
   // Handle endianness issues, which only apply for numeric types.
@@ -98,11 +69,6 @@ void Receiver::recv(const ULong _size, Poco::Net::StreamSocket *_socket,
   // By default, numeric data sent over the socket is big endian
   // (also referred to as network-byte-order)!
 
-  // is_arithmetic includes numeric values and char.
-  // http://en.cppreference.com/w/cpp/types/is_arithmetic
-  static_assert(std::is_arithmetic<T>::value,
-                "Only arithmetic types allowed for recv<T>(...)!");
-
   if (!std::is_same<T, char>::value &&
       helpers::Endianness::is_little_endian()) {
     std::for_each(
@@ -18,20 +18,39 @@
 #include <algorithm>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <vector>
 
 namespace communication {
 
+/// Sends data to the client. Numbers are always sent in network byte order,
+/// so little-endian hosts still swap every numeric payload. What is saved
+/// compared to a plain socket write is the staging: payloads that need no
+/// swapping are sent from the caller's memory, the others go through a
+/// large buffer, and Arrow streams use scatter-gather I/O.
 struct Sender {
   static constexpr const char* GETML_SEP = Receiver::GETML_SEP;
   static constexpr std::uint64_t SEP_SIZE = 10;
 
+  /// Data that needs to be byte-swapped before sending is copied into a
+  /// buffer of this many bytes at most.
+  static constexpr size_t CHUNK_SIZE = 1 << 20;
+
   /// Sends data of any kind to the client
   template <class T>
   static void send(const ULong _size, const T* _data,
                    Poco::Net::StreamSocket* _socket);
 
+  /// Sends several buffers using a single system call (scatter-gather I/O),
+  /// in the order they are passed.
+  static void send_buffers(std::vector<std::string_view> _buffers,
+                           Poco::Net::StreamSocket* _socket);
+
+  /// Sends _size bytes as they are.
+  static void send_bytes(const char* _data, const ULong _size,
+                         Poco::Net::StreamSocket* _socket);
+
   /// Sends a categorical column to the client
   static void send_categorical_column(const std::vector<std::string>& _col,
                                       Poco::Net::StreamSocket* _socket);
@@ -55,75 +74,41 @@ struct Sender {
 template <class T>
 void Sender::send(const ULong _size, const T* _data,
                   Poco::Net::StreamSocket* _socket) {
-  const ULong len = 4096;
-
-  const bool is_little_endian = helpers::Endianness::is_little_endian();
-
-  ULong j = 0;
+  // is_arithmetic includes numeric values and char.
+  // http://en.cppreference.com/w/cpp/types/is_arithmetic
+  static_assert(std::is_arithmetic<T>::value,
+                "Only arithmetic types allowed for Sender::send<T>(...)!");
 
-  std::vector<char> buf(len);
+  assert_true(_size % sizeof(T) == 0);
 
   // -----------------------------------------------------------------------
-  // Send len bytes at most into the buffer and then send to socket.
-
-  while (true) {
-    // ---------------------------------------------------------------
-    // Copy to buffer
-
-    const ULong current_len = std::min(len, _size - j);
-
-    if (current_len == 0) {
-      break;
-    }
-
-    if (current_len != len) {
-      buf.resize(current_len);
-    }
-
-    for (ULong i = 0; i < current_len; ++i, ++j) {
-      buf.data()[i] = reinterpret_cast<const char*>(_data)[j];
-    }
-
-    // ---------------------------------------------------------------
-    // Handle endianness issues, which only apply for numeric types.
-    // The only non-numeric type we ever come across is char.
-    // By default, numeric data sent over the socket is big endian
-    // (also referred to as network-byte-order)!
-
-    // is_arithmetic includes numeric values and char.
-    // http://en.cppreference.com/w/cpp/types/is_arithmetic
-    static_assert(std::is_arithmetic<T>::value,
-                  "Only arithmetic types allowed for Sender::send<T>(...)!");
-
-    if (!std::is_same<T, char>::value && is_little_endian) {
-      T* buf_begin = reinterpret_cast<T*>(buf.data());
-
-      T* buf_end = buf_begin + buf.size() / sizeof(T);
-
-      std::for_each(buf_begin, buf_end, [](T& _val) {
-        helpers::Endianness::reverse_byte_order(&_val);
-      });
-    }
+  // Handle endianness issues, which only apply for numeric types.
+  // The only non-numeric type we ever come across is char.
+  // By default, numeric data sent over the socket is big endian
+  // (also referred to as network-byte-order)! If no bytes need to be
+  // swapped, the data is sent directly, without copying it.
+
+  if (std::is_same<T, char>::value ||
+      !helpers::Endianness::is_little_endian()) {
+    send_bytes(reinterpret_cast<const char*>(_data), _size, _socket);
+    return;
+  }
 
-    // ---------------------------------------------------------------
-    // Send via socket
+  const auto size = static_cast<size_t>(_size) / sizeof(T);
 
-    for (size_t num_bytes_sent = 0; num_bytes_sent < buf.size();) {
-      const auto nbytes =
-          _socket->sendBytes(buf.data() + num_bytes_sent,
-                             static_cast<int>(buf.size() - num_bytes_sent));
+  auto buf = std::vector<T>(std::min(size, CHUNK_SIZE / sizeof(T)));
 
-      if (nbytes <= 0) {
-        throw std::runtime_error("Broken pipe while attempting to send data.");
-      }
+  for (size_t begin = 0; begin < size; begin += buf.size()) {
+    const auto end = std::min(size, begin + buf.size());
 
-      num_bytes_sent += static_cast<size_t>(nbytes);
-    }
+    std::transform(_data + begin, _data + end, buf.begin(), [](T _val) {
+      helpers::Endianness::reverse_byte_order(&_val);
+      return _val;
+    });
 
-    // -------------------------------------------------
+    send_bytes(reinterpret_cast<const char*>(buf.data()),
+               (end - begin) * sizeof(T), _socket);
   }
-
-  assert_true(j == _size);
 }
 
 // ------------------------------------------------------------------------
@@ -462,7 +462,9 @@ void Column<T>::clear() {
 template <class T>
 Column<T> Column<T>::clone(const std::shared_ptr<memmap::Pool> &_pool) const {
   const auto new_pool =
-      _pool ? std::make_shared<memmap::Pool>(_pool->temp_dir()) : _pool;
+      _pool
+          ? std::make_shared<memmap::Pool>(_pool->temp_dir(), _pool->options())
+          : _pool;
 
   const auto data_ptr =
       new_pool
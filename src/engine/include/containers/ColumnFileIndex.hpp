@@ -0,0 +1,78 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef CONTAINERS_COLUMNFILEINDEX_HPP_
+#define CONTAINERS_COLUMNFILEINDEX_HPP_
+
+#include <rfl/Field.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace containers {
+
+/// A contiguous range of bytes in a column file, which is compressed as a
+/// whole, if the file is compressed.
+struct ColumnFileBlock {
+  /// The position of the block in the file.
+  rfl::Field<"offset_", size_t> offset;
+
+  /// The number of bytes the block occupies in the file.
+  rfl::Field<"size_", size_t> size;
+
+  /// The number of bytes after decompression.
+  rfl::Field<"raw_size_", size_t> raw_size;
+};
+
+/// A buffer that has been split into blocks. Uncompressed segments are
+/// stored contiguously, beginning at a page boundary.
+using ColumnFileSegment = std::vector<ColumnFileBlock>;
+
+/// Describes a single column in a column file.
+struct ColumnFileEntry {
+  /// Identifies the column within the file, like "numerical_0".
+  rfl::Field<"key_", std::string> key;
+
+  /// Either "float", "int" or "string".
+  rfl::Field<"type_", std::string> type;
+
+  rfl::Field<"name_", std::string> name;
+
+  rfl::Field<"nrows_", size_t> nrows;
+
+  rfl::Field<"subroles_", std::vector<std::string>> subroles;
+
+  rfl::Field<"unit_", std::string> unit;
+
+  /// The values of numerical columns or the dictionary codes of string
+  /// columns.
+  rfl::Field<"values_", ColumnFileSegment> values;
+
+  /// The beginning and end of every string in the dictionary (string columns
+  /// only).
+  rfl::Field<"dict_indptr_", std::optional<ColumnFileSegment>> dict_indptr;
+
+  /// The characters of all strings in the dictionary (string columns only).
+  rfl::Field<"dict_chars_", std::optional<ColumnFileSegment>> dict_chars;
+};
+
+/// The footer of a column file.
+struct ColumnFileIndex {
+  rfl::Field<"columns_", std::vector<ColumnFileEntry>> columns;
+
+  /// Either "none", "lz4" or "zstd".
+  rfl::Field<"compression_", std::string> compression;
+
+  /// The byte order of the system that has written the file.
+  rfl::Field<"little_endian_", bool> little_endian;
+};
+
+}  // namespace containers
+
+#endif  // CONTAINERS_COLUMNFILEINDEX_HPP_
@@ -0,0 +1,142 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef CONTAINERS_COLUMNFILEREADER_HPP_
+#define CONTAINERS_COLUMNFILEREADER_HPP_
+
+#include "containers/Column.hpp"
+#include "containers/ColumnFileIndex.hpp"
+#include "containers/Float.hpp"
+#include "containers/Int.hpp"
+#include "helpers/Endianness.hpp"
+#include "io/MappedFile.hpp"
+#include "memmap/Pool.hpp"
+#include "strings/String.hpp"
+
+#include <arrow/util/compression.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace containers {
+
+/// Reads the files written by the ColumnFileWriter. The file is mapped into
+/// memory, so only the index is parsed when the file is opened. The segments
+/// of a column are paged in when the column is read, copied (or decompressed)
+/// directly into the column's memory and released right after that, so
+/// reading a file never holds more than one copy of the data in memory.
+class ColumnFileReader {
+ public:
+  explicit ColumnFileReader(const std::string& _fname);
+
+  ~ColumnFileReader() = default;
+
+ public:
+  /// Whether the file contains a column signified by _key.
+  bool has(const std::string& _key) const;
+
+  /// Reads the column signified by _key. The column is stored in _pool or in
+  /// memory, if _pool is nullptr.
+  template <class T>
+  Column<T> read(const std::string& _key,
+                 const std::shared_ptr<memmap::Pool>& _pool) const;
+
+ private:
+  /// Returns the entry signified by _key, making sure it is of type _type.
+  const ColumnFileEntry& find(const std::string& _key,
+                              const std::string& _type) const;
+
+  /// Reverses the byte order of _data, if the file has been written on a
+  /// system with a different byte order.
+  template <class T>
+  void fix_byte_order(T* _data, const size_t _size) const;
+
+  /// Reads the index at the end of the file.
+  static ColumnFileIndex read_index(const io::MappedFile& _file,
+                                    const std::string& _fname);
+
+  /// Reads (and decompresses) a segment into _out, which must be able to
+  /// hold exactly _size bytes.
+  void read_segment(const ColumnFileSegment& _segment, char* _out,
+                    const size_t _size) const;
+
+  /// Reads a dictionary-encoded string column.
+  Column<strings::String> read_strings(
+      const ColumnFileEntry& _entry,
+      const std::shared_ptr<memmap::Pool>& _pool) const;
+
+  /// The number of bytes in the segment after decompression.
+  static size_t raw_size(const ColumnFileSegment& _segment);
+
+  /// Sets the name, the subroles and the unit.
+  template <class T>
+  static void set_metadata(const ColumnFileEntry& _entry, Column<T>* _col) {
+    _col->set_name(_entry.name());
+    _col->set_subroles(_entry.subroles());
+    _col->set_unit(_entry.unit());
+  }
+
+ private:
+  /// The memory-mapped file.
+  const io::MappedFile file_;
+
+  /// The name of the file, for the error messages.
+  const std::string fname_;
+
+  /// The index of the file.
+  const ColumnFileIndex index_;
+
+  /// Decompresses the blocks, nullptr if the file is not compressed.
+  const std::unique_ptr<arrow::util::Codec> codec_;
+};
+
+// ----------------------------------------------------------------------------
+
+template <class T>
+void ColumnFileReader::fix_byte_order(T* _data, const size_t _size) const {
+  if (index_.little_endian() == helpers::Endianness::is_little_endian()) {
+    return;
+  }
+
+  for (size_t i = 0; i < _size; ++i) {
+    helpers::Endianness::reverse_byte_order(_data + i);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+template <class T>
+Column<T> ColumnFileReader::read(
+    const std::string& _key, const std::shared_ptr<memmap::Pool>& _pool) const {
+  if constexpr (std::is_same<T, strings::String>()) {
+    return read_strings(find(_key, "string"), _pool);
+  } else {
+    static_assert(std::is_same<T, Float>() || std::is_same<T, Int>(),
+                  "Unsupported type.");
+
+    const auto& entry = find(_key, std::is_same<T, Float>() ? "float" : "int");
+
+    auto col = Column<T>(_pool, entry.nrows());
+
+    read_segment(entry.values(), reinterpret_cast<char*>(col.data()),
+                 col.nrows() * sizeof(T));
+
+    fix_byte_order(col.data(), col.nrows());
+
+    set_metadata(entry, &col);
+
+    return col;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace containers
+
+#endif  // CONTAINERS_COLUMNFILEREADER_HPP_
@@ -0,0 +1,135 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef CONTAINERS_COLUMNFILEWRITER_HPP_
+#define CONTAINERS_COLUMNFILEWRITER_HPP_
+
+#include "containers/Column.hpp"
+#include "containers/ColumnFileIndex.hpp"
+#include "containers/Float.hpp"
+#include "containers/Int.hpp"
+#include "strings/String.hpp"
+
+#include <arrow/util/compression.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace containers {
+
+/// Writes all columns of a DataFrame into a single file: A header is followed
+/// by one segment for every buffer, each of which begins at a page boundary,
+/// and an index describing the segments. Numerical columns are written just
+/// like they are laid out in memory, string columns are dictionary-encoded.
+/// Segments can optionally be compressed using LZ4 or ZSTD, in blocks of
+/// BLOCK_SIZE bytes.
+class ColumnFileWriter {
+ public:
+  /// Segments begin at multiples of this, so they can be mapped directly.
+  static constexpr size_t ALIGNMENT = 4096;
+
+  /// The number of uncompressed bytes that are compressed at once.
+  static constexpr size_t BLOCK_SIZE = 16 * 1024 * 1024;
+
+  /// Identifies column files. Also written at the very end of the file.
+  static constexpr const char* MAGIC = "GETMLCF1";
+
+  /// The code signifying NULL strings.
+  static constexpr std::uint32_t NULL_CODE =
+      std::numeric_limits<std::uint32_t>::max();
+
+ public:
+  /// _compression must be "none", "lz4" or "zstd".
+  ColumnFileWriter(const std::string& _fname, const std::string& _compression);
+
+  ~ColumnFileWriter() = default;
+
+ public:
+  /// Writes the index and closes the file. No columns can be written after
+  /// that.
+  void close();
+
+  /// Generates the codec for _compression, nullptr for "none".
+  static std::unique_ptr<arrow::util::Codec> make_codec(
+      const std::string& _compression);
+
+  /// Writes a column, which can be retrieved using _key.
+  template <class T>
+  void write(const std::string& _key, const Column<T>& _col);
+
+ private:
+  /// Pads the file with zeros up to the next multiple of ALIGNMENT.
+  void align();
+
+  /// Writes a buffer as a new segment.
+  ColumnFileSegment write_segment(const char* _data, const size_t _size);
+
+  /// Writes _size bytes of raw data.
+  void write_bytes(const char* _data, const size_t _size);
+
+  /// Writes a string column using dictionary encoding.
+  void write_strings(const std::string& _key,
+                     const Column<strings::String>& _col);
+
+ private:
+  /// Compresses the blocks, nullptr if the file is not compressed.
+  std::unique_ptr<arrow::util::Codec> codec_;
+
+  /// Either "none", "lz4" or "zstd".
+  const std::string compression_;
+
+  /// The columns written so far.
+  std::vector<ColumnFileEntry> entries_;
+
+  /// The name of the file, for the error messages.
+  const std::string fname_;
+
+  /// The current position in the file.
+  size_t offset_;
+
+  /// The file to write to.
+  std::ofstream output_;
+};
+
+// ----------------------------------------------------------------------------
+
+template <class T>
+void ColumnFileWriter::write(const std::string& _key, const Column<T>& _col) {
+  if constexpr (std::is_same<T, strings::String>()) {
+    write_strings(_key, _col);
+  } else {
+    static_assert(std::is_same<T, Float>() || std::is_same<T, Int>(),
+                  "Unsupported type.");
+
+    const auto values =
+        write_segment(reinterpret_cast<const char*>(_col.data()),
+                      _col.nrows() * sizeof(T));
+
+    entries_.push_back(ColumnFileEntry{
+        .key = _key,
+        .type = std::string(std::is_same<T, Float>() ? "float" : "int"),
+        .name = _col.name(),
+        .nrows = _col.nrows(),
+        .subroles = _col.subroles(),
+        .unit = _col.unit(),
+        .values = values,
+        .dict_indptr = std::nullopt,
+        .dict_chars = std::nullopt});
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace containers
+
+#endif  // CONTAINERS_COLUMNFILEWRITER_HPP_
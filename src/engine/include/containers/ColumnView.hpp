@@ -13,17 +13,18 @@
 #include "containers/ColumnViewIterator.hpp"
 #include "helpers/NullChecker.hpp"
 #include "helpers/SubroleParser.hpp"
+#include "multithreading/ThreadPool.hpp"
 #include "strings/String.hpp"
 
 #include <arrow/api.h>
-#include <range/v3/algorithm/move.hpp>
-#include <range/v3/view/cache1.hpp>
-#include <range/v3/view/iota.hpp>
-#include <range/v3/view/take_while.hpp>
-#include <range/v3/view/transform.hpp>
 
+#include <algorithm>
 #include <format>
+#include <functional>
+#include <iterator>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <ranges>
 #include <set>
@@ -37,22 +38,51 @@ namespace containers {
 
 template <class T>
 class ColumnView {
+  /// The rows selected by a boolean subselection, which are determined when
+  /// the column view is first accessed.
+  struct Selection {
+    std::once_flag once_;
+    std::vector<size_t> rows_;
+  };
+
  public:
   typedef T value_type;
   typedef bool UnknownSize;
   typedef std::variant<size_t, UnknownSize> NRowsType;
   typedef std::function<std::optional<T>(size_t)> ValueFunc;
 
+  /// Writes the values of up to _size rows starting at row _begin into _out
+  /// and returns the number of values written, which is smaller than _size
+  /// if and only if the column view ends before.
+  typedef std::function<size_t(size_t, size_t, T*)> BatchFunc;
+
   static constexpr UnknownSize NOT_KNOWABLE = true;
   static constexpr UnknownSize NROWS_INFINITE = false;
 
   static constexpr bool NROWS_MUST_MATCH = true;
 
+  /// The number of rows evaluated at once when materializing a column view.
+  static constexpr size_t BATCH_SIZE = 4096;
+
  public:
+  /// _value_func must not have any side effects, so it can be called from
+  /// several threads at once. Value functions that carry state have to be
+  /// passed to the other constructor with _is_parallel set to false.
   ColumnView(const ValueFunc& _value_func, const NRowsType& _nrows,
              const std::vector<std::string>& _subroles = {},
              const std::string& _unit = "")
-      : nrows_(_nrows),
+      : ColumnView(_value_func, make_batch_func(_value_func), _nrows, true,
+                   _subroles, _unit) {}
+
+  /// _is_parallel signifies whether batches may be evaluated concurrently
+  /// and in any order.
+  ColumnView(const ValueFunc& _value_func, const BatchFunc& _batch_func,
+             const NRowsType& _nrows, const bool _is_parallel,
+             const std::vector<std::string>& _subroles = {},
+             const std::string& _unit = "")
+      : batch_func_(_batch_func),
+        is_parallel_(_is_parallel),
+        nrows_(_nrows),
         subroles_(_subroles),
         unit_(_unit),
         value_func_(_value_func) {
@@ -93,7 +123,16 @@ class ColumnView {
   /// Constructs a column view from a value.
   static ColumnView<T> from_value(const T _value);
 
+  /// Generates a batch function that calls _value_func for every row.
+  static BatchFunc make_batch_func(const ValueFunc& _value_func);
+
  public:
+  /// Writes the values of up to _size rows starting at row _begin into _out,
+  /// see BatchFunc.
+  size_t batch(const size_t _begin, const size_t _size, T* _out) const {
+    return batch_func_(_begin, _size, _out);
+  }
+
   /// Returns the number of rows, calculates them if necessary,
   /// returns std::nullopt if and only if the number is infinite.
   std::optional<size_t> calc_nrows() const;
@@ -140,6 +179,9 @@ class ColumnView {
   /// Accessor to data
   std::optional<T> operator[](const size_t _i) const { return value_func_(_i); }
 
+  /// Trivial getter
+  bool is_parallel() const { return is_parallel_; }
+
   /// Trivial getter
   NRowsType nrows() const { return nrows_; }
 
@@ -163,6 +205,19 @@ class ColumnView {
   const std::string& unit() const { return unit_; }
 
  private:
+  /// Returns _out, if T1 is T, so the operand can be evaluated in place, and
+  /// allocates a buffer of size _size otherwise.
+  template <class T1>
+  static T1* in_place_or_buffer(const size_t _size, T* _out,
+                                std::unique_ptr<T1[]>* _buffer) {
+    if constexpr (std::is_same<T1, T>()) {
+      return _out;
+    } else {
+      *_buffer = std::make_unique<T1[]>(_size);
+      return _buffer->get();
+    }
+  }
+
   /// Calculates the expected length of a vector.
   std::pair<size_t, bool> calc_expected_length(
       const size_t _begin, const std::optional<size_t> _expected_length,
@@ -182,7 +237,22 @@ class ColumnView {
   std::shared_ptr<arrow::ChunkedArray> make_array(
       const IteratorType1 _begin, const IteratorType2 _end) const;
 
+  /// Returns the rows of _data for which _indices is true.
+  static std::vector<size_t> make_selection_vector(
+      const ColumnView<T>& _data, const ColumnView<bool>& _indices);
+
+  /// Writes the values of up to _size rows starting at row _begin into _out,
+  /// evaluating the batches in parallel, and returns the number of values
+  /// written. Requires is_parallel().
+  size_t materialize(const size_t _begin, const size_t _size, T* _out) const;
+
  private:
+  /// The function writing a batch of data points.
+  const BatchFunc batch_func_;
+
+  /// Whether batches may be evaluated concurrently and in any order.
+  const bool is_parallel_;
+
   /// Functiona returning the Number of rows (if that is knowable).
   const NRowsType nrows_;
 
@@ -209,9 +279,12 @@ std::optional<size_t> ColumnView<T>::calc_nrows() const {
     return std::nullopt;
   }
 
-  for (size_t i = 0; true; ++i) {
-    if (!value_func_(i)) {
-      return i;
+  const auto buffer = std::make_unique<T[]>(BATCH_SIZE);
+
+  for (size_t begin = 0; true; begin += BATCH_SIZE) {
+    const auto n = batch(begin, BATCH_SIZE, buffer.get());
+    if (n < BATCH_SIZE) {
+      return begin + n;
     }
   }
 
@@ -220,6 +293,24 @@ std::optional<size_t> ColumnView<T>::calc_nrows() const {
 
 // -------------------------------------------------------------------------
 
+template <class T>
+typename ColumnView<T>::BatchFunc ColumnView<T>::make_batch_func(
+    const ValueFunc& _value_func) {
+  return [_value_func](const size_t _begin, const size_t _size,
+                       T* _out) -> size_t {
+    for (size_t i = 0; i < _size; ++i) {
+      auto val = _value_func(_begin + i);
+      if (!val) {
+        return i;
+      }
+      _out[i] = std::move(*val);
+    }
+    return _size;
+  };
+}
+
+// -------------------------------------------------------------------------
+
 template <class T>
 template <class T1, class T2, class Operator>
 ColumnView<T> ColumnView<T>::from_bin_op(const ColumnView<T1>& _operand1,
@@ -257,6 +348,32 @@ ColumnView<T> ColumnView<T>::from_bin_op(const ColumnView<T1>& _operand1,
     return _op(*op1, *op2);
   };
 
+  const auto batch_func = [_operand1, _operand2, _op, check_nrows](
+                              const size_t _begin, const size_t _size,
+                              T* _out) -> size_t {
+    auto buffer1 = std::unique_ptr<T1[]>();
+    auto* out1 = in_place_or_buffer(_size, _out, &buffer1);
+
+    const auto buffer2 = std::make_unique<T2[]>(_size);
+
+    const auto n1 = _operand1.batch(_begin, _size, out1);
+    const auto n2 = _operand2.batch(_begin, _size, buffer2.get());
+
+    if (n1 < n2) {
+      check_nrows(_operand2, true);
+    } else if (n2 < n1) {
+      check_nrows(_operand1, true);
+    }
+
+    const auto n = std::min(n1, n2);
+
+    for (size_t i = 0; i < n; ++i) {
+      _out[i] = _op(out1[i], buffer2[i]);
+    }
+
+    return n;
+  };
+
   const auto check_same_size = [_operand1, _operand2]() {
     const bool nrows_do_not_match =
         std::holds_alternative<size_t>(_operand2.nrows()) &&
@@ -290,7 +407,8 @@ ColumnView<T> ColumnView<T>::from_bin_op(const ColumnView<T1>& _operand1,
            std::get<UnknownSize>(_operand2.nrows());
   };
 
-  return ColumnView<T>(value_func, nrows_func());
+  return ColumnView<T>(value_func, batch_func, nrows_func(),
+                       _operand1.is_parallel() && _operand2.is_parallel());
 }
 
 // -------------------------------------------------------------------------
@@ -317,79 +435,77 @@ ColumnView<T> ColumnView<T>::from_boolean_subselection(
         std::to_string(std::get<size_t>(_indices.nrows())) + ".");
   }
 
-  const auto find_next =
-      [_indices, _data](size_t _begin, size_t _skip) -> std::optional<size_t> {
-    size_t ix = _begin;
+  // The selected rows are determined once, when the column view is first
+  // accessed, so the predicate is evaluated in batches and the rows can be
+  // accessed in any order.
+  const auto selection = std::make_shared<Selection>();
+
+  const auto rows = [_data, _indices,
+                     selection]() -> const std::vector<size_t>& {
+    std::call_once(selection->once_, [&_data, &_indices, &selection]() {
+      selection->rows_ = make_selection_vector(_data, _indices);
+    });
+    return selection->rows_;
+  };
 
-    size_t count = 0;
+  const auto value_func = [_data, rows](const size_t _i) -> std::optional<T> {
+    const auto& selected = rows();
 
-    while (true) {
-      const auto val = _indices[ix];
+    if (_i >= selected.size()) {
+      return std::nullopt;
+    }
 
-      if (!val) {
-        if (_data[ix]) {
-          throw std::runtime_error(
-              "Number of rows do not match on the "
-              "boolean subselection. The data is longer "
-              "than the indices.");
-        }
-
-        return std::nullopt;
-      }
+    return _data[selected[_i]];
+  };
 
-      if (!_data[ix]) {
-        if (!_indices.is_infinite()) {
-          throw std::runtime_error(
-              "Number of rows do not match on the "
-              "boolean subselection. The indices are "
-              "longer than the data. This may only be "
-              "the case if the indices are infinite.");
-        }
+  const auto batch_func = [_data, rows](const size_t _begin,
+                                        const size_t _size,
+                                        T* _out) -> size_t {
+    const auto& selected = rows();
 
-        return std::nullopt;
-      }
+    if (_begin >= selected.size()) {
+      return 0;
+    }
+
+    const auto n = std::min(_size, selected.size() - _begin);
+
+    const auto first = selected[_begin];
+
+    const auto range = selected[_begin + n - 1] - first + 1;
+
+    // When the selected rows are dense, it is cheaper to evaluate all rows in
+    // between as one batch and pick the selected ones.
+    if (range <= 4 * n) {
+      const auto buffer = std::make_unique<T[]>(range);
+
+      const auto num_evaluated = _data.batch(first, range, buffer.get());
 
-      if (*val) {
-        if (++count > _skip) {
-          return ix;
-        }
+      assert_true(num_evaluated == range);
+
+      for (size_t i = 0; i < n; ++i) {
+        _out[i] = std::move(buffer[selected[_begin + i] - first]);
       }
 
-      ++ix;
+      return n;
     }
 
-    assert_true(false);
-
-    return 0;
-  };
+    for (size_t i = 0; i < n; ++i) {
+      auto val = _data[selected[_begin + i]];
+      assert_true(val);
+      _out[i] = std::move(*val);
+    }
 
-  const auto value_func =
-      [_data, _indices, index = 0uz, next = 0uz,
-       find_next](const std::size_t _i) mutable -> std::optional<T> {
-    return ([&_i, &next, &index, &find_next]() -> std::optional<std::size_t> {
-             if (_i == next) [[likely]] {
-               return find_next(index, 0);
-             }
-             if (_i < next) {
-               return find_next(0, _i);
-             }
-             // _i > next
-             return find_next(index, _i - next);
-           })()
-        .and_then([&_data, &next, &_i,
-                   &index](std::size_t const& _index) -> std::optional<T> {
-          index = _index;
-          next = _i + 1;
-          return _data[index++];
-        });
+    return n;
   };
 
-  return ColumnView<T>(value_func, NOT_KNOWABLE, _data.subroles(),
-                       _data.unit());
+  return ColumnView<T>(value_func, batch_func, NOT_KNOWABLE,
+                       _data.is_parallel(), _data.subroles(), _data.unit());
 }
 
 // -------------------------------------------------------------------------
 
+// -------------------------------------------------------------------------
+
 template <class T>
 ColumnView<T> ColumnView<T>::from_numerical_subselection(
     const ColumnView<T>& _data, const ColumnView<Float>& _indices) {
@@ -409,8 +525,9 @@ ColumnView<T> ColumnView<T>::from_numerical_subselection(
         });
   };
 
-  return ColumnView<T>(value_func, NOT_KNOWABLE, _data.subroles(),
-                       _data.unit());
+  return ColumnView<T>(value_func, make_batch_func(value_func), NOT_KNOWABLE,
+                       _data.is_parallel() && _indices.is_parallel(),
+                       _data.subroles(), _data.unit());
 }
 
 // -------------------------------------------------------------------------
@@ -425,7 +542,31 @@ ColumnView<T> ColumnView<T>::from_column(const Column<T>& _col) {
     return _col[_i];
   };
 
-  return ColumnView<T>(value_func, _col.nrows(), _col.subroles(), _col.unit());
+  const auto batch_func = [_col](const size_t _begin, const size_t _size,
+                                 T* _out) -> size_t {
+    const auto nrows = _col.nrows();
+
+    if (_begin >= nrows) {
+      return 0;
+    }
+
+    const auto n = std::min(_size, nrows - _begin);
+
+    if constexpr (std::is_same<typename Column<T>::const_iterator,
+                               const T*>()) {
+      const auto data = _col.data() + _begin;
+      std::copy(data, data + n, _out);
+    } else {
+      for (size_t i = 0; i < n; ++i) {
+        _out[i] = _col[_begin + i];
+      }
+    }
+
+    return n;
+  };
+
+  return ColumnView<T>(value_func, batch_func, _col.nrows(), true,
+                       _col.subroles(), _col.unit());
 }
 
 // -------------------------------------------------------------------------
@@ -444,7 +585,23 @@ ColumnView<T> ColumnView<T>::from_un_op(const ColumnView<T1>& _operand,
     return _op(*op1);
   };
 
-  return ColumnView<T>(value_func, _operand.nrows());
+  const auto batch_func = [_operand, _op](const size_t _begin,
+                                          const size_t _size,
+                                          T* _out) -> size_t {
+    auto buffer = std::unique_ptr<T1[]>();
+    auto* out1 = in_place_or_buffer(_size, _out, &buffer);
+
+    const auto n = _operand.batch(_begin, _size, out1);
+
+    for (size_t i = 0; i < n; ++i) {
+      _out[i] = _op(out1[i]);
+    }
+
+    return n;
+  };
+
+  return ColumnView<T>(value_func, batch_func, _operand.nrows(),
+                       _operand.is_parallel());
 }
 
 // -------------------------------------------------------------------------
@@ -496,6 +653,42 @@ ColumnView<T> ColumnView<T>::from_tern_op(const ColumnView<T1>& _operand1,
     return _op(*op1, *op2, *op3);
   };
 
+  const auto batch_func = [_operand1, _operand2, _operand3, _op, check_nrows](
+                              const size_t _begin, const size_t _size,
+                              T* _out) -> size_t {
+    auto buffer1 = std::unique_ptr<T1[]>();
+    auto* out1 = in_place_or_buffer(_size, _out, &buffer1);
+
+    const auto buffer2 = std::make_unique<T2[]>(_size);
+    const auto buffer3 = std::make_unique<T3[]>(_size);
+
+    const auto n1 = _operand1.batch(_begin, _size, out1);
+    const auto n2 = _operand2.batch(_begin, _size, buffer2.get());
+    const auto n3 = _operand3.batch(_begin, _size, buffer3.get());
+
+    const auto n = std::min({n1, n2, n3});
+
+    // Just like in the value function, only infinite operands may be longer
+    // than the others.
+    if (n1 > n) {
+      check_nrows(_operand1, true);
+    }
+
+    if (n2 > n) {
+      check_nrows(_operand2, true);
+    }
+
+    if (n3 > n) {
+      check_nrows(_operand3, true);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+      _out[i] = _op(out1[i], buffer2[i], buffer3[i]);
+    }
+
+    return n;
+  };
+
   const auto check_same_size = [](const auto& _operand1,
                                   const auto& _operand2) {
     const bool nrows_do_not_match =
@@ -533,7 +726,9 @@ ColumnView<T> ColumnView<T>::from_tern_op(const ColumnView<T1>& _operand1,
            std::get<UnknownSize>(_operand3.nrows());
   };
 
-  return ColumnView<T>(value_func, nrows_func());
+  return ColumnView<T>(value_func, batch_func, nrows_func(),
+                       _operand1.is_parallel() && _operand2.is_parallel() &&
+                           _operand3.is_parallel());
 }
 
 // -------------------------------------------------------------------------
@@ -544,7 +739,13 @@ ColumnView<T> ColumnView<T>::from_value(const T _value) {
     return _value;
   };
 
-  return ColumnView<T>(value_func, NROWS_INFINITE);
+  const auto batch_func = [_value](const size_t, const size_t _size,
+                                   T* _out) -> size_t {
+    std::fill(_out, _out + _size, _value);
+    return _size;
+  };
+
+  return ColumnView<T>(value_func, batch_func, NROWS_INFINITE, true);
 }
 
 // -------------------------------------------------------------------------
@@ -583,12 +784,14 @@ std::shared_ptr<arrow::ChunkedArray> ColumnView<T>::to_array(
 
   check_expected_length(expected_length, _nrows_must_match, !_expected_length);
 
+  const auto data_ptr = to_vector(_begin, _expected_length, _nrows_must_match);
+
   if constexpr (std::is_same<T, strings::String>()) {
     const auto to_str = [](const strings::String& _str) { return _str.str(); };
-    auto range = *this | std::views::transform(to_str);
+    auto range = *data_ptr | std::views::transform(to_str);
     return make_array(range.begin(), range.end());
   } else {
-    return make_array(begin(), end());
+    return make_array(data_ptr->begin(), data_ptr->end());
   }
 }
 
@@ -691,21 +894,38 @@ std::shared_ptr<std::vector<T>> ColumnView<T>::to_vector(
 
   check_expected_length(expected_length, _nrows_must_match, !_expected_length);
 
-  auto values_view = ranges::views::iota(_begin, _begin + expected_length) |
-                     ranges::views::transform(
-                         [this](auto i) { return this->value_func_(i); }) |
-                     ranges::views::cache1 |
-                     ranges::views::take_while([](auto const& optional) {
-                       return optional.has_value();
-                     }) |
-                     ranges::views::transform(
-                         [](auto const& optional) { return optional.value(); });
-
   auto data_ptr = std::make_shared<std::vector<T>>();
-  if (length_is_known) {
-    data_ptr->reserve(expected_length);
+
+  constexpr auto unknown_length = std::numeric_limits<size_t>::max();
+
+  if (is_parallel_ && expected_length != unknown_length) {
+    if constexpr (std::is_same<T, bool>()) {
+      // std::vector<bool> does not expose its data.
+      const auto buffer = std::make_unique<bool[]>(expected_length);
+      const auto n = materialize(_begin, expected_length, buffer.get());
+      data_ptr->assign(buffer.get(), buffer.get() + n);
+    } else {
+      data_ptr->resize(expected_length);
+      const auto n = materialize(_begin, expected_length, data_ptr->data());
+      data_ptr->resize(n);
+    }
+  } else {
+    if (length_is_known) {
+      data_ptr->reserve(expected_length);
+    }
+
+    const auto buffer = std::make_unique<T[]>(BATCH_SIZE);
+
+    for (size_t begin = 0; begin < expected_length; begin += BATCH_SIZE) {
+      const auto size = std::min(BATCH_SIZE, expected_length - begin);
+      const auto n = batch(_begin + begin, size, buffer.get());
+      data_ptr->insert(data_ptr->end(), std::make_move_iterator(buffer.get()),
+                       std::make_move_iterator(buffer.get() + n));
+      if (n < size) {
+        break;
+      }
+    }
   }
-  ranges::move(values_view, std::back_inserter(*data_ptr));
 
   if ((length_is_known || _nrows_must_match) &&
       data_ptr->size() != expected_length) {
@@ -720,6 +940,81 @@ std::shared_ptr<std::vector<T>> ColumnView<T>::to_vector(
 
 // -------------------------------------------------------------------------
 
+template <class T>
+std::vector<size_t> ColumnView<T>::make_selection_vector(
+    const ColumnView<T>& _data, const ColumnView<bool>& _indices) {
+  const auto nrows = _data.calc_nrows();
+
+  assert_true(nrows);
+
+  const auto mask = _indices.is_infinite()
+                        ? _indices.to_vector(0, *nrows, false)
+                        : _indices.to_vector(0, std::nullopt, false);
+
+  if (mask->size() < *nrows) {
+    throw std::runtime_error(
+        "Number of rows do not match on the "
+        "boolean subselection. The data is longer "
+        "than the indices.");
+  }
+
+  if (mask->size() > *nrows) {
+    throw std::runtime_error(
+        "Number of rows do not match on the "
+        "boolean subselection. The indices are "
+        "longer than the data. This may only be "
+        "the case if the indices are infinite.");
+  }
+
+  auto rows = std::vector<size_t>();
+
+  for (size_t i = 0; i < mask->size(); ++i) {
+    if ((*mask)[i]) {
+      rows.push_back(i);
+    }
+  }
+
+  return rows;
+}
+
+// -------------------------------------------------------------------------
+
+template <class T>
+size_t ColumnView<T>::materialize(const size_t _begin, const size_t _size,
+                                  T* _out) const {
+  assert_true(is_parallel_);
+
+  const auto num_batches = (_size + BATCH_SIZE - 1) / BATCH_SIZE;
+
+  const auto batch_size = [_size](const size_t _b) {
+    return std::min(BATCH_SIZE, _size - _b * BATCH_SIZE);
+  };
+
+  auto sizes = std::vector<size_t>(num_batches);
+
+  const auto evaluate = [this, _begin, _out, &batch_size,
+                         &sizes](const size_t _b) {
+    sizes[_b] = batch(_begin + _b * BATCH_SIZE, batch_size(_b),
+                      _out + _b * BATCH_SIZE);
+  };
+
+  multithreading::ThreadPool::get().parallel_for(num_batches, evaluate);
+
+  // The column view ends at the first batch that is not complete.
+  size_t n = 0;
+
+  for (size_t b = 0; b < num_batches; ++b) {
+    n += sizes[b];
+    if (sizes[b] < batch_size(b)) {
+      break;
+    }
+  }
+
+  return n;
+}
+
+// -------------------------------------------------------------------------
+
 template <class T>
 std::shared_ptr<arrow::ChunkedArray> ColumnView<T>::unique() const {
   if (is_infinite()) {
@@ -766,7 +1061,13 @@ ColumnView<T> ColumnView<T>::with_subroles(
     return deep_copy[_i];
   };
 
-  return ColumnView<T>(value_func, nrows(), _subroles, unit());
+  const auto batch_func = [deep_copy](const size_t _begin, const size_t _size,
+                                      T* _out) -> size_t {
+    return deep_copy.batch(_begin, _size, _out);
+  };
+
+  return ColumnView<T>(value_func, batch_func, nrows(), is_parallel(),
+                       _subroles, unit());
 }
 
 // -------------------------------------------------------------------------
@@ -779,7 +1080,13 @@ ColumnView<T> ColumnView<T>::with_unit(const std::string& _unit) const {
     return deep_copy[_i];
   };
 
-  return ColumnView<T>(value_func, nrows(), subroles(), _unit);
+  const auto batch_func = [deep_copy](const size_t _begin, const size_t _size,
+                                      T* _out) -> size_t {
+    return deep_copy.batch(_begin, _size, _out);
+  };
+
+  return ColumnView<T>(value_func, batch_func, nrows(), is_parallel(),
+                       subroles(), _unit);
 }
 
 // -------------------------------------------------------------------------
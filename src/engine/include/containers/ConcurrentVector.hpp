@@ -0,0 +1,98 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef CONTAINERS_CONCURRENTVECTOR_HPP_
+#define CONTAINERS_CONCURRENTVECTOR_HPP_
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <utility>
+
+namespace containers {
+
+/// A vector whose elements are stored in segments of geometrically growing
+/// size, which are never moved once they have been allocated. Different
+/// threads can therefore set different elements and read elements that have
+/// been published to them without any locks.
+template <class T>
+class ConcurrentVector {
+  /// The size of the first segment, segment k contains FIRST_SEGMENT_SIZE *
+  /// 2^k elements.
+  static constexpr size_t FIRST_SEGMENT_SIZE = 1024;
+
+  /// Enough segments to hold more elements than can be addressed.
+  static constexpr size_t MAX_SEGMENTS = 48;
+
+ public:
+  ConcurrentVector() = default;
+
+  ConcurrentVector(const ConcurrentVector<T>& _other) = delete;
+
+  ~ConcurrentVector() { clear(); }
+
+ public:
+  /// Deletes all elements. Must not be called concurrently with anything
+  /// else.
+  void clear() {
+    for (auto& segment : segments_) {
+      delete[] segment.exchange(nullptr);
+    }
+  }
+
+  /// Copy assignment operator.
+  ConcurrentVector<T>& operator=(const ConcurrentVector<T>& _other) = delete;
+
+  /// Returns element _i, which must have been set before.
+  const T& operator[](const size_t _i) const {
+    const auto [segment, offset] = locate(_i);
+    return segments_[segment].load(std::memory_order_acquire)[offset];
+  }
+
+  /// Sets element _i, allocating its segment, if necessary.
+  void set(const size_t _i, T _val) {
+    const auto [segment, offset] = locate(_i);
+    get_or_allocate(segment)[offset] = std::move(_val);
+  }
+
+ private:
+  /// Returns segment _k, allocating it, if it does not exist yet.
+  T* get_or_allocate(const size_t _k) {
+    auto* segment = segments_[_k].load(std::memory_order_acquire);
+
+    if (segment) {
+      return segment;
+    }
+
+    auto* fresh = new T[FIRST_SEGMENT_SIZE << _k];
+
+    if (segments_[_k].compare_exchange_strong(segment, fresh,
+                                              std::memory_order_acq_rel)) {
+      return fresh;
+    }
+
+    delete[] fresh;
+
+    return segment;
+  }
+
+  /// Returns the segment and the offset within the segment of element _i.
+  static std::pair<size_t, size_t> locate(const size_t _i) {
+    const auto k =
+        static_cast<size_t>(std::bit_width(_i / FIRST_SEGMENT_SIZE + 1)) - 1;
+    return std::make_pair(k, _i - FIRST_SEGMENT_SIZE * ((size_t(1) << k) - 1));
+  }
+
+ private:
+  /// The segments, nullptr if they have not been allocated yet.
+  std::array<std::atomic<T*>, MAX_SEGMENTS> segments_ = {};
+};
+
+}  // namespace containers
+
+#endif  // CONTAINERS_CONCURRENTVECTOR_HPP_
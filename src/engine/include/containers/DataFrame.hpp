@@ -12,6 +12,8 @@
 #include "commands/DataFrameOrView.hpp"
 #include "commands/Fingerprint.hpp"
 #include "containers/Column.hpp"
+#include "containers/ColumnFileReader.hpp"
+#include "containers/ColumnFileWriter.hpp"
 #include "containers/DataFrameContent.hpp"
 #include "containers/DataFrameIndex.hpp"
 #include "containers/Encoding.hpp"
@@ -22,6 +24,7 @@
 #include "database/Connector.hpp"
 #include "helpers/DataFrameParams.hpp"
 #include "helpers/Macros.hpp"
+#include "io/ParallelCSVReader.hpp"
 #include "transpilation/HumanReadableSQLGenerator.hpp"
 
 #include <Poco/DateTimeFormat.h>
@@ -47,6 +50,9 @@ class DataFrame {
   static constexpr const char *ROLE_UNUSED_FLOAT = "unused_float";
   static constexpr const char *ROLE_UNUSED_STRING = "unused_string";
 
+  /// The file containing all columns of a saved DataFrame.
+  static constexpr const char *COLUMN_FILE = "columns.bin";
+
   using ViewOp = typename commands::DataFrameOrView::ViewOp;
 
  public:
@@ -79,8 +85,12 @@ class DataFrame {
   /// Creates a deep copy of the DataFrame
   DataFrame clone(const std::string _name) const;
 
-  /// Builds indices_, which serve the role of
-  /// an index over the join keys
+  /// Builds all outdated indices in parallel, one index per thread.
+  void build_indices() const;
+
+  /// Marks indices_, which serve the role of an index over the join keys, as
+  /// outdated. They are brought up to date lazily, when they are used for the
+  /// next time, and only the rows appended since then are indexed.
   void create_indices();
 
   /// Returns the fingerprint of the data frame (necessary to build the
@@ -154,9 +164,11 @@ class DataFrame {
   /// Removes a column.
   bool remove_column(const std::string &_name);
 
-  /// Saves the data on the engine
+  /// Saves the data on the engine. All columns are written into a single
+  /// column file, _compression can be "none", "lz4" or "zstd".
   void save(const std::string &_temp_dir, const std::string &_path,
-            const std::string &_name) const;
+            const std::string &_name,
+            const std::string &_compression = "none") const;
 
   /// Sorts all columns by the designated key.
   void sort_by_key(const std::vector<size_t> &_key);
@@ -415,6 +427,7 @@ class DataFrame {
   /// Returns the maps underlying the indices.
   const std::vector<std::shared_ptr<typename DataFrameIndex::MapType>> maps()
       const {
+    build_indices();
     std::vector<std::shared_ptr<typename DataFrameIndex::MapType>> maps;
     for (const auto &ix : indices_) maps.push_back(ix.map());
     return maps;
@@ -692,11 +705,11 @@ class DataFrame {
                  const std::vector<std::string> &_names,
                  const std::vector<std::string> &_time_formats);
 
-  /// Builds a dataframe from a reader.
-  void from_reader(const std::shared_ptr<io::Reader> &_reader,
-                   const std::string &_fname, const size_t _skip,
-                   const std::vector<std::string> &_time_formats,
-                   const Schema &_schema);
+  /// Builds a dataframe from a CSV file, parsing its chunks in parallel.
+  void from_csv(const io::ParallelCSVReader &_reader,
+                const std::string &_fname, const size_t _skip,
+                const std::vector<std::string> &_time_formats,
+                const Schema &_schema);
 
   /// Returns the colnames, roles and units of columns.
   std::tuple<std::vector<std::string>, std::vector<std::string>,
@@ -707,11 +720,22 @@ class DataFrame {
   std::vector<std::vector<std::string>> get_rows(
       const std::int32_t _max_rows) const;
 
-  /// Loads columns.
+  /// Loads all columns from _source, which is either a ColumnFileReader or
+  /// the directory the DataFrame has been saved in.
+  template <class SourceType>
+  void load_all_columns(const SourceType &_source);
+
+  /// Loads columns saved one file per column, which is how projects were
+  /// saved before the column file was introduced.
   template <class T>
   std::vector<Column<T>> load_columns(const std::string &_path,
                                       const std::string &_prefix) const;
 
+  /// Loads columns from a column file.
+  template <class T>
+  std::vector<Column<T>> load_columns(const ColumnFileReader &_reader,
+                                      const std::string &_prefix) const;
+
   /// Loads a textfile from disc.
   std::optional<std::string> load_textfile(const std::string &_path,
                                            const std::string &_fname) const;
@@ -726,11 +750,11 @@ class DataFrame {
   bool rm_col(const std::string &_name, std::vector<Column<T>> *_columns,
               std::vector<DataFrameIndex> *_indices = nullptr) const;
 
-  /// Saves all matrices.
+  /// Writes all columns into the column file.
   template <class T>
-  void save_matrices(const std::vector<Column<T>> &_matrices,
-                     const std::string &_path,
-                     const std::string &_prefix) const;
+  void save_columns(const std::vector<Column<T>> &_columns,
+                    const std::string &_prefix,
+                    ColumnFileWriter *_writer) const;
 
   ///  Saves a string to a textfile.
   void save_text(const std::string &_tpath, const std::string &_fname,
@@ -748,7 +772,8 @@ class DataFrame {
 
   /// Generates a new pool
   std::shared_ptr<memmap::Pool> make_pool() const {
-    return pool_ ? std::make_shared<memmap::Pool>(pool_->temp_dir())
+    return pool_ ? std::make_shared<memmap::Pool>(pool_->temp_dir(),
+                                                  pool_->options())
                  : std::shared_ptr<memmap::Pool>();
   }
 
@@ -859,6 +884,27 @@ ULong DataFrame::calc_nbytes(const std::vector<Column<T>> &_columns) const {
 
 // ----------------------------------------------------------------------------
 
+template <class SourceType>
+void DataFrame::load_all_columns(const SourceType &_source) {
+  categoricals_ = load_columns<Int>(_source, "categorical_");
+
+  join_keys_ = load_columns<Int>(_source, "join_key_");
+
+  numericals_ = load_columns<Float>(_source, "numerical_");
+
+  targets_ = load_columns<Float>(_source, "target_");
+
+  text_ = load_columns<strings::String>(_source, "text_");
+
+  time_stamps_ = load_columns<Float>(_source, "time_stamp_");
+
+  unused_floats_ = load_columns<Float>(_source, "unused_float_");
+
+  unused_strings_ = load_columns<strings::String>(_source, "unused_string_");
+}
+
+// ----------------------------------------------------------------------------
+
 template <class T>
 std::vector<Column<T>> DataFrame::load_columns(
     const std::string &_path, const std::string &_prefix) const {
@@ -883,6 +929,20 @@ std::vector<Column<T>> DataFrame::load_columns(
 
 // ----------------------------------------------------------------------------
 
+template <class T>
+std::vector<Column<T>> DataFrame::load_columns(
+    const ColumnFileReader &_reader, const std::string &_prefix) const {
+  std::vector<Column<T>> columns;
+
+  for (size_t i = 0; _reader.has(_prefix + std::to_string(i)); ++i) {
+    columns.push_back(_reader.read<T>(_prefix + std::to_string(i), pool_));
+  }
+
+  return columns;
+}
+
+// ----------------------------------------------------------------------------
+
 template <class T>
 std::vector<std::shared_ptr<std::vector<T>>> DataFrame::make_vectors(
     const size_t _size) const {
@@ -925,11 +985,11 @@ bool DataFrame::rm_col(const std::string &_name,
 // ----------------------------------------------------------------------------
 
 template <class T>
-void DataFrame::save_matrices(const std::vector<Column<T>> &_matrices,
-                              const std::string &_path,
-                              const std::string &_prefix) const {
-  for (size_t i = 0; i < _matrices.size(); ++i) {
-    _matrices.at(i).save(_path + _prefix + std::to_string(i));
+void DataFrame::save_columns(const std::vector<Column<T>> &_columns,
+                             const std::string &_prefix,
+                             ColumnFileWriter *_writer) const {
+  for (size_t i = 0; i < _columns.size(); ++i) {
+    _writer->write(_prefix + std::to_string(i), _columns.at(i));
   }
 }
 
@@ -969,6 +1029,8 @@ DataFrameType DataFrame::to_immutable(const std::optional<Schema> &_schema,
                          std::views::transform(get_join_key) |
                          std::ranges::to<std::vector>();
 
+  build_indices();
+
   const auto get_index = [this](const std::string &_name) {
     return index(_name).map();
   };
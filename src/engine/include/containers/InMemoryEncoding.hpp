@@ -8,29 +8,87 @@
 #ifndef CONTAINERS_INMEMORYENCODING_HPP_
 #define CONTAINERS_INMEMORYENCODING_HPP_
 
+#include "containers/ConcurrentVector.hpp"
 #include "containers/Int.hpp"
 #include "strings/String.hpp"
-#include "strings/StringHasher.hpp"
 
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <type_traits>
-#include <unordered_map>
 #include <vector>
 
 namespace containers {
 
+/// Maps strings to integers and vice versa. The encoding can be updated by
+/// many threads at once, which always get the same integer for the same
+/// string: The strings are distributed over NUM_SHARDS shards by their
+/// hashes, each of which contains an open-addressing hash table. Writers lock
+/// the shard they insert into, readers never lock. Tables that have been
+/// outgrown are kept alive until the encoding is cleared, because readers
+/// might still be probing them.
+///
+/// clear(), operator=(...) and size() are not meant to be used while other
+/// threads are inserting strings.
 class InMemoryEncoding {
+  /// The number of shards, must be a power of two.
+  static constexpr size_t NUM_SHARDS = 64;
+
+  /// The number of bits the hash is shifted to find the shard.
+  static constexpr size_t SHARD_SHIFT =
+      8 * sizeof(size_t) - std::countr_zero(NUM_SHARDS);
+
+  /// Signifies an empty slot in a hash table. All other slots contain the
+  /// position of the string in strings_ plus one.
+  static constexpr size_t EMPTY_SLOT = 0;
+
+  /// An open-addressing hash table using linear probing.
+  struct Table {
+    explicit Table(const size_t _capacity)
+        : capacity_(_capacity),
+          slots_(std::make_unique<std::atomic<size_t>[]>(_capacity)) {}
+
+    /// The number of slots, always a power of two.
+    const size_t capacity_;
+
+    /// The slots, initialized to EMPTY_SLOT.
+    const std::unique_ptr<std::atomic<size_t>[]> slots_;
+  };
+
+  /// A part of the encoding containing all strings with the same leading
+  /// hash bits.
+  struct Shard {
+    /// Serializes the writers.
+    std::mutex mutex_;
+
+    /// The number of strings contained in the shard.
+    size_t num_strings_ = 0;
+
+    /// The table currently used, nullptr if the shard is empty.
+    std::atomic<Table*> table_ = nullptr;
+
+    /// Owns the current table and all tables it has replaced.
+    std::vector<std::unique_ptr<Table>> tables_;
+  };
+
  public:
   explicit InMemoryEncoding(
       const std::shared_ptr<const InMemoryEncoding> _subencoding =
           std::shared_ptr<const InMemoryEncoding>());
 
+  InMemoryEncoding(const InMemoryEncoding& _other) = delete;
+
   ~InMemoryEncoding() = default;
 
   // -------------------------------
 
-  /// Appends all elements of a different encoding.
+  /// Appends all elements of a different encoding. _other may be updated
+  /// concurrently, in which case strings that are still being inserted might
+  /// be skipped.
   void append(const InMemoryEncoding& _other,
               bool _include_subencoding = false);
 
@@ -40,10 +98,7 @@ class InMemoryEncoding {
   // -------------------------------
 
   /// Deletes all entries
-  void clear() {
-    map_ = std::unordered_map<strings::String, Int, strings::StringHasher>();
-    *vector_ = std::vector<strings::String>();
-  }
+  void clear();
 
   /// Returns the integer mapped to a string or the string mapped to an
   /// integer, updates the mapping, if necessary.
@@ -88,13 +143,25 @@ class InMemoryEncoding {
   }
 
   /// Number of encoded elements
-  size_t size() const { return subsize_ + vector_->size(); }
+  size_t size() const { return subsize_ + num_strings_.load(); }
 
   // -------------------------------
 
  private:
-  /// Adds an integer to map_ and vector_, assuming it is not already included
-  Int insert(const strings::String& _val);
+  /// Looks up _val in _shard without locking, returns -1 if it cannot be
+  /// found.
+  Int find(const Shard& _shard, const strings::String& _val) const;
+
+  /// Grows the table of _shard, so that it can hold one more string.
+  void grow(Shard* _shard);
+
+  /// Adds _val to _shard and strings_, unless another thread has been faster.
+  Int insert(Shard* _shard, const strings::String& _val);
+
+  /// Returns the index of the shard _val belongs to.
+  static size_t shard_ix(const strings::String& _val) {
+    return _val.hash() >> SHARD_SHIFT;
+  }
 
   /// Returns the string mapped to an integer.
   strings::String int_to_string(const Int _i) const;
@@ -108,9 +175,6 @@ class InMemoryEncoding {
   // -------------------------------
 
  private:
-  /// For fast lookup
-  std::unordered_map<strings::String, Int, strings::StringHasher> map_;
-
   /// The null value (needed because strings are returned by reference).
   const strings::String null_value_;
 
@@ -119,11 +183,18 @@ class InMemoryEncoding {
   /// being edited, such as when we process requests in parallel.
   std::shared_ptr<const InMemoryEncoding> subencoding_;
 
-  // The size of the subencoding at the time this encoding was created.
-  const size_t subsize_;
+  /// The number of strings contained in this encoding, excluding the
+  /// subencoding.
+  std::atomic<size_t> num_strings_;
+
+  /// For fast lookup
+  std::array<Shard, NUM_SHARDS> shards_;
 
   /// Maps integers to strings
-  const std::shared_ptr<std::vector<strings::String>> vector_;
+  ConcurrentVector<strings::String> strings_;
+
+  // The size of the subencoding at the time this encoding was created.
+  const size_t subsize_;
 };
 
 }  // namespace containers
@@ -11,85 +11,146 @@
 #include "containers/Column.hpp"
 #include "containers/Float.hpp"
 #include "containers/Int.hpp"
+#include "helpers/CSRIndex.hpp"
 #include "helpers/NullChecker.hpp"
-#include "memmap/Index.hpp"
 
+#include <atomic>
 #include <cmath>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <optional>
+#include <utility>
 #include <variant>
+#include <vector>
 
 namespace containers {
 
 template <class T, class Hash = std::hash<T>>
 class Index {
-  using InMemoryType = std::unordered_map<T, std::vector<size_t>, Hash>;
-  using MemoryMappedType = memmap::Index<T>;
+  using InMemoryType = helpers::CSRIndex<T, Hash, false>;
+  using MemoryMappedType = helpers::CSRIndex<T, Hash, true>;
+
+  /// The state is shared by all copies of an index, just like the map, so
+  /// that an outdated index is brought up to date exactly once.
+  struct State {
+    /// Stores the first row number for which we do not have an index.
+    size_t begin_ = 0;
+
+    /// Whether pending_ is set, so we can check without locking.
+    std::atomic<bool> is_pending_ = false;
+
+    /// Protects begin_, pending_ and the map during updates.
+    std::mutex mtx_;
+
+    /// The key the index needs to be brought up to date with.
+    std::optional<Column<T>> pending_;
+  };
 
  public:
   using MapType = std::variant<InMemoryType, MemoryMappedType>;
 
  public:
   Index(const std::shared_ptr<memmap::Pool>& _pool)
-      : begin_(0),
-        map_(_pool ? std::make_shared<MapType>(MemoryMappedType(_pool))
-                   : std::make_shared<MapType>(InMemoryType())) {}
+      : map_(_pool ? std::make_shared<MapType>(MemoryMappedType(_pool))
+                   : std::make_shared<MapType>(InMemoryType(nullptr))),
+        state_(std::make_shared<State>()) {}
 
   ~Index() = default;
 
   // -------------------------------
 
-  /// Recalculates the index.
+  /// Brings the index up to date, if update(...) has been called since it
+  /// was last used. Called by find(...) and map(), but can also be called
+  /// directly to build several indices in parallel.
+  void build() const;
+
+  /// Recalculates the index right away.
   void calculate(const Column<T>& _key);
 
   /// Returns a pointer to the beginning and end of the rownums, or two
   /// nullptrs, if the key is not found.
   std::pair<const size_t*, const size_t*> find(const T _key) const;
 
+  /// Marks the index as outdated. It is recalculated using _key when it is
+  /// used for the next time.
+  void update(const Column<T>& _key);
+
   // -------------------------------
 
   /// Returns a const copy to the underlying map.
-  std::shared_ptr<MapType> map() const { return map_; }
+  std::shared_ptr<MapType> map() const {
+    build();
+    return map_;
+  }
 
   // -------------------------------
 
  private:
+  /// Calculates the index, the caller must hold state_->mtx_.
+  void calculate_impl(const Column<T>& _key) const;
+
   /// Calculates the index, once the map type has been evaluated.
   template <class KnownMapType>
-  void calculate_known_type(const Column<T>& _key, KnownMapType* _map);
+  void calculate_known_type(const Column<T>& _key, KnownMapType* _map) const;
 
   // Determines whether this is a NULL value
   bool is_null(const T& _val) const;
 
-  /// Insert a key-rownum-pair into _map;
-  void insert(const T _key, const size_t _rownum, InMemoryType* _map) const;
-
   // -------------------------------
 
  private:
-  /// Insert a key-rownum-pair into _map;
-  void insert(const T _key, const size_t _rownum,
-              MemoryMappedType* _map) const {
-    _map->insert(_key, _rownum);
-  }
-
-  // -------------------------------
-
- private:
-  /// Stores the first row number for which we do not have an index.
-  size_t begin_;
-
   /// Performs the role of an "index" over the keys
   std::shared_ptr<MapType> map_;
 
+  /// Keeps track of the rows that have been indexed.
+  std::shared_ptr<State> state_;
+
   // -------------------------------
 };
 
 // -------------------------------------------------------------------------
 // -------------------------------------------------------------------------
 
+template <class T, class Hash>
+void Index<T, Hash>::build() const {
+  assert_true(state_);
+
+  if (!state_->is_pending_.load(std::memory_order_acquire)) [[likely]] {
+    return;
+  }
+
+  const auto lock = std::lock_guard<std::mutex>(state_->mtx_);
+
+  if (!state_->pending_) {
+    return;
+  }
+
+  calculate_impl(*state_->pending_);
+
+  state_->pending_.reset();
+
+  state_->is_pending_.store(false, std::memory_order_release);
+}
+
+// -------------------------------------------------------------------------
+
 template <class T, class Hash>
 void Index<T, Hash>::calculate(const Column<T>& _key) {
+  assert_true(state_);
+
+  const auto lock = std::lock_guard<std::mutex>(state_->mtx_);
+
+  state_->pending_.reset();
+
+  state_->is_pending_.store(false, std::memory_order_release);
+
+  calculate_impl(_key);
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash>
+void Index<T, Hash>::calculate_impl(const Column<T>& _key) const {
   assert_true(map_);
 
   if (std::holds_alternative<InMemoryType>(*map_)) {
@@ -110,19 +171,27 @@ void Index<T, Hash>::calculate(const Column<T>& _key) {
 template <class T, class Hash>
 template <class KnownMapType>
 void Index<T, Hash>::calculate_known_type(const Column<T>& _key,
-                                          KnownMapType* _map) {
-  if (_key.size() < begin_) {
+                                          KnownMapType* _map) const {
+  auto& begin = state_->begin_;
+
+  if (_key.size() < begin) {
     _map->clear();
-    begin_ = 0;
+    begin = 0;
   }
 
-  for (size_t i = begin_; i < _key.nrows(); ++i) {
+  auto pairs = std::vector<std::pair<T, size_t>>();
+
+  pairs.reserve(_key.nrows() - begin);
+
+  for (size_t i = begin; i < _key.nrows(); ++i) {
     if (!is_null(_key[i])) {
-      insert(_key[i], i, _map);
+      pairs.emplace_back(_key[i], i);
     }
   }
 
-  begin_ = _key.nrows();
+  _map->append(pairs);
+
+  begin = _key.nrows();
 }
 
 // -------------------------------------------------------------------------
@@ -132,31 +201,14 @@ std::pair<const size_t*, const size_t*> Index<T, Hash>::find(
     const T _key) const {
   assert_true(map_);
 
-  if (std::holds_alternative<InMemoryType>(*map_)) {
-    const auto& idx = std::get<InMemoryType>(*map_);
-
-    const auto it = idx.find(_key);
-
-    if (it == idx.end()) {
-      return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
-    }
+  build();
 
-    return std::make_pair(it->second.data(),
-                          it->second.data() + it->second.size());
+  if (std::holds_alternative<InMemoryType>(*map_)) {
+    return std::get<InMemoryType>(*map_).find(_key);
   }
 
   if (std::holds_alternative<MemoryMappedType>(*map_)) {
-    const auto& idx = std::get<MemoryMappedType>(*map_);
-
-    const auto opt = idx[_key];
-
-    if (!opt) {
-      return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
-    }
-
-    const auto begin = opt->data();
-
-    return std::make_pair(begin, begin + opt->size());
+    return std::get<MemoryMappedType>(*map_).find(_key);
   }
 
   assert_true(false);
@@ -167,15 +219,14 @@ std::pair<const size_t*, const size_t*> Index<T, Hash>::find(
 // -------------------------------------------------------------------------
 
 template <class T, class Hash>
-void Index<T, Hash>::insert(const T _key, const size_t _rownum,
-                            InMemoryType* _map) const {
-  auto it = _map->find(_key);
-
-  if (it == _map->end()) {
-    (*_map)[_key] = {_rownum};
-  } else {
-    it->second.push_back(_rownum);
-  }
+void Index<T, Hash>::update(const Column<T>& _key) {
+  assert_true(state_);
+
+  const auto lock = std::lock_guard<std::mutex>(state_->mtx_);
+
+  state_->pending_ = _key;
+
+  state_->is_pending_.store(true, std::memory_order_release);
 }
 
 // -------------------------------------------------------------------------
@@ -14,6 +14,8 @@
 #include "strings/String.hpp"
 
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -60,6 +62,7 @@ class MemoryMappedEncoding {
 
   /// Deletes all entries
   void clear() {
+    const auto lock = std::unique_lock<std::shared_mutex>(mutex_);
     deallocate();
     allocate();
   }
@@ -171,6 +174,10 @@ class MemoryMappedEncoding {
   /// files.
   void deallocate();
 
+  /// Returns the integer mapped to a string by this encoding (excluding the
+  /// subencoding), the caller must hold mutex_.
+  Int find(const strings::String& _val) const;
+
   /// Adds an integer to map_ and vector_, assuming it is not already included
   Int insert(const strings::String& _val, const std::optional<size_t>& _opt);
 
@@ -189,6 +196,10 @@ class MemoryMappedEncoding {
   /// For fast lookup
   std::shared_ptr<BTreeType> btree_;
 
+  /// Lookups hold a shared lock, insertions a unique lock, because
+  /// inserting into the pool might remap the memory.
+  mutable std::shared_mutex mutex_;
+
   /// The null value (needed because strings are returned by reference).
   const strings::String null_value_;
 
@@ -11,6 +11,9 @@
 #include "containers/ArrayMaker.hpp"
 #include "containers/CategoricalFeatures.hpp"
 #include "containers/Column.hpp"
+#include "containers/ColumnFileIndex.hpp"
+#include "containers/ColumnFileReader.hpp"
+#include "containers/ColumnFileWriter.hpp"
 #include "containers/ColumnView.hpp"
 #include "containers/ColumnViewIterator.hpp"
 #include "containers/DataFrame.hpp"
@@ -11,8 +11,10 @@
 #include "database/Float.hpp"
 #include "database/Int.hpp"
 #include "io/Parser.hpp"
+#include "io/TimeStampParser.hpp"
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace database {
@@ -46,10 +48,10 @@ struct Getter {
     return static_cast<Int>(val);
   }
 
-  /// Returns a time stamp transformed to the number of days since epoch.
-  static Float get_time_stamp(const std::string& _str,
-                              const std::vector<std::string>& _time_formats) {
-    auto [val, success] = io::Parser::to_time_stamp(_str, _time_formats);
+  /// Returns a time stamp transformed to the number of seconds since epoch.
+  static Float get_time_stamp(const std::string_view _str,
+                              const io::TimeStampParser& _parser) {
+    auto [val, success] = _parser.parse(_str);
 
     if (!success) {
       std::tie(val, success) = io::Parser::to_double(std::string(_str));
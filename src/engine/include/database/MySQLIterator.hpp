@@ -10,6 +10,7 @@
 
 #include "database/Iterator.hpp"
 #include "debug/assert_true.hpp"
+#include "io/TimeStampParser.hpp"
 
 #include <mysql.h>
 
@@ -148,8 +149,8 @@ class MySQLIterator final : public Iterator {
   /// https://mariadb.com/kb/en/library/mysql_fetch_row/
   MYSQL_ROW row_;
 
-  /// Vector containing the time formats.
-  const std::vector<std::string> time_formats_;
+  /// Parses the time stamps using the compiled time formats.
+  const io::TimeStampParser time_stamp_parser_;
 
   // -------------------------------------------------------------------------
 };
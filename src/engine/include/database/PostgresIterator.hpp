@@ -12,6 +12,7 @@
 #include "database/Int.hpp"
 #include "database/Iterator.hpp"
 #include "debug/assert_true.hpp"
+#include "io/TimeStampParser.hpp"
 
 #include <libpq-fe.h>
 
@@ -176,8 +177,8 @@ class PostgresIterator final : public Iterator {
   /// The current row.
   int rownum_;
 
-  /// Vector containing the time formats.
-  const std::vector<std::string> time_formats_;
+  /// Parses the time stamps using the compiled time formats.
+  const io::TimeStampParser time_stamp_parser_;
 };
 
 // ----------------------------------------------------------------------------
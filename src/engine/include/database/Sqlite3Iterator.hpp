@@ -16,6 +16,7 @@ extern "C" {
 #include "database/Float.hpp"
 #include "database/Int.hpp"
 #include "database/Iterator.hpp"
+#include "io/TimeStampParser.hpp"
 
 #include <memory>
 #include <string>
@@ -108,8 +109,8 @@ class Sqlite3Iterator final : public Iterator {
   /// Unique ptr to the statement we are iterating through.
   std::unique_ptr<sqlite3_stmt, int (*)(sqlite3_stmt*)> stmt_;
 
-  /// Vector containing the time formats.
-  const std::vector<std::string> time_formats_;
+  /// Parses the time stamps using the compiled time formats.
+  const io::TimeStampParser time_stamp_parser_;
 
   // -------------------------------
 };
@@ -8,9 +8,12 @@
 #ifndef ENGINE_CONFIG_ENGINEOPTIONS_
 #define ENGINE_CONFIG_ENGINEOPTIONS_
 
+#include "memmap/PoolOptions.hpp"
+
 #include <rfl/Field.hpp>
 #include <rfl/NamedTuple.hpp>
 
+#include <optional>
 #include <string>
 
 namespace engine {
@@ -21,7 +24,15 @@ struct EngineOptions {
   static constexpr bool IN_MEMORY = true;
   static constexpr bool MEMORY_MAPPING = false;
 
-  using ReflectionType = rfl::NamedTuple<rfl::Field<"port", size_t>>;
+  using ReflectionType =
+      rfl::NamedTuple<rfl::Field<"compression", std::optional<std::string>>,
+                      rfl::Field<"hugePages", std::optional<bool>>,
+                      rfl::Field<"maxSessions", std::optional<size_t>>,
+                      rfl::Field<"memoryMappingAdvice",
+                                 std::optional<std::string>>,
+                      rfl::Field<"numThreads", std::optional<size_t>>,
+                      rfl::Field<"port", size_t>,
+                      rfl::Field<"sessionTimeout", std::optional<size_t>>>;
 
  public:
   explicit EngineOptions(const ReflectionType& _obj);
@@ -30,17 +41,58 @@ struct EngineOptions {
 
   ~EngineOptions() = default;
 
+  /// Trivial accessor
+  const std::string& compression() const { return compression_; }
+
+  /// Trivial accessor
+  size_t max_sessions() const { return max_sessions_; }
+
+  /// Trivial accessor
+  size_t num_threads() const { return num_threads_; }
+
+  /// The options for the memory-mapped pools.
+  memmap::PoolOptions pool_options() const {
+    return memmap::PoolOptions{.advice_ = memory_mapping_advice_,
+                               .huge_pages_ = huge_pages_};
+  }
+
   /// Trivial accessor
   size_t port() const { return port_; }
 
+  /// Trivial accessor
+  size_t session_timeout() const { return session_timeout_; }
+
+  /// The compression used when saving data frames ("none", "lz4" or
+  /// "zstd").
+  std::string compression_;
+
+  /// Whether the memory-mapped pools should use transparent huge pages.
+  bool huge_pages_;
+
   /// Whether you want this to be in memory or memory mapped.
   bool in_memory_;
 
+  /// The maximum number of sessions that can be open at the same time.
+  /// Sessions keep their thread for as long as they are open, so further
+  /// session requests are rejected, leaving threads for single commands.
+  size_t max_sessions_;
+
+  /// The access pattern passed on to madvise for the memory-mapped pools
+  /// ("normal", "random" or "sequential").
+  std::string memory_mapping_advice_;
+
+  /// The number of threads in the engine-wide thread pool (0 means that we
+  /// use the hardware concurrency).
+  size_t num_threads_;
+
   /// The port of the engine
   size_t port_;
 
   /// The name of the project adressed by this engine
   std::string project_;
+
+  /// The number of seconds after which an idle session is closed.
+  size_t session_timeout_;
 };
 
 }  // namespace config
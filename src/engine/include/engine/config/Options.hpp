@@ -11,6 +11,7 @@
 #include "engine/config/EngineOptions.hpp"
 #include "engine/config/MonitorOptions.hpp"
 #include "memmap/Pool.hpp"
+#include "multithreading/ThreadPool.hpp"
 
 #include <memory>
 #include <string>
@@ -76,7 +77,13 @@ class Options {
   /// Generates a new memory-mapped pool.
   std::shared_ptr<memmap::Pool> make_pool() const {
     return engine_.in_memory_ ? std::shared_ptr<memmap::Pool>()
-                              : std::make_shared<memmap::Pool>(temp_dir());
+                              : std::make_shared<memmap::Pool>(
+                                    temp_dir(), engine_.pool_options());
+  }
+
+  /// Generates the engine-wide thread pool.
+  std::shared_ptr<multithreading::ThreadPool> make_thread_pool() const {
+    return std::make_shared<multithreading::ThreadPool>(engine_.num_threads());
   }
 
   /// Generates the path for the project directory.
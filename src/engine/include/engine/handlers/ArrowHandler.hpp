@@ -8,9 +8,11 @@
 #ifndef ENGINE_HANDLERS_ARROWHANDLER_HPP_
 #define ENGINE_HANDLERS_ARROWHANDLER_HPP_
 
+#include "commands/ParquetFilter.hpp"
 #include "containers/DataFrame.hpp"
 #include "containers/Encoding.hpp"
 #include "engine/Float.hpp"
+#include "engine/Int.hpp"
 #include "engine/config/Options.hpp"
 #include "strings/String.hpp"
 
@@ -20,9 +22,12 @@
 #include <arrow/ipc/api.h>
 #include <parquet/arrow/reader.h>
 #include <parquet/arrow/writer.h>
+#include <parquet/metadata.h>
 #include <rfl/Ref.hpp>
 
+#include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -46,9 +51,15 @@ class ArrowHandler {
   std::shared_ptr<arrow::Table> df_to_table(
       const containers::DataFrame& _df) const;
 
-  /// Reads a parquet file and returns an arrow::Table.
-  std::shared_ptr<arrow::Table> read_parquet(
-      const std::string& _filename) const;
+  /// Reads a parquet file, all parquet files in a directory or all files
+  /// matching a glob pattern into a DataFrame. Only the columns in _schema
+  /// (and the columns the filters refer to) are read. Row groups that cannot
+  /// contain any rows passing _filters, according to their statistics, are
+  /// skipped altogether.
+  containers::DataFrame read_parquet(
+      const std::string& _fname, const std::string& _name,
+      const containers::Schema& _schema,
+      const std::vector<commands::ParquetFilter>& _filters) const;
 
   /// Receives an arrow::Table from a stream socket.
   template <class T>
@@ -56,6 +67,13 @@ class ArrowHandler {
                                     const std::string& _colname,
                                     Poco::Net::StreamSocket* _socket) const;
 
+  /// Receives a DataFrame from a stream socket. Every record batch is
+  /// converted as soon as it arrives, so the stream as a whole is never held
+  /// in memory.
+  containers::DataFrame recv_df(Poco::Net::StreamSocket* _socket,
+                                const std::string& _name,
+                                const containers::Schema& _schema) const;
+
   /// Receives an arrow::Table from a stream socket.
   std::shared_ptr<arrow::Table> recv_table(
       Poco::Net::StreamSocket* _socket) const;
@@ -80,6 +98,11 @@ class ArrowHandler {
                                     const containers::Schema& _schema) const;
 
  private:
+  /// Returns whether each row in _table passes _filters.
+  std::vector<bool> apply_filters(
+      const std::shared_ptr<arrow::Table>& _table,
+      const std::vector<commands::ParquetFilter>& _filters) const;
+
   /// Extracts the arrow::Schema from a DataFrame.
   std::shared_ptr<arrow::Schema> df_to_schema(
       const containers::DataFrame& _df) const;
@@ -88,16 +111,49 @@ class ArrowHandler {
   std::vector<std::shared_ptr<arrow::ChunkedArray>> extract_arrays(
       const containers::DataFrame& _df) const;
 
+  /// Expands a directory or glob pattern into the parquet files it refers to.
+  static std::vector<std::string> find_parquet_files(
+      const std::string& _fname);
+
+  /// Whether the row group _row_group may contain rows passing _filters,
+  /// judging by its statistics.
+  static bool may_pass_filters(
+      const parquet::RowGroupMetaData& _row_group,
+      const std::vector<commands::ParquetFilter>& _filters);
+
   /// Returns the appropriate compression format.
   parquet::Compression::type parse_compression(
       const std::string& _compression) const;
 
+  /// Reads a single parquet file, appending the rows that pass _filters to
+  /// _df.
+  void read_parquet_file(const std::string& _fname, const std::string& _name,
+                         const containers::Schema& _schema,
+                         const std::vector<commands::ParquetFilter>& _filters,
+                         const std::shared_ptr<memmap::Pool>& _pool,
+                         std::optional<containers::DataFrame>* _df) const;
+
+  /// Extracts a DataFrame from an arrow::Table, storing the columns in _pool.
+  /// The columns are converted in parallel.
+  containers::DataFrame table_to_df(
+      const std::shared_ptr<arrow::Table>& _table, const std::string& _name,
+      const containers::Schema& _schema,
+      const std::shared_ptr<memmap::Pool>& _pool) const;
+
   /// Converts a chunked array to a float column.
   template <class T>
   containers::Column<T> to_column(
       const std::shared_ptr<memmap::Pool>& _pool, const std::string& _name,
       const std::shared_ptr<arrow::ChunkedArray>& _arr) const;
 
+  /// Converts a chunked array to an int column using _encoding. For
+  /// dictionary chunks, only the dictionary is encoded and the indices are
+  /// remapped.
+  containers::Column<Int> to_int_column(
+      const std::shared_ptr<memmap::Pool>& _pool, const std::string& _name,
+      const std::shared_ptr<arrow::ChunkedArray>& _arr,
+      const std::shared_ptr<containers::Encoding>& _encoding) const;
+
   /// Returns a function that writes a boolean chunk to a float column or
   /// std::nullopt, if the _chunk is not a boolean chunk.
   std::optional<FloatFunction> write_boolean_to_float_column(
@@ -237,10 +293,28 @@ containers::Column<T> ArrowHandler::to_column(
             _name + "'!");
 
     if constexpr (std::is_same<T, Float>()) {
-      const auto func = write_to_float_column(chunk, _name);
-
-      for (std::int64_t i = 0; i < chunk->length(); ++i) {
-        col[begin + i] = func(i);
+      // Doubles are copied in bulk, only the NULL values need to be patched.
+      if (chunk->type()->Equals(arrow::float64())) {
+        const auto doubles =
+            std::static_pointer_cast<arrow::DoubleArray>(chunk);
+
+        std::copy(doubles->raw_values(),
+                  doubles->raw_values() + doubles->length(),
+                  col.data() + begin);
+
+        if (doubles->null_count() > 0) {
+          for (std::int64_t i = 0; i < doubles->length(); ++i) {
+            if (doubles->IsNull(i)) {
+              col[begin + i] = NAN;
+            }
+          }
+        }
+      } else {
+        const auto func = write_to_float_column(chunk, _name);
+
+        for (std::int64_t i = 0; i < chunk->length(); ++i) {
+          col[begin + i] = func(i);
+        }
       }
     }
 
@@ -16,7 +16,9 @@
 #include <arrow/ipc/api.h>
 
 #include <cstdint>
+#include <memory>
 #include <stdexcept>
+#include <utility>
 
 namespace engine {
 namespace handlers {
@@ -44,36 +46,23 @@ class ArrowSocketInputStream final : public arrow::io::InputStream {
     return arrow::Result<std::int64_t>(_nbytes);
   }
 
+  /// Receives the data directly into a newly allocated buffer.
   arrow::Result<std::shared_ptr<arrow::Buffer>> Read(
       std::int64_t _nbytes) final {
-    position_ += _nbytes;
-
-    auto data = std::vector<char>(_nbytes);
-
-    communication::Receiver::recv<char>(static_cast<ULong>(_nbytes), socket_,
-                                        data.data());
-
-    arrow::BufferBuilder builder;
-
-    auto status = builder.Resize(_nbytes);
+    auto buffer_result = arrow::AllocateBuffer(_nbytes);
 
-    if (!status.ok()) {
-      throw std::runtime_error(status.message());
+    if (!buffer_result.ok()) {
+      throw std::runtime_error(buffer_result.status().message());
     }
 
-    status = builder.Append(data.data(), _nbytes);
+    const auto buffer =
+        std::shared_ptr<arrow::Buffer>(std::move(buffer_result).ValueOrDie());
 
-    if (!status.ok()) {
-      throw std::runtime_error(status.message());
-    }
-
-    std::shared_ptr<arrow::Buffer> buffer;
-
-    status = builder.Finish(&buffer);
+    position_ += _nbytes;
 
-    if (!status.ok()) {
-      throw std::runtime_error(status.message());
-    }
+    communication::Receiver::recv<char>(
+        static_cast<ULong>(_nbytes), socket_,
+        reinterpret_cast<char *>(buffer->mutable_data()));
 
     return arrow::Result<std::shared_ptr<arrow::Buffer>>(buffer);
   }
@@ -16,26 +16,43 @@
 #include <arrow/ipc/api.h>
 
 #include <cstdint>
+#include <string>
+#include <string_view>
 
 namespace engine {
 namespace handlers {
 
+/// Writes an Arrow IPC stream to a socket. The IPC writer issues many small
+/// writes (headers, metadata and padding) in between the buffers of the
+/// columns. The small writes are collected and sent together with the next
+/// large buffer in a single scatter-gather call, while the large buffers
+/// themselves are never copied.
 class ArrowSocketOutputStream final : public arrow::io::OutputStream {
+  /// Writes smaller than this are collected in staged_.
+  static constexpr std::int64_t MIN_DIRECT_SIZE = 64 * 1024;
+
  public:
   explicit ArrowSocketOutputStream(Poco::Net::StreamSocket *_socket);
 
   ~ArrowSocketOutputStream() final = default;
 
  public:
-  /// Close the stream cleanly.
+  /// Close the stream cleanly, sending everything that has been staged.
   arrow::Status Close() final {
+    auto status = Flush();
     closed_ = true;
-    return arrow::Status::OK();
+    return status;
   }
 
   /// Return whether the stream is closed.
   bool closed() const final { return closed_; }
 
+  /// Sends everything that has been staged.
+  arrow::Status Flush() final {
+    send({});
+    return arrow::Status::OK();
+  }
+
   /// Write the given data to the stream.
   /// This method always processes the bytes in full. Depending on the
   /// semantics of the stream, the data may be written out immediately, held
@@ -44,9 +61,21 @@ class ArrowSocketOutputStream final : public arrow::io::OutputStream {
   /// use the Write variant that takes an owned Buffer.
   arrow::Status Write(const void *_data, std::int64_t _nbytes) final {
     position_ += _nbytes;
-    communication::Sender::send<char>(static_cast<ULong>(_nbytes),
-                                      reinterpret_cast<const char *>(_data),
-                                      socket_);
+
+    const auto data = std::string_view(reinterpret_cast<const char *>(_data),
+                                       static_cast<size_t>(_nbytes));
+
+    if (_nbytes >= MIN_DIRECT_SIZE) {
+      send(data);
+      return arrow::Status::OK();
+    }
+
+    staged_.append(data);
+
+    if (staged_.size() >= communication::Sender::CHUNK_SIZE) {
+      send({});
+    }
+
     return arrow::Status::OK();
   }
 
@@ -55,16 +84,19 @@ class ArrowSocketOutputStream final : public arrow::io::OutputStream {
   /// buffering is required. See Write(const void*, int64_t) for details.
   arrow::Status Write(const std::shared_ptr<arrow::Buffer> &_data) final {
     assert_true(_data);
-    position_ += _data->size();
-    communication::Sender::send<char>(
-        static_cast<ULong>(_data->size()),
-        reinterpret_cast<const char *>(_data->data()), socket_);
-    return arrow::Status::OK();
+    return Write(_data->data(), _data->size());
   }
 
   /// Return the position in this stream.
   arrow::Result<std::int64_t> Tell() const final { return position_; }
 
+ private:
+  /// Sends the staged bytes, followed by _data, and clears the stage.
+  void send(const std::string_view _data) {
+    communication::Sender::send_buffers({staged_, _data}, socket_);
+    staged_.clear();
+  }
+
  private:
   /// Whether the stream has been closed
   bool closed_;
@@ -74,6 +106,9 @@ class ArrowSocketOutputStream final : public arrow::io::OutputStream {
 
   /// A pointer to the underlying socket
   Poco::Net::StreamSocket *socket_;
+
+  /// The small writes that have not been sent yet.
+  std::string staged_;
 };
 
 // -------------------------------------------------------------------------
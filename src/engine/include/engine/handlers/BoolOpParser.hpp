@@ -9,10 +9,12 @@
 #define ENGINE_HANDLERS_BOOLOPPARSER_HPP_
 
 #include "commands/BooleanColumnView.hpp"
+#include "engine/handlers/ColumnViewCache.hpp"
 #include "engine/handlers/FloatOpParser.hpp"
 #include "engine/handlers/StringOpParser.hpp"
 
 #include <map>
+#include <memory>
 #include <string>
 
 namespace engine {
@@ -62,12 +64,14 @@ class BoolOpParser {
       const rfl::Ref<const containers::Encoding>& _categories,
       const rfl::Ref<const containers::Encoding>& _join_keys_encoding,
       const rfl::Ref<const std::map<std::string, containers::DataFrame>>&
-          _data_frames);
+          _data_frames,
+      const std::shared_ptr<ColumnViewCache>& _cache = nullptr);
 
   ~BoolOpParser() = default;
 
  public:
-  /// Parses a numerical column.
+  /// Parses a boolean column. Identical subexpressions are only parsed once,
+  /// see ColumnViewCache.
   containers::ColumnView<bool> parse(
       const commands::BooleanColumnView& _cmd) const;
 
@@ -87,6 +91,10 @@ class BoolOpParser {
   containers::ColumnView<bool> string_comparison(
       const BooleanStrComparisonOp& _cmd) const;
 
+  /// Parses a boolean column without looking it up in the cache.
+  containers::ColumnView<bool> parse_uncached(
+      const commands::BooleanColumnView& _cmd) const;
+
   /// Returns a subselection on the column.
   containers::ColumnView<bool> subselection(
       const BooleanSubselectionOp& _cmd) const;
@@ -111,7 +119,7 @@ class BoolOpParser {
       const commands::StringColumnOrStringColumnView& _col,
       const Operator& _op) const {
     const auto operand1 =
-        StringOpParser(categories_, join_keys_encoding_, data_frames_)
+        StringOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
             .parse(_col);
     return containers::ColumnView<bool>::from_un_op(operand1, _op);
   }
@@ -122,10 +130,10 @@ class BoolOpParser {
   containers::ColumnView<bool> cat_bin_op(const BooleanStrComparisonOp& _cmd,
                                           const Operator& _op) const {
     const auto operand1 =
-        StringOpParser(categories_, join_keys_encoding_, data_frames_)
+        StringOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
             .parse(*_cmd.operand1());
     const auto operand2 =
-        StringOpParser(categories_, join_keys_encoding_, data_frames_)
+        StringOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
             .parse(*_cmd.operand2());
     return containers::ColumnView<bool>::from_bin_op(operand1, operand2, _op);
   }
@@ -136,10 +144,10 @@ class BoolOpParser {
   containers::ColumnView<bool> num_bin_op(const BooleanNumComparisonOp& _cmd,
                                           const Operator& _op) const {
     const auto operand1 =
-        FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+        FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
             .parse(*_cmd.operand1());
     const auto operand2 =
-        FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+        FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
             .parse(*_cmd.operand2());
     return containers::ColumnView<bool>::from_bin_op(operand1, operand2, _op);
   }
@@ -151,12 +159,15 @@ class BoolOpParser {
       const commands::FloatColumnOrFloatColumnView& _col,
       const Operator& _op) const {
     const auto operand1 =
-        FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+        FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
             .parse(_col);
     return containers::ColumnView<bool>::from_un_op(operand1, _op);
   }
 
  private:
+  /// Deduplicates the column views of identical subexpressions.
+  const std::shared_ptr<ColumnViewCache> cache_;
+
   /// Encodes the categories used.
   const rfl::Ref<const containers::Encoding> categories_;
 
@@ -0,0 +1,188 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef ENGINE_HANDLERS_COLUMNVIEWCACHE_HPP_
+#define ENGINE_HANDLERS_COLUMNVIEWCACHE_HPP_
+
+#include "containers/ColumnView.hpp"
+#include "engine/Float.hpp"
+#include "strings/String.hpp"
+
+#include <rfl/json/write.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+namespace handlers {
+
+/// Deduplicates the column views generated by the *OpParser classes while
+/// parsing a single command. Expressions are identified by their JSON
+/// representation, so identical subexpressions are only parsed once and
+/// share a single column view. Column views that are requested more than once
+/// are materialized when they are first evaluated and read from memory after
+/// that, instead of being recomputed for every use.
+class ColumnViewCache {
+  /// A column view that has been parsed.
+  template <class T>
+  struct Entry {
+    explicit Entry(const containers::ColumnView<T>& _view)
+        : num_uses_(1), view_(_view) {}
+
+    /// The number of times the column view has been requested.
+    std::atomic<size_t> num_uses_;
+
+    /// Makes sure the column view is only materialized once.
+    std::once_flag once_;
+
+    /// The materialized values.
+    std::shared_ptr<std::vector<T>> values_;
+
+    /// The column view as it has been parsed.
+    const containers::ColumnView<T> view_;
+  };
+
+  template <class T>
+  using Entries = std::unordered_map<std::string, std::shared_ptr<Entry<T>>>;
+
+ public:
+  ColumnViewCache() = default;
+
+  ~ColumnViewCache() = default;
+
+ public:
+  /// Returns the column view for _cmd, calling _parse() only if _cmd has not
+  /// been seen before. _parse() may call get(...) recursively.
+  template <class T, class CommandType, class ParseType>
+  containers::ColumnView<T> get(const CommandType& _cmd,
+                                const ParseType& _parse) {
+    const auto key = rfl::json::write(_cmd);
+
+    if (const auto entry = find<T>(key)) {
+      ++entry->num_uses_;
+      return memoize(entry);
+    }
+
+    const auto view = _parse();
+
+    // Infinite column views cannot be materialized and column views that
+    // carry state must not be shared.
+    if (view.is_infinite() || !view.is_parallel()) {
+      return view;
+    }
+
+    const auto entry = std::make_shared<Entry<T>>(view);
+
+    {
+      const auto lock = std::lock_guard<std::mutex>(mtx_);
+      entries<T>().emplace(key, entry);
+    }
+
+    return memoize(entry);
+  }
+
+ private:
+  /// Returns the entries of type T.
+  template <class T>
+  Entries<T>& entries() {
+    if constexpr (std::is_same<T, bool>()) {
+      return bool_entries_;
+    } else if constexpr (std::is_same<T, Float>()) {
+      return float_entries_;
+    } else {
+      static_assert(std::is_same<T, strings::String>(), "Unsupported type.");
+      return string_entries_;
+    }
+  }
+
+  /// Returns the entry for _key, if it exists.
+  template <class T>
+  std::shared_ptr<Entry<T>> find(const std::string& _key) {
+    const auto lock = std::lock_guard<std::mutex>(mtx_);
+    const auto it = entries<T>().find(_key);
+    return it != entries<T>().end() ? it->second : nullptr;
+  }
+
+  /// Generates a column view that reads from the materialized values once
+  /// the entry has been requested more than once.
+  template <class T>
+  static containers::ColumnView<T> memoize(
+      const std::shared_ptr<Entry<T>>& _entry) {
+    const auto values = [_entry]() -> const std::vector<T>& {
+      std::call_once(_entry->once_, [&_entry]() {
+        _entry->values_ = _entry->view_.to_vector(0, std::nullopt, false);
+      });
+      return *_entry->values_;
+    };
+
+    const auto value_func = [_entry,
+                             values](const size_t _i) -> std::optional<T> {
+      if (_entry->num_uses_ < 2) {
+        return _entry->view_[_i];
+      }
+
+      const auto& vec = values();
+
+      if (_i >= vec.size()) {
+        return std::nullopt;
+      }
+
+      return vec[_i];
+    };
+
+    const auto batch_func = [_entry, values](const size_t _begin,
+                                             const size_t _size,
+                                             T* _out) -> size_t {
+      if (_entry->num_uses_ < 2) {
+        return _entry->view_.batch(_begin, _size, _out);
+      }
+
+      const auto& vec = values();
+
+      if (_begin >= vec.size()) {
+        return 0;
+      }
+
+      const auto n = std::min(_size, vec.size() - _begin);
+
+      std::copy(vec.begin() + _begin, vec.begin() + _begin + n, _out);
+
+      return n;
+    };
+
+    const auto& view = _entry->view_;
+
+    return containers::ColumnView<T>(value_func, batch_func, view.nrows(),
+                                     true, view.subroles(), view.unit());
+  }
+
+ private:
+  /// The boolean column views.
+  Entries<bool> bool_entries_;
+
+  /// The numerical column views.
+  Entries<Float> float_entries_;
+
+  /// Protects the entries.
+  std::mutex mtx_;
+
+  /// The string column views.
+  Entries<strings::String> string_entries_;
+};
+
+}  // namespace handlers
+}  // namespace engine
+
+#endif  // ENGINE_HANDLERS_COLUMNVIEWCACHE_HPP_
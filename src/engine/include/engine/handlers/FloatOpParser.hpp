@@ -14,8 +14,10 @@
 #include "containers/DataFrame.hpp"
 #include "containers/Encoding.hpp"
 #include "engine/Float.hpp"
+#include "engine/handlers/ColumnViewCache.hpp"
 
 #include <map>
+#include <memory>
 #include <random>
 #include <string>
 
@@ -82,7 +84,8 @@ class FloatOpParser {
       const rfl::Ref<const containers::Encoding>& _categories,
       const rfl::Ref<const containers::Encoding>& _join_keys_encoding,
       const rfl::Ref<const std::map<std::string, containers::DataFrame>>&
-          _data_frames);
+          _data_frames,
+      const std::shared_ptr<ColumnViewCache>& _cache = nullptr);
 
   ~FloatOpParser() = default;
 
@@ -93,7 +96,8 @@ class FloatOpParser {
              const rfl::Ref<const communication::Logger>& _logger,
              Poco::Net::StreamSocket* _socket) const;
 
-  /// Parses a numerical column.
+  /// Parses a numerical column. Identical subexpressions are only parsed
+  /// once, see ColumnViewCache.
   containers::ColumnView<Float> parse(
       const commands::FloatColumnOrFloatColumnView& _cmd) const;
 
@@ -122,6 +126,10 @@ class FloatOpParser {
   /// Returns an actual column.
   containers::ColumnView<Float> get_column(const FloatColumnOp& _cmd) const;
 
+  /// Parses a numerical column without looking it up in the cache.
+  containers::ColumnView<Float> parse_uncached(
+      const commands::FloatColumnOrFloatColumnView& _cmd) const;
+
   /// Returns a subselection on the column.
   containers::ColumnView<Float> subselection(
       const FloatSubselectionOp& _cmd) const;
@@ -175,7 +183,11 @@ class FloatOpParser {
       return dis(rng);
     };
 
-    return containers::ColumnView<Float>(value_func, NROWS_INFINITE);
+    // The values depend on the order in which the rows are drawn, so the
+    // column view cannot be evaluated in parallel.
+    return containers::ColumnView<Float>(
+        value_func, containers::ColumnView<Float>::make_batch_func(value_func),
+        NROWS_INFINITE, false);
   }
 
   /// Returns a columns containing the rowids.
@@ -197,6 +209,9 @@ class FloatOpParser {
   }
 
  private:
+  /// Deduplicates the column views of identical subexpressions.
+  const std::shared_ptr<ColumnViewCache> cache_;
+
   /// Encodes the categories used.
   const rfl::Ref<const containers::Encoding> categories_;
 
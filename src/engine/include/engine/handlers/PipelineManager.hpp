@@ -16,6 +16,7 @@
 #include "engine/handlers/PipelineManagerParams.hpp"
 #include "engine/pipelines/FittedPipeline.hpp"
 #include "metrics/Scores.hpp"
+#include "multithreading/ReadLock.hpp"
 #include "multithreading/WeakWriteLock.hpp"
 
 #include <Poco/Net/StreamSocket.h>
@@ -210,13 +211,26 @@ class PipelineManager {
              const pipelines::Pipeline& _pipeline,
              Poco::Net::StreamSocket* _socket);
 
-  /// Stores the newly created data frame.
+  /// Translates the codes in the categorical columns and join keys of _df
+  /// that have been assigned by the local encodings into the codes of the
+  /// global encodings. Only codes that are at least _num_categories or
+  /// _num_join_keys (the sizes of the global encodings when the local
+  /// encodings were created) can differ.
+  void recode(const containers::Encoding& _local_categories,
+              const containers::Encoding& _local_join_keys_encoding,
+              const size_t _num_categories, const size_t _num_join_keys,
+              containers::DataFrame* _df);
+
+  /// Stores the newly created data frame. _num_categories and
+  /// _num_join_keys are the sizes of the global encodings when the local
+  /// encodings were created.
   void store_df(const pipelines::FittedPipeline& _fitted,
                 const FullTransformOp& _cmd,
                 const containers::DataFrame& _population_df,
                 const std::vector<containers::DataFrame>& _peripheral_dfs,
                 const rfl::Ref<containers::Encoding>& _local_categories,
                 const rfl::Ref<containers::Encoding>& _local_join_keys_encoding,
+                const size_t _num_categories, const size_t _num_join_keys,
                 containers::DataFrame* _df,
                 multithreading::WeakWriteLock* _weak_write_lock);
 
@@ -14,8 +14,10 @@
 #include "containers/DataFrame.hpp"
 #include "containers/Encoding.hpp"
 #include "engine/Int.hpp"
+#include "engine/handlers/ColumnViewCache.hpp"
 
 #include <map>
+#include <memory>
 #include <string>
 
 namespace engine {
@@ -73,7 +75,8 @@ class StringOpParser {
       const rfl::Ref<const containers::Encoding>& _categories,
       const rfl::Ref<const containers::Encoding>& _join_keys_encoding,
       const rfl::Ref<const std::map<std::string, containers::DataFrame>>&
-          _data_frames);
+          _data_frames,
+      const std::shared_ptr<ColumnViewCache>& _cache = nullptr);
 
   ~StringOpParser() = default;
 
@@ -84,7 +87,8 @@ class StringOpParser {
              const rfl::Ref<const communication::Logger>& _logger,
              Poco::Net::StreamSocket* _socket) const;
 
-  /// Parses a string column.
+  /// Parses a string column. Identical subexpressions are only parsed once,
+  /// see ColumnViewCache.
   containers::ColumnView<strings::String> parse(
       const commands::StringColumnOrStringColumnView& _cmd) const;
 
@@ -105,6 +109,10 @@ class StringOpParser {
   containers::ColumnView<strings::String> numerical_as_string(
       const commands::FloatColumnOrFloatColumnView& _col) const;
 
+  /// Parses a string column without looking it up in the cache.
+  containers::ColumnView<strings::String> parse_uncached(
+      const commands::StringColumnOrStringColumnView& _cmd) const;
+
   /// Returns a subselection on the column.
   containers::ColumnView<strings::String> subselection(
       const StringSubselectionOp& _cmd) const;
@@ -150,6 +158,9 @@ class StringOpParser {
   }
 
  private:
+  /// Deduplicates the column views of identical subexpressions.
+  const std::shared_ptr<ColumnViewCache> cache_;
+
   /// Encodes the categories used.
   const rfl::Ref<const containers::Encoding> categories_;
 
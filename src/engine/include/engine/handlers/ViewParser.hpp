@@ -14,6 +14,7 @@
 #include "containers/ColumnView.hpp"
 #include "containers/ViewContent.hpp"
 #include "engine/handlers/ArrowHandler.hpp"
+#include "engine/handlers/ColumnViewCache.hpp"
 
 #include <Poco/Net/StreamSocket.h>
 #include <rfl/json/read.hpp>
@@ -123,6 +124,10 @@ class ViewParser {
   void subselection(const ViewOp& _cmd, containers::DataFrame* _df) const;
 
  private:
+  /// Shared by all column views parsed, so that subexpressions appearing in
+  /// several columns or in the subselection are only evaluated once.
+  const std::shared_ptr<ColumnViewCache> cache_;
+
   /// Encodes the categories used.
   const rfl::Ref<containers::Encoding> categories_;
 
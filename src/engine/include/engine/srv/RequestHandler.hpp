@@ -8,6 +8,7 @@
 #ifndef ENGINE_SRV_REQUESTHANDLER_HPP_
 #define ENGINE_SRV_REQUESTHANDLER_HPP_
 
+#include "commands/Command.hpp"
 #include "engine/handlers/ColumnManager.hpp"
 #include "engine/handlers/DataFrameManager.hpp"
 #include "engine/handlers/DatabaseManager.hpp"
@@ -26,6 +27,15 @@ namespace engine {
 namespace srv {
 
 /// A RequestHandler handles all request in deploy mode.
+///
+/// By default, every connection carries exactly one command. If the first
+/// command is a SessionOp, the connection is kept open instead and the
+/// commands sent over it are handled one after the other, until the client
+/// closes the connection, the session has been idle for too long or a
+/// command fails. Sessions keep their thread, so no more than
+/// EngineOptions::max_sessions() of them can be open at the same time. Because the responses are sent in the same order as the
+/// commands were received, the client can send several commands before
+/// reading the first response.
 class RequestHandler final : public Poco::Net::TCPServerConnection {
  public:
   static constexpr const char* FLOAT_COLUMN =
@@ -41,6 +51,7 @@ class RequestHandler final : public Poco::Net::TCPServerConnection {
                  const rfl::Ref<handlers::PipelineManager>& _pipeline_manager,
                  const config::Options& _options,
                  const rfl::Ref<handlers::ProjectManager>& _project_manager,
+                 const rfl::Ref<std::atomic<size_t>>& _num_sessions,
                  const rfl::Ref<std::atomic<bool>>& _shutdown);
 
   ~RequestHandler() final = default;
@@ -48,6 +59,22 @@ class RequestHandler final : public Poco::Net::TCPServerConnection {
   /// Required by Poco::Net::TCPServerConnection. Does the actual handling.
   void run();
 
+ private:
+  /// Executes a single command.
+  void handle(const commands::Command& _cmd);
+
+  /// Receives and parses the next command.
+  commands::Command recv_command();
+
+  /// Handles the commands of a session until it ends. Throws, if too many
+  /// sessions are open already.
+  void run_session();
+
+  /// Waits until the client has sent the next command. Returns false, if the
+  /// client has closed the connection, the session has timed out or the
+  /// engine is shutting down.
+  bool wait_for_command();
+
  private:
   /// Trivial accessor
   handlers::DatabaseManager& database_manager() { return *database_manager_; }
@@ -96,6 +123,9 @@ class RequestHandler final : public Poco::Net::TCPServerConnection {
   /// load.
   const rfl::Ref<handlers::ProjectManager> project_manager_;
 
+  /// The number of sessions currently open, shared by all connections.
+  const rfl::Ref<std::atomic<size_t>> num_sessions_;
+
   /// Signals to the main process that we want to shut down.
   const rfl::Ref<std::atomic<bool>>& shutdown_;
 };
@@ -59,6 +59,9 @@ class ServerConnectionFactoryImpl final
   /// load.
   const rfl::Ref<handlers::ProjectManager> project_manager_;
 
+  /// The number of sessions currently open, shared by all connections.
+  const rfl::Ref<std::atomic<size_t>> num_sessions_;
+
   /// Signals to the main process that we want to shut down.
   const rfl::Ref<std::atomic<bool>>& shutdown_;
 };
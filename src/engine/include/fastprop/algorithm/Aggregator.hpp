@@ -10,6 +10,7 @@
 
 #include "fastprop/Float.hpp"
 #include "fastprop/Int.hpp"
+#include "fastprop/algorithm/CompiledConditions.hpp"
 #include "fastprop/algorithm/Memoization.hpp"
 #include "fastprop/containers/DataFrame.hpp"
 #include "fastprop/containers/Features.hpp"
@@ -20,8 +21,10 @@
 
 #include <rfl/Ref.hpp>
 
+#include <functional>
 #include <memory>
 #include <ranges>
+#include <span>
 #include <utility>
 
 namespace fastprop {
@@ -38,8 +41,8 @@ class Aggregator {
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
       const std::optional<containers::Features> &_subfeatures,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -51,12 +54,18 @@ class Aggregator {
   }
 
  private:
+  /// Applies the aggregation to the range currently memorized in
+  /// _memoization. Aggregations that need sorted values or partial
+  /// statistics share them via the memoization.
+  static Float aggregate_memoized(const enums::Aggregation _aggregation,
+                                  const rfl::Ref<Memoization> &_memoization);
+
   /// Applies an aggregation to a categorical column.
   static Float apply_categorical(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -68,16 +77,16 @@ class Aggregator {
   static Float apply_discrete(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
   /// Applies a COUNT aggregation
   static Float apply_not_applicable(
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -85,8 +94,8 @@ class Aggregator {
   static Float apply_numerical(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -94,8 +103,8 @@ class Aggregator {
   static Float apply_same_units_categorical(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -103,8 +112,8 @@ class Aggregator {
   static Float apply_same_units_discrete(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -112,8 +121,8 @@ class Aggregator {
   static Float apply_same_units_numerical(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -122,8 +131,8 @@ class Aggregator {
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
       const containers::Features &_subfeatures,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -131,8 +140,8 @@ class Aggregator {
   static Float apply_text(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const std::span<const containers::Match> _matches,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization);
 
@@ -255,9 +264,9 @@ class Aggregator {
   /// Aggregates the matches using the extract_value lambda function.
   template <class ExtractValueType>
   static Float aggregate_matches_categorical(
-      const std::vector<containers::Match> &_matches,
+      const std::span<const containers::Match> _matches,
       const ExtractValueType &_extract_value,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature) {
     const auto is_non_null = [](Int val) { return val >= 0; };
 
@@ -269,7 +278,7 @@ class Aggregator {
                                          _abstract_feature.aggregation_);
     }
 
-    auto range = _matches | std::views::filter(_condition_function) |
+    auto range = _matches | std::views::filter(std::cref(_conditions)) |
                  std::views::transform(_extract_value) |
                  std::views::filter(is_non_null);
 
@@ -374,9 +383,9 @@ class Aggregator {
   static Float apply_first_last(
       const containers::DataFrame &_population,
       const containers::DataFrame &_peripheral,
-      const std::vector<containers::Match> &_matches,
+      const std::span<const containers::Match> _matches,
       const ExtractValueType &_extract_value,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization) {
     assert_true(is_first_last(_abstract_feature.aggregation_));
@@ -394,7 +403,7 @@ class Aggregator {
       return std::make_pair(key, value);
     };
 
-    memorize_pairs_range(_matches, extract_pair, _condition_function,
+    memorize_pairs_range(_matches, extract_pair, _conditions,
                          _abstract_feature, _memoization);
 
     if (_abstract_feature.aggregation_.value() ==
@@ -459,17 +468,18 @@ class Aggregator {
   /// Memorizes the range for numerical values.
   template <class ExtractValueType>
   static void memorize_numerical_range(
-      const std::vector<containers::Match> &_matches,
+      const std::span<const containers::Match> _matches,
       const ExtractValueType &_extract_value,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization) {
     if (_abstract_feature.conditions_.size() == 0) {
       const auto range = _matches | std::views::transform(_extract_value) |
                          std::views::filter(is_not_nan_or_inf);
       _memoization->memorize_numerical(_abstract_feature, range);
+      return;
     }
-    const auto range = _matches | std::views::filter(_condition_function) |
+    const auto range = _matches | std::views::filter(std::cref(_conditions)) |
                        std::views::transform(_extract_value) |
                        std::views::filter(is_not_nan_or_inf);
     _memoization->memorize_numerical(_abstract_feature, range);
@@ -478,9 +488,9 @@ class Aggregator {
   /// Memorizes the range for pairs.
   template <class ExtractValueType>
   static void memorize_pairs_range(
-      const std::vector<containers::Match> &_matches,
+      const std::span<const containers::Match> _matches,
       const ExtractValueType &_extract_value,
-      const std::function<bool(const containers::Match &)> &_condition_function,
+      const CompiledConditions &_conditions,
       const containers::AbstractFeature &_abstract_feature,
       const rfl::Ref<Memoization> &_memoization) {
     assert_true(is_first_last(_abstract_feature.aggregation_));
@@ -488,8 +498,9 @@ class Aggregator {
       const auto range = _matches | std::views::transform(_extract_value) |
                          std::views::filter(second_is_not_nan_or_inf);
       _memoization->memorize_pairs(_abstract_feature, range);
+      return;
     }
-    const auto range = _matches | std::views::filter(_condition_function) |
+    const auto range = _matches | std::views::filter(std::cref(_conditions)) |
                        std::views::transform(_extract_value) |
                        std::views::filter(second_is_not_nan_or_inf);
     _memoization->memorize_pairs(_abstract_feature, range);
@@ -0,0 +1,123 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef FASTPROP_ALGORITHM_COLUMNAGGREGATOR_HPP_
+#define FASTPROP_ALGORITHM_COLUMNAGGREGATOR_HPP_
+
+#include "fastprop/Float.hpp"
+#include "fastprop/algorithm/CompiledConditions.hpp"
+#include "fastprop/algorithm/MatchCache.hpp"
+#include "fastprop/containers/AbstractFeature.hpp"
+#include "fastprop/containers/Match.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace fastprop {
+namespace algorithm {
+
+/// Evaluates a single abstract feature over a block of rows at once, as
+/// opposed to the Aggregator, which evaluates all features for a single
+/// row. The values of the peripheral column are gathered into a contiguous
+/// buffer and then reduced segment by segment, so the dispatch over the
+/// aggregation happens once per block and the inner loops run over
+/// contiguous memory.
+///
+/// Only a subset of the abstract features is supported, see is_supported(...).
+/// Everything else needs to go through the Aggregator.
+class ColumnAggregator {
+ public:
+  /// Identifies the values gathered into the workspace: The peripheral table,
+  /// data used, input column and output column.
+  typedef std::tuple<size_t, size_t, size_t, size_t> ValuesKey;
+
+  /// Scratch memory that is reused between calls. Every thread needs its own
+  /// workspace.
+  struct Workspace {
+    /// The match cache the matches have been taken from.
+    const MatchCache* match_cache_ = nullptr;
+
+    /// The position of the first row in the block.
+    size_t begin_ = 0;
+
+    /// The position of the first row after the block.
+    size_t end_ = 0;
+
+    /// The matches of all rows in the block, one vector per peripheral table.
+    std::vector<std::vector<containers::Match>> matches_;
+
+    /// offsets_[i][k] to offsets_[i][k + 1] are the matches of the k-th row
+    /// of the block in matches_[i].
+    std::vector<std::vector<size_t>> offsets_;
+
+    /// The values gathered for the matches.
+    std::vector<Float> values_;
+
+    /// Describes what is currently contained in values_, if anything.
+    std::optional<ValuesKey> values_key_;
+
+    /// Whether the matches fulfill the conditions, 1 or 0.
+    std::vector<std::uint8_t> selection_;
+
+    /// The conditions the selection has been calculated for, if any.
+    std::optional<std::vector<containers::Condition>> selection_conditions_;
+
+    /// The values, with the values not selected set to NaN.
+    std::vector<Float> masked_;
+  };
+
+ public:
+  /// Applies the aggregation defined in _abstract_feature to the rows at
+  /// positions _begin to _end in _match_cache, taking into account only the
+  /// matches that fulfill _conditions. The result for the k-th row is
+  /// written into _out[k * _stride].
+  static void apply_aggregation(
+      const MatchCache& _match_cache,
+      const containers::AbstractFeature& _abstract_feature,
+      const CompiledConditions& _conditions, const size_t _begin,
+      const size_t _end, Workspace* _workspace, Float* _out,
+      const size_t _stride);
+
+  /// Whether _abstract_feature can be evaluated by the ColumnAggregator.
+  static bool is_supported(
+      const containers::AbstractFeature& _abstract_feature);
+
+ private:
+  /// Gathers the matches for all rows in the block, unless they are already
+  /// contained in the workspace.
+  static void gather_matches(const MatchCache& _match_cache,
+                             const size_t _begin, const size_t _end,
+                             Workspace* _workspace);
+
+  /// Gathers the values the aggregation is applied to, unless they are
+  /// already contained in the workspace.
+  static void gather_values(
+      const MatchCache& _match_cache,
+      const containers::AbstractFeature& _abstract_feature,
+      Workspace* _workspace);
+
+  /// Calculates the selection for the conditions and masks the values,
+  /// reusing the selection if the conditions are the same as last time.
+  static void mask_values(const size_t _peripheral_ix,
+                          const CompiledConditions& _conditions,
+                          Workspace* _workspace);
+
+  /// Reduces each segment of _values signified by _offsets using the
+  /// aggregation.
+  static void reduce(const enums::Aggregation _aggregation,
+                     const std::vector<size_t>& _offsets,
+                     const std::vector<Float>& _values, Float* _out,
+                     const size_t _stride);
+};
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
+
+#endif  // FASTPROP_ALGORITHM_COLUMNAGGREGATOR_HPP_
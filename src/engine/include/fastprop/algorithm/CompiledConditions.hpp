@@ -0,0 +1,135 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef FASTPROP_ALGORITHM_COMPILEDCONDITIONS_HPP_
+#define FASTPROP_ALGORITHM_COMPILEDCONDITIONS_HPP_
+
+#include "fastprop/Float.hpp"
+#include "fastprop/Int.hpp"
+#include "fastprop/containers/Condition.hpp"
+#include "fastprop/containers/Match.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace fastprop {
+namespace algorithm {
+
+/// The conditions of an abstract feature, compiled into a flat list of typed
+/// predicates. Unlike a std::function, evaluating a predicate does not
+/// require an indirect call, and select(...) evaluates one predicate at a
+/// time over an entire array of matches.
+///
+/// The predicates point directly into the columns of the data frames they
+/// have been compiled from, so they must not outlive the table holder.
+class CompiledConditions {
+ public:
+  /// A single compiled condition.
+  struct Predicate {
+    enum class Op { categorical, lag, same_units_categorical };
+
+    /// The kind of condition.
+    Op op_;
+
+    /// The categorical column in the peripheral table (categorical and
+    /// same_units_categorical).
+    const Int* input_int_ = nullptr;
+
+    /// The categorical column in the population table
+    /// (same_units_categorical).
+    const Int* output_int_ = nullptr;
+
+    /// The time stamps in the peripheral table (lag).
+    const Float* input_ts_ = nullptr;
+
+    /// The time stamps in the population table (lag).
+    const Float* output_ts_ = nullptr;
+
+    /// The category to compare to (categorical).
+    Int category_used_ = 0;
+
+    /// The lower bound of the lag window (lag).
+    Float bound_lower_ = 0.0;
+
+    /// The upper bound of the lag window (lag).
+    Float bound_upper_ = 0.0;
+
+    /// Whether the match fulfills the condition.
+    bool operator()(const containers::Match& _match) const {
+      switch (op_) {
+        case Op::categorical:
+          return input_int_[_match.ix_input] == category_used_;
+
+        case Op::lag:
+          return (input_ts_[_match.ix_input] + bound_upper_ >
+                  output_ts_[_match.ix_output]) &&
+                 (input_ts_[_match.ix_input] + bound_lower_ <=
+                  output_ts_[_match.ix_output]);
+
+        case Op::same_units_categorical:
+          return output_int_[_match.ix_output] == input_int_[_match.ix_input];
+      }
+      return false;
+    }
+  };
+
+ public:
+  CompiledConditions(const std::vector<containers::Condition>& _conditions,
+                     const std::vector<Predicate>& _predicates);
+
+  ~CompiledConditions() = default;
+
+ public:
+  /// Whether the match fulfills all conditions.
+  bool operator()(const containers::Match& _match) const {
+    for (const auto& p : predicates_) {
+      if (!p(_match)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /// Writes 1 into _selection for every match that fulfills all conditions
+  /// and 0 for every match that does not.
+  void select(const std::span<const containers::Match> _matches,
+              std::vector<std::uint8_t>* _selection) const;
+
+ public:
+  /// The original conditions - features with identical conditions can share
+  /// the selection.
+  const std::vector<containers::Condition>& conditions() const {
+    return conditions_;
+  }
+
+  /// Whether there are no conditions at all.
+  bool empty() const { return predicates_.size() == 0; }
+
+  /// Whether any of the conditions depends on the population table. If it
+  /// does not, the conditions can be evaluated for the peripheral rows alone.
+  bool depends_on_output() const;
+
+ private:
+  /// Evaluates a single predicate and combines it with _selection.
+  static void select_one(const Predicate& _p,
+                         const std::span<const containers::Match> _matches,
+                         std::uint8_t* _selection);
+
+ private:
+  /// The original conditions.
+  std::vector<containers::Condition> conditions_;
+
+  /// The compiled predicates.
+  std::vector<Predicate> predicates_;
+};
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
+
+#endif  // FASTPROP_ALGORITHM_COMPILEDCONDITIONS_HPP_
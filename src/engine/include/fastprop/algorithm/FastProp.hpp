@@ -9,7 +9,9 @@
 #define FASTPROP_ALGORITHM_FASTPROP_HPP_
 
 #include "fastprop/Hyperparameters.hpp"
+#include "fastprop/algorithm/CompiledConditions.hpp"
 #include "fastprop/algorithm/FitParams.hpp"
+#include "fastprop/algorithm/MatchCache.hpp"
 #include "fastprop/algorithm/Memoization.hpp"
 #include "fastprop/algorithm/TableHolder.hpp"
 #include "fastprop/algorithm/TransformParams.hpp"
@@ -25,6 +27,7 @@
 #include "helpers/VocabularyContainer.hpp"
 #include "helpers/VocabularyTree.hpp"
 #include "multithreading/Communicator.hpp"
+#include "multithreading/WorkStealingScheduler.hpp"
 
 #include <rfl/Field.hpp>
 #include <rfl/NamedTuple.hpp>
@@ -126,31 +129,37 @@ class FastProp {
       const std::vector<containers::DataFrame>& _peripheral,
       const containers::AbstractFeature& _abstract_feature) const;
 
-  /// Builds a new row of features and inserts it.
+  /// Builds a new row of features and inserts it. The features marked in
+  /// _is_columnar are skipped, they are built by the ColumnAggregator.
   void build_row(
-      const TableHolder& _table_holder,
+      const MatchCache& _match_cache,
       const std::vector<containers::Features>& _subfeatures,
-      const std::vector<size_t>& _index,
-      const std::vector<std::function<bool(const containers::Match&)>>&
-          _condition_functions,
-      const size_t _rownum, const rfl::Ref<Memoization>& _memoization,
+      const std::vector<size_t>& _index, const std::vector<bool>& _is_columnar,
+      const std::vector<CompiledConditions>& _conditions,
+      const size_t _pos, const rfl::Ref<Memoization>& _memoization,
+      std::vector<std::vector<containers::Match>>* _buffers,
       Float* _row) const;
 
-  /// Builds all rows for the thread associated with _thread_num
+  /// Builds the rows in the chunks the scheduler hands out to the thread
+  /// associated with _thread_num.
   void build_rows(const TransformParams& _params,
                   const std::vector<containers::Features>& _subfeatures,
-                  const std::shared_ptr<std::vector<size_t>>& _rownums,
-                  const size_t _thread_num, std::atomic<size_t>* _num_completed,
+                  const MatchCache& _match_cache,
+                  const size_t _thread_num,
+                  multithreading::WorkStealingScheduler* _scheduler,
+                  std::atomic<size_t>* _num_completed,
                   containers::Features* _features) const;
 
   /// Builds the subfeatures.
   std::vector<containers::Features> build_subfeatures(
       const TransformParams& _params,
-      const std::shared_ptr<std::vector<size_t>>& _rownums) const;
+      const std::shared_ptr<std::vector<size_t>>& _rownums,
+      const MatchCache& _match_cache) const;
 
   /// Copies the data from the cache into the actual features.
   void cache_to_features(const std::vector<size_t>& _rownums,
-                         const size_t _begin, const std::vector<Float>& _cache,
+                         const size_t _begin, const size_t _end,
+                         const std::vector<Float>& _cache,
                          containers::Features* _features) const;
 
   /// Calculates the R-squared for each feature vis-a-vis the targets.
@@ -326,14 +335,32 @@ class FastProp {
       const containers::DataFrame& _population,
       const containers::DataFrame& _peripheral, const size_t _ix) const;
 
-  /// Generates the matches for a particular row in the population table.
-  std::vector<std::vector<containers::Match>> make_matches(
-      const TableHolder& _table_holder, const size_t _rownum) const;
+  /// Cuts the rows of _match_cache into chunks for the work-stealing
+  /// scheduler, such that every chunk contains roughly the same number of
+  /// matches.
+  std::shared_ptr<const std::vector<size_t>> make_chunks(
+      const MatchCache& _match_cache) const;
+
+  /// Generates the match cache for the rows signified by _rownums. When
+  /// _rownums is a nullptr, all rows are used. If _cache_matches is false,
+  /// the matches are generated on the fly and _memory_budget is ignored, but
+  /// _temp_dir is still used for the time series indices.
+  std::shared_ptr<const MatchCache> make_match_cache(
+      const containers::DataFrame& _population,
+      const std::vector<containers::DataFrame>& _peripheral,
+      const helpers::WordIndexContainer& _word_indices,
+      const std::shared_ptr<std::vector<size_t>>& _rownums,
+      const bool _cache_matches, const size_t _memory_budget,
+      const std::optional<std::string>& _temp_dir) const;
 
-  /// Generates the rownums for the thread signified by _thread_num
-  std::shared_ptr<std::vector<size_t>> make_rownums(
-      const size_t _thread_num, const size_t _nrows,
-      const std::shared_ptr<std::vector<size_t>>& _rownums) const;
+  /// Generates the table holder for the rows signified by _rownums. If
+  /// _temp_dir is set, the time series indices are memory-mapped.
+  TableHolder make_table_holder(
+      const containers::DataFrame& _population,
+      const std::vector<containers::DataFrame>& _peripheral,
+      const helpers::WordIndexContainer& _word_indices,
+      const std::shared_ptr<const std::vector<size_t>>& _rownums,
+      const std::optional<std::string>& _temp_dir) const;
 
   /// Creates a random subsample for fitting.
   std::shared_ptr<std::vector<size_t>> sample_from_population(
@@ -350,10 +377,12 @@ class FastProp {
                        const containers::DataFrame& _population,
                        const containers::DataFrame& _peripheral) const;
 
-  /// Spawns the threads for building the features.
+  /// Spawns the threads for building the features, which work through
+  /// _chunks (as generated by make_chunks(...)).
   void spawn_threads(const TransformParams& _params,
                      const std::vector<containers::Features>& _subfeatures,
-                     const std::shared_ptr<std::vector<size_t>>& _rownums,
+                     const MatchCache& _match_cache,
+                     const std::shared_ptr<const std::vector<size_t>>& _chunks,
                      containers::Features* _features) const;
 
   /// Expresses the subfeatures as SQL code.
@@ -365,6 +394,17 @@ class FastProp {
       const std::string& _feature_prefix, const size_t _offset,
       std::vector<std::string>* _sql) const;
 
+  /// Like transform(...), but reuses matches that have already been
+  /// generated, so the join need not be repeated for every batch. When
+  /// _match_cache is a nullptr, the matches are generated on the fly. The
+  /// same goes for _chunks, which must belong to _match_cache.
+  containers::Features transform_with_cache(
+      const TransformParams& _params,
+      const std::shared_ptr<std::vector<size_t>>& _rownums,
+      const bool _as_subfeatures,
+      const std::shared_ptr<const MatchCache>& _match_cache,
+      const std::shared_ptr<const std::vector<size_t>>& _chunks) const;
+
  public:
   /// Trivial accessor
   bool& allow_http() { return allow_http_; }
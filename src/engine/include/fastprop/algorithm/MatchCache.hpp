@@ -0,0 +1,164 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef FASTPROP_ALGORITHM_MATCHCACHE_HPP_
+#define FASTPROP_ALGORITHM_MATCHCACHE_HPP_
+
+#include "fastprop/algorithm/TableHolder.hpp"
+#include "fastprop/containers/Match.hpp"
+#include "memmap/Pool.hpp"
+#include "memmap/Vector.hpp"
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace fastprop {
+namespace algorithm {
+
+/// Contains the matches of every row in the population table with every
+/// peripheral table in CSR format, so that the join only needs to be done
+/// once per fit, instead of once for every batch of features. The rows are
+/// addressed by their position in rownums(), not by their row number.
+///
+/// If the matches do not fit into the memory budget, they are spilled into a
+/// memory-mapped pool in the temporary directory. If there is no temporary
+/// directory either, the matches are not cached at all, but recalculated
+/// every time they are needed.
+class MatchCache {
+ public:
+  typedef std::variant<std::vector<containers::Match>,
+                       memmap::Vector<containers::Match>>
+      MatchesVariant;
+
+  /// Matches for a single peripheral table.
+  struct CSR {
+    /// offsets_[i] to offsets_[i + 1] are the matches of row i.
+    std::vector<size_t> offsets_;
+
+    /// The actual matches.
+    MatchesVariant matches_;
+  };
+
+ public:
+  MatchCache(const std::shared_ptr<const TableHolder>& _table_holder,
+             const std::shared_ptr<const std::vector<size_t>>& _rownums,
+             const size_t _memory_budget,
+             const std::optional<std::string>& _temp_dir);
+
+  ~MatchCache() = default;
+
+  MatchCache(const MatchCache&) = delete;
+  MatchCache& operator=(const MatchCache&) = delete;
+
+ public:
+  /// Returns the matches between the row at position _pos and the
+  /// peripheral table signified by _peripheral_ix. If the matches are not
+  /// cached, they are written into _buffer.
+  std::span<const containers::Match> matches(
+      const size_t _peripheral_ix, const size_t _pos,
+      std::vector<containers::Match>* _buffer) const;
+
+  /// Writes the matches between the rows at positions _begin to _end and
+  /// the peripheral table signified by _peripheral_ix into _matches in CSR
+  /// format: The matches of the row at position _begin + k are
+  /// _matches[(*_offsets)[k]] to _matches[(*_offsets)[k + 1]].
+  void gather_matches(const size_t _peripheral_ix, const size_t _begin,
+                      const size_t _end, std::vector<size_t>* _offsets,
+                      std::vector<containers::Match>* _matches) const;
+
+  /// The number of matches of the row at position _pos over all peripheral
+  /// tables. If the matches are not cached, this returns an upper bound
+  /// based on the join keys only.
+  size_t num_matches(const size_t _pos) const;
+
+  /// Returns the sorted and unique ix_input over all rows for the peripheral
+  /// table signified by _peripheral_ix.
+  std::shared_ptr<std::vector<size_t>> unique_inputs(
+      const size_t _peripheral_ix) const;
+
+ public:
+  /// The memory budget used when nothing else is specified: None at all, if
+  /// the engine is memory-mapped (signified by _temp_dir), so the matches are
+  /// spilled right away. Otherwise, an eighth of the physical memory.
+  static size_t default_memory_budget(
+      const std::optional<std::string>& _temp_dir);
+
+  /// Whether the matches are actually cached.
+  bool is_cached() const { return csr_.size() > 0; }
+
+  /// Whether the matches have been spilled into a memory-mapped pool.
+  bool is_memory_mapped() const { return pool_ != nullptr; }
+
+  /// The number of peripheral tables.
+  size_t num_peripheral() const {
+    return table_holder().peripheral_tables().size();
+  }
+
+  /// Trivial (const) accessor.
+  const std::vector<size_t>& rownums() const { return *rownums_; }
+
+  /// Trivial (const) accessor.
+  const std::shared_ptr<const std::vector<size_t>>& rownums_ptr() const {
+    return rownums_;
+  }
+
+  /// Trivial (const) accessor.
+  const TableHolder& table_holder() const { return *table_holder_; }
+
+ private:
+  /// Appends the matches of a block of rows, given in CSR format, to _csr.
+  static void append(const std::vector<size_t>& _offsets,
+                     const std::vector<containers::Match>& _matches,
+                     CSR* _csr);
+
+  /// Generates the CSR structures, if they fit into the budget.
+  std::vector<CSR> make_csr(const size_t _memory_budget,
+                            const std::optional<std::string>& _temp_dir);
+
+  /// Calculates the matches for a single row and peripheral table.
+  void make_matches(const size_t _peripheral_ix, const size_t _pos,
+                    std::vector<containers::Match>* _matches) const;
+
+  /// Calculates the matches for the rows at positions _begin to _end and a
+  /// single peripheral table in CSR format.
+  void make_matches(const size_t _peripheral_ix, const size_t _begin,
+                    const size_t _end, std::vector<size_t>* _offsets,
+                    std::vector<containers::Match>* _matches) const;
+
+  /// Moves the matches gathered so far into a memory-mapped pool in
+  /// _temp_dir.
+  void spill(const std::string& _temp_dir, std::vector<CSR>* _csr);
+
+  /// Returns a pointer to the beginning of the matches.
+  static const containers::Match* data(const MatchesVariant& _matches);
+
+  /// Returns a pointer to the beginning of the matches.
+  static containers::Match* data(MatchesVariant* _matches);
+
+ private:
+  /// The rows in the population table.
+  const std::shared_ptr<const std::vector<size_t>> rownums_;
+
+  /// The table holder used to calculate the matches.
+  const std::shared_ptr<const TableHolder> table_holder_;
+
+  /// The memory-mapped pool, if the matches have been spilled.
+  std::shared_ptr<memmap::Pool> pool_;
+
+  /// One CSR structure for every peripheral table, empty if the matches are
+  /// not cached.
+  const std::vector<CSR> csr_;
+};
+
+}  // namespace algorithm
+}  // namespace fastprop
+
+#endif  // FASTPROP_ALGORITHM_MATCHCACHE_HPP_
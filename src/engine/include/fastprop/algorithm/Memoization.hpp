@@ -20,7 +20,52 @@
 namespace fastprop {
 namespace algorithm {
 
+/// Caches the values the aggregations are applied to, so that abstract
+/// features that only differ in their aggregation do not need to extract
+/// the same values over and over again. There are several slots, so this
+/// works even if the features are not adjacent to each other. The slots are
+/// invalidated by reset(), but their memory is kept, so it can be reused
+/// for the next row.
+///
+/// Every slot also provides a sorted copy of the values and some partial
+/// statistics, which are calculated lazily and shared by all aggregations
+/// that need them.
 class Memoization {
+ public:
+  /// The maximum number of slots for each kind of range.
+  static constexpr size_t max_slots = 16;
+
+  /// Partial statistics on the values in a slot.
+  struct Stats {
+    /// The number of values.
+    Float count_ = 0.0;
+
+    /// The sum of all values.
+    Float sum_ = 0.0;
+  };
+
+  /// A slot containing one range.
+  template <class T>
+  struct Slot {
+    /// Abstract description of the feature which has been cached.
+    std::optional<containers::AbstractFeature> abstract_feature_;
+
+    /// The cached values.
+    std::vector<T> values_;
+
+    /// The values in ascending order, if they have been sorted.
+    std::vector<T> sorted_;
+
+    /// Whether sorted_ is up-to-date.
+    bool is_sorted_ = false;
+
+    /// The statistics on values_, if they have been calculated.
+    std::optional<Stats> stats_;
+
+    /// The variance of values_, if it has been calculated.
+    std::optional<Float> var_;
+  };
+
  public:
   Memoization() = default;
 
@@ -31,61 +76,114 @@ class Memoization {
   template <class RangeType>
   void memorize_numerical(const containers::AbstractFeature& _abstract_feature,
                           RangeType _range) {
-    if (is_same(abstract_feature_numerical_, _abstract_feature)) {
+    auto& slot = find_slot(_abstract_feature, &numerical_, &numerical_ix_,
+                           &numerical_next_);
+    if (slot.abstract_feature_) {
       return;
     }
-    if constexpr (std::ranges::sized_range<RangeType>) {
-      numerical_.resize(std::ranges::size(_range));
-      std::copy(_range.begin(), _range.end(), numerical_.begin());
-    } else {
-      numerical_.clear();
-      std::copy(_range.begin(), _range.end(), std::back_inserter(numerical_));
-    }
-    abstract_feature_numerical_.emplace(_abstract_feature);
+    copy_range(_range, &slot.values_);
+    slot.abstract_feature_.emplace(_abstract_feature);
   }
 
   /// Memorizes the range, if necessary.
   template <class RangeType>
   void memorize_pairs(const containers::AbstractFeature& _abstract_feature,
                       RangeType _range) {
-    if (is_same(abstract_feature_pairs_, _abstract_feature)) {
+    auto& slot =
+        find_slot(_abstract_feature, &pairs_, &pairs_ix_, &pairs_next_);
+    if (slot.abstract_feature_) {
       return;
     }
-    if constexpr (std::ranges::sized_range<RangeType>) {
-      pairs_.resize(std::ranges::size(_range));
-      std::copy(_range.begin(), _range.end(), pairs_.begin());
-    } else {
-      pairs_.clear();
-      std::copy(_range.begin(), _range.end(), std::back_inserter(pairs_));
-    }
-    abstract_feature_pairs_.emplace(_abstract_feature);
+    copy_range(_range, &slot.values_);
+    slot.abstract_feature_.emplace(_abstract_feature);
   }
 
   /// Pointer to the beginning of the cached data
-  const Float* numerical_begin() const { return numerical_.data(); }
+  const Float* numerical_begin() const {
+    return numerical_[numerical_ix_].values_.data();
+  }
 
   /// Pointer to the end of the cached data
   const Float* numerical_end() const {
-    return numerical_.data() + numerical_.size();
+    return numerical_begin() + numerical_[numerical_ix_].values_.size();
   }
 
   /// Pointer to the beginning of the cached data
-  const std::pair<Float, Float>* pairs_begin() const { return pairs_.data(); }
+  const std::pair<Float, Float>* pairs_begin() const {
+    return pairs_[pairs_ix_].values_.data();
+  }
 
   /// Pointer to the end of the cached data
   const std::pair<Float, Float>* pairs_end() const {
-    return pairs_.data() + pairs_.size();
+    return pairs_begin() + pairs_[pairs_ix_].values_.size();
   }
 
-  /// Resets the abstract features
-  void reset() {
-    abstract_feature_numerical_.reset();
-    abstract_feature_pairs_.reset();
-  }
+  /// Invalidates all slots, but keeps the memory.
+  void reset();
+
+  /// The cached numerical data in ascending order. The values are sorted
+  /// at most once per row, no matter how many aggregations require them.
+  const std::vector<Float>& sorted_numerical();
+
+  /// The statistics on the cached numerical data.
+  Stats stats_numerical();
+
+  /// The variance of the cached numerical data.
+  Float var_numerical();
 
  private:
-  /// TODO: Better logic for the conditions
-  /// Whether we have already cached a similar abstract feature.
+  /// Copies the range into _values.
+  template <class RangeType, class T>
+  static void copy_range(RangeType _range, std::vector<T>* _values) {
+    if constexpr (std::ranges::sized_range<RangeType>) {
+      _values->resize(std::ranges::size(_range));
+      std::copy(_range.begin(), _range.end(), _values->begin());
+    } else {
+      _values->clear();
+      std::copy(_range.begin(), _range.end(), std::back_inserter(*_values));
+    }
+  }
+
+  /// Finds the slot containing a similar abstract feature and sets *_ix to
+  /// it. If there is no such slot, an invalid slot is returned, which must
+  /// be filled by the caller.
+  template <class T>
+  Slot<T>& find_slot(const containers::AbstractFeature& _abstract_feature,
+                     std::vector<Slot<T>>* _slots, size_t* _ix,
+                     size_t* _next) {
+    for (size_t i = 0; i < _slots->size(); ++i) {
+      if (is_same((*_slots)[i].abstract_feature_, _abstract_feature)) {
+        *_ix = i;
+        return (*_slots)[i];
+      }
+    }
+
+    const auto is_free = [](const Slot<T>& _slot) {
+      return !_slot.abstract_feature_;
+    };
+
+    const auto it = std::ranges::find_if(*_slots, is_free);
+
+    if (it != _slots->end()) {
+      *_ix = static_cast<size_t>(it - _slots->begin());
+    } else if (_slots->size() < max_slots) {
+      *_ix = _slots->size();
+      _slots->emplace_back();
+    } else {
+      *_ix = *_next;
+      *_next = (*_next + 1) % max_slots;
+    }
+
+    auto& slot = (*_slots)[*_ix];
+    slot.abstract_feature_.reset();
+    slot.is_sorted_ = false;
+    slot.stats_.reset();
+    slot.var_.reset();
+    return slot;
+  }
+
+  /// Whether we have already cached a similar abstract feature. Features
+  /// are similar, if they only differ in their aggregation.
   bool is_same(const std::optional<containers::AbstractFeature>& _af1,
                const containers::AbstractFeature& _af2) const {
     if (!_af1) {
@@ -114,18 +212,24 @@ class Memoization {
   }
 
  private:
-  /// Abstract descriptions of the feature which has been cached.
-  std::optional<containers::AbstractFeature> abstract_feature_numerical_;
+  /// The slots for the numerical data.
+  std::vector<Slot<Float>> numerical_;
+
+  /// The slot most recently memorized or retrieved.
+  size_t numerical_ix_ = 0;
+
+  /// The slot to be evicted next, once all slots are in use.
+  size_t numerical_next_ = 0;
 
-  /// Abstract descriptions of the feature which has been cached.
-  std::optional<containers::AbstractFeature> abstract_feature_pairs_;
+  /// The slots for the data for aggregations that rely on time stamps as
+  /// well.
+  std::vector<Slot<std::pair<Float, Float>>> pairs_;
 
-  /// The cached numerical.
-  std::vector<Float> numerical_;
+  /// The slot most recently memorized or retrieved.
+  size_t pairs_ix_ = 0;
 
-  /// The cached data for aggregations that rely on
-  /// time stamps as well
-  std::vector<std::pair<Float, Float>> pairs_;
+  /// The slot to be evicted next, once all slots are in use.
+  size_t pairs_next_ = 0;
 };
 
 // ------------------------------------------------------------------------
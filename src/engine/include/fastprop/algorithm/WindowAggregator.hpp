@@ -0,0 +1,93 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef FASTPROP_ALGORITHM_WINDOWAGGREGATOR_HPP_
+#define FASTPROP_ALGORITHM_WINDOWAGGREGATOR_HPP_
+
+#include "fastprop/Float.hpp"
+#include "fastprop/algorithm/CompiledConditions.hpp"
+#include "fastprop/algorithm/MatchCache.hpp"
+#include "fastprop/containers/AbstractFeature.hpp"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace fastprop {
+namespace algorithm {
+
+/// Evaluates a single abstract feature over a block of rows by sliding a
+/// window over the peripheral table. When the peripheral table has a
+/// ts_index_, the matches of every row are a contiguous range of the rows
+/// sorted by join key and time stamp. If the rows in the block are sorted
+/// by these ranges as well, consecutive ranges mostly overlap, so the
+/// aggregation can be updated by adding the rows entering the window and
+/// removing the rows leaving it, instead of being recalculated from scratch.
+///
+/// This pays off for populations that contain many rows for the same join
+/// key at different points in time, which is typical for time series. Only
+/// a subset of the abstract features is supported, see is_supported(...).
+class WindowAggregator {
+ public:
+  /// Scratch memory that is reused between calls. Every thread needs its own
+  /// workspace.
+  struct Workspace {
+    /// The match cache the windows have been calculated for.
+    const MatchCache* match_cache_ = nullptr;
+
+    /// The position of the first row in the block.
+    size_t begin_ = 0;
+
+    /// The position of the first row after the block.
+    size_t end_ = 0;
+
+    /// Whether windows_ and order_ are up-to-date, one per peripheral table.
+    std::vector<bool> is_valid_;
+
+    /// The window of every row in the block as positions in the
+    /// row_indices() of the ts_index_, one vector per peripheral table.
+    std::vector<std::vector<std::pair<size_t, size_t>>> windows_;
+
+    /// The rows in the block, sorted by their windows, one vector per
+    /// peripheral table.
+    std::vector<std::vector<size_t>> order_;
+
+    /// Used for MIN and MAX: The positions of the values that might still
+    /// become the extremum of the window, as a monotonic queue.
+    std::vector<size_t> queue_;
+  };
+
+ public:
+  /// Applies the aggregation defined in _abstract_feature to the rows at
+  /// positions _begin to _end in _match_cache, taking into account only the
+  /// matches that fulfill _conditions. The result for the k-th row is
+  /// written into _out[k * _stride].
+  static void apply_aggregation(
+      const MatchCache& _match_cache,
+      const containers::AbstractFeature& _abstract_feature,
+      const CompiledConditions& _conditions, const size_t _begin,
+      const size_t _end, Workspace* _workspace, Float* _out,
+      const size_t _stride);
+
+  /// Whether _abstract_feature can be evaluated by the WindowAggregator.
+  static bool is_supported(const MatchCache& _match_cache,
+                           const containers::AbstractFeature& _abstract_feature,
+                           const CompiledConditions& _conditions);
+
+ private:
+  /// Calculates the windows for all rows in the block and sorts them, unless
+  /// this has already been done.
+  static void make_windows(const MatchCache& _match_cache,
+                           const size_t _peripheral_ix, const size_t _begin,
+                           const size_t _end, Workspace* _workspace);
+};
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
+
+#endif  // FASTPROP_ALGORITHM_WINDOWAGGREGATOR_HPP_
@@ -0,0 +1,609 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef HELPERS_CSRINDEX_HPP_
+#define HELPERS_CSRINDEX_HPP_
+
+#include "debug/assert_true.hpp"
+#include "memmap/Index.hpp"
+#include "memmap/Pool.hpp"
+#include "memmap/Vector.hpp"
+#include "multithreading/ThreadPool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace helpers {
+
+/// Maps keys to the row numbers containing them. The frozen part of the index
+/// is stored in compressed sparse row (CSR) format: The distinct keys, the
+/// offsets of their rows and a single array containing all row numbers, so
+/// the rows belonging to a key are contiguous. The keys are looked up in an
+/// open-addressing hash table using linear probing.
+///
+/// Rows appended after the index has been frozen go into a delta buffer. The
+/// delta buffer contains the complete row numbers of every key it has seen,
+/// including the frozen ones, so that find(...) always returns a contiguous
+/// range. Once the delta buffer grows too large compared to the frozen part,
+/// both are merged into a new frozen part.
+///
+/// If _memory_mapped is true, the arrays live in a memmap::Pool and the delta
+/// buffer is a memmap::Index. Otherwise, everything lives in memory. The
+/// rebuilt arrays are written into the pool directly, so only bookkeeping
+/// proportional to the number of keys and new pairs is kept on the heap.
+template <class T, class Hash, bool _memory_mapped>
+class CSRIndex {
+  template <class U>
+  using VectorType =
+      std::conditional_t<_memory_mapped, memmap::Vector<U>, std::vector<U>>;
+
+  using DeltaType =
+      std::conditional_t<_memory_mapped, memmap::Index<T>,
+                         std::unordered_map<T, std::vector<size_t>, Hash>>;
+
+ public:
+  /// The frozen part is rebuilt once the delta buffer contains more than
+  /// 1 / MAX_DELTA_RATIO as many row numbers as the frozen part.
+  static constexpr size_t MAX_DELTA_RATIO = 4;
+
+  /// Signifies an empty slot in the hash table. All other slots contain the
+  /// position of the key in keys_ plus one.
+  static constexpr size_t EMPTY_SLOT = 0;
+
+  /// Rebuilding indices with fewer keys and pairs than this is not worth
+  /// parallelizing.
+  static constexpr size_t MIN_PARALLEL_SIZE = 100000;
+
+ private:
+  /// The part of the keys processed by a single thread during a rebuild.
+  struct Partition {
+    /// The distinct keys of this partition, beginning with the existing
+    /// ones.
+    std::vector<T> keys_;
+
+    /// The number of distinct existing keys.
+    size_t num_existing_ = 0;
+
+    /// The number of rownums for each of the keys_.
+    std::vector<size_t> counts_;
+
+    /// The positions of the new pairs belonging to this partition are
+    /// stored in pair_pos[pairs_begin_] to pair_pos[pairs_end_].
+    size_t pairs_begin_ = 0;
+
+    size_t pairs_end_ = 0;
+
+    /// The position of the key of each new pair in keys_.
+    std::vector<size_t> pair_ix_;
+
+    /// Where the keys of this partition begin in the rebuilt keys_.
+    size_t keys_begin_ = 0;
+
+    /// Where the rownums of this partition begin in the rebuilt rownums_.
+    size_t rownums_begin_ = 0;
+
+    /// The total number of rownums in this partition.
+    size_t rownums_size_ = 0;
+  };
+
+ public:
+  explicit CSRIndex(const std::shared_ptr<memmap::Pool>& _pool)
+      : delta_(make_delta(_pool)),
+        delta_size_(0),
+        keys_(make_vector<T>(_pool, {})),
+        num_rownums_(0),
+        offsets_(make_vector<size_t>(_pool, {0})),
+        pool_(_pool),
+        rownums_(make_vector<size_t>(_pool, {})),
+        shift_(0),
+        slots_(make_vector<size_t>(_pool, {})) {
+    assert_true(!_memory_mapped || pool_);
+  }
+
+  CSRIndex(CSRIndex&& _other) noexcept = default;
+
+  CSRIndex(const CSRIndex& _other) = delete;
+
+  ~CSRIndex() = default;
+
+ public:
+  /// Adds the key-rownum-pairs to the index. The row numbers must be greater
+  /// than all row numbers already contained in the index and sorted.
+  void append(const std::vector<std::pair<T, size_t>>& _pairs);
+
+  /// Removes all keys from the index.
+  void clear() { *this = CSRIndex(pool_); }
+
+  /// Returns a pointer to the beginning and end of the rownums, or two
+  /// nullptrs, if the key is not found.
+  std::pair<const size_t*, const size_t*> find(const T _key) const;
+
+  /// Move assignment operator.
+  CSRIndex& operator=(CSRIndex&& _other) noexcept = default;
+
+  /// Copy assignment operator.
+  CSRIndex& operator=(const CSRIndex& _other) = delete;
+
+  /// The number of row numbers contained in the index.
+  size_t size() const { return num_rownums_; }
+
+ private:
+  /// Determines the distinct keys of the partition _p and counts their
+  /// rownums.
+  void count(const std::vector<std::pair<T, size_t>>& _pairs,
+             const std::vector<size_t>& _pair_pos, const size_t _p,
+             const size_t _num_partitions, Partition* _partition) const;
+
+  /// Finds the rownums of _key in the delta buffer.
+  std::pair<const size_t*, const size_t*> find_in_delta(const T _key) const;
+
+  /// Finds the rownums of _key in the frozen part.
+  std::pair<const size_t*, const size_t*> find_in_frozen(const T _key) const;
+
+  /// Adds a single key-rownum-pair to the delta buffer.
+  void insert_into_delta(const T _key, const size_t _rownum);
+
+  /// Merges the frozen part, the delta buffer and _pairs into a new frozen
+  /// part and clears the delta buffer. For large indices, the keys are
+  /// partitioned by their hash and the partitions are processed in parallel.
+  void rebuild(const std::vector<std::pair<T, size_t>>& _pairs);
+
+  /// Writes the keys, offsets and rownums of _partition into the rebuilt
+  /// arrays.
+  void scatter(const std::vector<std::pair<T, size_t>>& _pairs,
+               const std::vector<size_t>& _pair_pos,
+               const Partition& _partition, VectorType<T>* _keys,
+               VectorType<size_t>* _offsets,
+               VectorType<size_t>* _rownums) const;
+
+ private:
+  /// The first slot to probe for _key.
+  size_t hash(const T _key) const {
+    // Fibonacci hashing spreads keys that are close to each other, like
+    // encoded join keys, over the entire table.
+    const auto h = static_cast<std::uint64_t>(Hash()(_key));
+    return static_cast<size_t>((h * 0x9E3779B97F4A7C15ULL) >> shift_);
+  }
+
+  /// The partition _key belongs to during a rebuild.
+  static size_t get_partition(const T _key, const size_t _num_partitions) {
+    const auto h = static_cast<std::uint64_t>(Hash()(_key));
+    return static_cast<size_t>((h * 0x9E3779B97F4A7C15ULL) >> 32) %
+           _num_partitions;
+  }
+
+  /// Generates an empty delta buffer.
+  static DeltaType make_delta(const std::shared_ptr<memmap::Pool>& _pool) {
+    if constexpr (_memory_mapped) {
+      return DeltaType(_pool);
+    } else {
+      return DeltaType();
+    }
+  }
+
+  /// Copies _vec into the storage used by this index.
+  template <class U>
+  static VectorType<U> make_vector(const std::shared_ptr<memmap::Pool>& _pool,
+                                   std::vector<U> _vec) {
+    if constexpr (_memory_mapped) {
+      return VectorType<U>(_pool, _vec.begin(), _vec.end());
+    } else {
+      return _vec;
+    }
+  }
+
+  /// Generates _size copies of _val in the storage used by this index.
+  template <class U>
+  static VectorType<U> make_vector(const std::shared_ptr<memmap::Pool>& _pool,
+                                   const size_t _size, const U _val) {
+    if constexpr (_memory_mapped) {
+      auto vec = VectorType<U>(_pool);
+      vec.reserve(_size);
+      for (size_t i = 0; i < _size; ++i) {
+        vec.push_back(_val);
+      }
+      return vec;
+    } else {
+      return std::vector<U>(_size, _val);
+    }
+  }
+
+ private:
+  /// Contains the complete rownums for all keys that have been appended
+  /// since the last rebuild.
+  DeltaType delta_;
+
+  /// The keys contained in delta_, in the order they were first seen.
+  std::vector<T> delta_keys_;
+
+  /// The number of rownums contained in delta_.
+  size_t delta_size_;
+
+  /// The distinct keys of the frozen part.
+  VectorType<T> keys_;
+
+  /// The number of rownums appended so far. The delta buffer also contains
+  /// copies of frozen rownums, so this is not rownums_.size() + delta_size_.
+  size_t num_rownums_;
+
+  /// The rownums of keys_[i] are rownums_[offsets_[i]] to
+  /// rownums_[offsets_[i + 1]].
+  VectorType<size_t> offsets_;
+
+  /// The pool used for the memory-mapped storage, nullptr otherwise.
+  std::shared_ptr<memmap::Pool> pool_;
+
+  /// The rownums of the frozen part, grouped by key and sorted within each
+  /// key.
+  VectorType<size_t> rownums_;
+
+  /// The number of bits by which the hash is shifted to find the first slot.
+  size_t shift_;
+
+  /// The hash table over keys_, the size is always a power of two.
+  VectorType<size_t> slots_;
+};
+
+// -------------------------------------------------------------------------
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+void CSRIndex<T, Hash, _memory_mapped>::append(
+    const std::vector<std::pair<T, size_t>>& _pairs) {
+  if (_pairs.size() == 0) {
+    return;
+  }
+
+  num_rownums_ += _pairs.size();
+
+  if ((delta_size_ + _pairs.size()) * MAX_DELTA_RATIO >= rownums_.size()) {
+    rebuild(_pairs);
+    return;
+  }
+
+  for (const auto& [key, rownum] : _pairs) {
+    insert_into_delta(key, rownum);
+  }
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+std::pair<const size_t*, const size_t*>
+CSRIndex<T, Hash, _memory_mapped>::find(const T _key) const {
+  if (delta_size_ > 0) {
+    const auto range = find_in_delta(_key);
+    if (range.first) {
+      return range;
+    }
+  }
+  return find_in_frozen(_key);
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+std::pair<const size_t*, const size_t*>
+CSRIndex<T, Hash, _memory_mapped>::find_in_delta(const T _key) const {
+  if constexpr (_memory_mapped) {
+    const auto opt = delta_[_key];
+
+    if (!opt) {
+      return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
+    }
+
+    const auto begin = opt->data();
+
+    return std::make_pair(begin, begin + opt->size());
+  } else {
+    const auto it = delta_.find(_key);
+
+    if (it == delta_.end()) {
+      return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
+    }
+
+    return std::make_pair(it->second.data(),
+                          it->second.data() + it->second.size());
+  }
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+std::pair<const size_t*, const size_t*>
+CSRIndex<T, Hash, _memory_mapped>::find_in_frozen(const T _key) const {
+  if (slots_.size() == 0) {
+    return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
+  }
+
+  const auto mask = slots_.size() - 1;
+
+  const auto slots = slots_.data();
+
+  const auto keys = keys_.data();
+
+  // The load factor is at most 0.5, so there always is an empty slot.
+  for (auto s = hash(_key);; s = (s + 1) & mask) {
+    const auto k = slots[s];
+
+    if (k == EMPTY_SLOT) {
+      return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
+    }
+
+    if (keys[k - 1] == _key) {
+      const auto offsets = offsets_.data();
+      return std::make_pair(rownums_.data() + offsets[k - 1],
+                            rownums_.data() + offsets[k]);
+    }
+  }
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+void CSRIndex<T, Hash, _memory_mapped>::insert_into_delta(
+    const T _key, const size_t _rownum) {
+  const bool is_new = find_in_delta(_key).first == nullptr;
+
+  // The frozen rownums are copied first, because inserting into a
+  // memory-mapped delta buffer might invalidate the pointers.
+  auto frozen = std::vector<size_t>();
+
+  if (is_new) {
+    const auto [begin, end] = find_in_frozen(_key);
+    frozen.assign(begin, end);
+  }
+
+  if (is_new) {
+    delta_keys_.push_back(_key);
+    delta_size_ += frozen.size();
+  }
+
+  if constexpr (_memory_mapped) {
+    for (const auto rownum : frozen) {
+      delta_.insert(_key, rownum);
+    }
+    delta_.insert(_key, _rownum);
+  } else {
+    auto& rownums = delta_[_key];
+    rownums.insert(rownums.end(), frozen.begin(), frozen.end());
+    rownums.push_back(_rownum);
+  }
+
+  ++delta_size_;
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+void CSRIndex<T, Hash, _memory_mapped>::rebuild(
+    const std::vector<std::pair<T, size_t>>& _pairs) {
+  auto& thread_pool = multithreading::ThreadPool::get();
+
+  const auto num_partitions =
+      keys_.size() + delta_keys_.size() + _pairs.size() < MIN_PARALLEL_SIZE
+          ? static_cast<size_t>(1)
+          : thread_pool.num_threads();
+
+  // The keys are split into partitions by their hash, so every partition
+  // can be counted and scattered by its own thread.
+  const auto get_partition = [num_partitions](const T _key) -> size_t {
+    return CSRIndex::get_partition(_key, num_partitions);
+  };
+
+  auto partitions = std::vector<Partition>(num_partitions);
+
+  // Sorts the positions of the pairs by partition, so that the positions
+  // within a partition remain sorted and so do the rownums.
+  auto chunk_counts = std::vector<std::vector<size_t>>(
+      num_partitions, std::vector<size_t>(num_partitions));
+
+  const auto chunk_begin = [&_pairs, num_partitions](const size_t _chunk) {
+    return _chunk * _pairs.size() / num_partitions;
+  };
+
+  const auto count_chunk = [&](const size_t _chunk) {
+    for (auto i = chunk_begin(_chunk); i < chunk_begin(_chunk + 1); ++i) {
+      ++chunk_counts[_chunk][get_partition(_pairs[i].first)];
+    }
+  };
+
+  thread_pool.parallel_for(num_partitions, count_chunk);
+
+  auto pair_pos = std::vector<size_t>(_pairs.size());
+
+  size_t next_pos = 0;
+
+  for (size_t p = 0; p < num_partitions; ++p) {
+    partitions[p].pairs_begin_ = next_pos;
+    for (size_t c = 0; c < num_partitions; ++c) {
+      const auto count = chunk_counts[c][p];
+      chunk_counts[c][p] = next_pos;
+      next_pos += count;
+    }
+    partitions[p].pairs_end_ = next_pos;
+  }
+
+  const auto scatter_chunk = [&](const size_t _chunk) {
+    auto& next = chunk_counts[_chunk];
+    for (auto i = chunk_begin(_chunk); i < chunk_begin(_chunk + 1); ++i) {
+      pair_pos[next[get_partition(_pairs[i].first)]++] = i;
+    }
+  };
+
+  thread_pool.parallel_for(num_partitions, scatter_chunk);
+
+  const auto count_partition = [this, &_pairs, &pair_pos, &partitions,
+                                num_partitions](const size_t _p) {
+    count(_pairs, pair_pos, _p, num_partitions, &partitions[_p]);
+  };
+
+  thread_pool.parallel_for(num_partitions, count_partition);
+
+  size_t num_keys = 0;
+
+  size_t num_rownums = 0;
+
+  for (auto& partition : partitions) {
+    partition.keys_begin_ = num_keys;
+    partition.rownums_begin_ = num_rownums;
+    num_keys += partition.keys_.size();
+    num_rownums += partition.rownums_size_;
+  }
+
+  auto keys = make_vector<T>(pool_, num_keys, T());
+
+  auto offsets = make_vector<size_t>(pool_, num_keys + 1, num_rownums);
+
+  auto rownums = make_vector<size_t>(pool_, num_rownums, 0);
+
+  const auto scatter_partition = [&](const size_t _p) {
+    scatter(_pairs, pair_pos, partitions[_p], &keys, &offsets, &rownums);
+  };
+
+  thread_pool.parallel_for(num_partitions, scatter_partition);
+
+  size_t num_slots = 2;
+
+  shift_ = 63;
+
+  while (num_slots < 2 * keys.size()) {
+    num_slots *= 2;
+    --shift_;
+  }
+
+  auto slots = make_vector<size_t>(pool_, num_slots, EMPTY_SLOT);
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto s = hash(keys[i]);
+    while (slots[s] != EMPTY_SLOT) {
+      s = (s + 1) & (num_slots - 1);
+    }
+    slots[s] = i + 1;
+  }
+
+  delta_ = make_delta(pool_);
+
+  delta_keys_.clear();
+
+  delta_size_ = 0;
+
+  keys_ = std::move(keys);
+
+  offsets_ = std::move(offsets);
+
+  rownums_ = std::move(rownums);
+
+  slots_ = std::move(slots);
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+void CSRIndex<T, Hash, _memory_mapped>::count(
+    const std::vector<std::pair<T, size_t>>& _pairs,
+    const std::vector<size_t>& _pair_pos, const size_t _p,
+    const size_t _num_partitions, Partition* _partition) const {
+  auto& keys = _partition->keys_;
+
+  auto& counts = _partition->counts_;
+
+  auto key_ix = std::unordered_map<T, size_t, Hash>();
+
+  const auto get_ix = [&keys, &counts, &key_ix](const T _key) -> size_t {
+    const auto [it, inserted] = key_ix.try_emplace(_key, keys.size());
+    if (inserted) {
+      keys.push_back(_key);
+      counts.push_back(0);
+    }
+    return it->second;
+  };
+
+  // Every key that is already contained in the index, followed by the keys
+  // only contained in the delta buffer. Keys contained in both are visited
+  // twice, but find(...) returns the same range both times.
+  const auto add_existing = [this, _p, _num_partitions, &counts,
+                             &get_ix](const T _key) {
+    if (get_partition(_key, _num_partitions) != _p) {
+      return;
+    }
+    const auto [begin, end] = find(_key);
+    counts.at(get_ix(_key)) = static_cast<size_t>(end - begin);
+  };
+
+  for (size_t i = 0; i < keys_.size(); ++i) {
+    add_existing(keys_[i]);
+  }
+
+  for (const auto key : delta_keys_) {
+    add_existing(key);
+  }
+
+  _partition->num_existing_ = keys.size();
+
+  auto& pair_ix = _partition->pair_ix_;
+
+  pair_ix.resize(_partition->pairs_end_ - _partition->pairs_begin_);
+
+  for (size_t i = 0; i < pair_ix.size(); ++i) {
+    const auto& key = _pairs[_pair_pos[_partition->pairs_begin_ + i]].first;
+    pair_ix[i] = get_ix(key);
+    ++counts[pair_ix[i]];
+  }
+
+  _partition->rownums_size_ =
+      std::accumulate(counts.begin(), counts.end(), static_cast<size_t>(0));
+}
+
+// -------------------------------------------------------------------------
+
+template <class T, class Hash, bool _memory_mapped>
+void CSRIndex<T, Hash, _memory_mapped>::scatter(
+    const std::vector<std::pair<T, size_t>>& _pairs,
+    const std::vector<size_t>& _pair_pos, const Partition& _partition,
+    VectorType<T>* _keys, VectorType<size_t>* _offsets,
+    VectorType<size_t>* _rownums) const {
+  const auto& keys = _partition.keys_;
+
+  const auto& counts = _partition.counts_;
+
+  auto next = std::vector<size_t>(keys.size());
+
+  auto offset = _partition.rownums_begin_;
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    (*_keys)[_partition.keys_begin_ + i] = keys[i];
+    (*_offsets)[_partition.keys_begin_ + i] = offset;
+    next[i] = offset;
+    offset += counts[i];
+  }
+
+  const auto rownums = _rownums->data();
+
+  for (size_t i = 0; i < _partition.num_existing_; ++i) {
+    const auto [begin, end] = find(keys[i]);
+    next[i] = std::copy(begin, end, rownums + next[i]) - rownums;
+  }
+
+  for (size_t i = 0; i < _partition.pair_ix_.size(); ++i) {
+    const auto pos = _pair_pos[_partition.pairs_begin_ + i];
+    rownums[next[_partition.pair_ix_[i]]++] = _pairs[pos].second;
+  }
+}
+
+// -------------------------------------------------------------------------
+
+}  // namespace helpers
+
+#endif  // HELPERS_CSRINDEX_HPP_
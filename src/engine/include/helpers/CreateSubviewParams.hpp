@@ -48,6 +48,10 @@ struct CreateSubviewParams {
   /// Index returning rows for each word.
   const RowIndices row_indices_ = {};
 
+  /// The directory for memory-mapped data. If this is set, the time series
+  /// index is memory-mapped as well.
+  const std::optional<std::string> temp_dir_ = std::nullopt;
+
   /// The name of the lower time stamp.
   const std::string time_stamp_ = "";
 
@@ -8,15 +8,14 @@
 #ifndef HELPERS_INMEMORYINDEX_HPP_
 #define HELPERS_INMEMORYINDEX_HPP_
 
+#include "helpers/CSRIndex.hpp"
 #include "helpers/Int.hpp"
 
-#include <cstddef>
-#include <unordered_map>
-#include <vector>
+#include <functional>
 
 namespace helpers {
 
-using InMemoryIndex = std::unordered_map<Int, std::vector<size_t>>;
+using InMemoryIndex = CSRIndex<Int, std::hash<Int>, false>;
 
 }  // namespace helpers
 
@@ -11,8 +11,12 @@
 #include "helpers/DataFrame.hpp"
 #include "helpers/Float.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
+#include <numeric>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace helpers {
@@ -34,6 +38,37 @@ class Matchmaker {
                            const MakeMatchType _make_match,
                            std::vector<MatchType>* _matches);
 
+  /// Identifies the matches for an entire block of samples in the
+  /// population table at once and writes them into _matches in CSR format:
+  /// The matches of _ix_outputs[k] are _matches[(*_offsets)[k]] to
+  /// _matches[(*_offsets)[k + 1]]. Both buffers are overwritten, but their
+  /// memory is reused, so there are no allocations once they are warmed up.
+  ///
+  /// The samples are processed in the order of their join keys and time
+  /// stamps, so the peripheral rows for a join key are only looked up once
+  /// and the lookups in the ts_index_ traverse it from left to right.
+  static void make_matches(const PopulationType& _population,
+                           const DataFrame& _peripheral,
+                           const std::span<const size_t> _ix_outputs,
+                           const MakeMatchType _make_match,
+                           std::vector<size_t>* _offsets,
+                           std::vector<MatchType>* _matches);
+
+ private:
+  /// Whether a peripheral row is in range for the linear method.
+  static bool is_in_range(const DataFrame& _peripheral, const size_t _ix_input,
+                          const Float _time_stamp_out) {
+    const auto lower = _peripheral.time_stamp(_ix_input);
+    const auto upper = _peripheral.upper_time_stamp(_ix_input);
+    return lower <= _time_stamp_out &&
+           (std::isnan(upper) || upper > _time_stamp_out);
+  }
+
+  /// Sorts the positions in _ix_outputs by join key and time stamp.
+  static std::vector<size_t> sort_by_keys(
+      const PopulationType& _population,
+      const std::span<const size_t> _ix_outputs);
+
  private:
   /// If we don't have a ts_index, we need to go through the matches one by one
   /// and see whether they are in range.
@@ -123,17 +158,115 @@ void Matchmaker<PopulationType, MatchType, MakeMatchType>::
   for (auto it = begin; it != end; ++it) {
     const auto ix_input = *it;
 
-    const auto lower = _peripheral.time_stamp(ix_input);
+    if (is_in_range(_peripheral, ix_input, _time_stamp_out)) {
+      _matches->push_back(_make_match(ix_input, _ix_output));
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
 
-    const auto upper = _peripheral.upper_time_stamp(ix_input);
+template <class PopulationType, class MatchType, class MakeMatchType>
+void Matchmaker<PopulationType, MatchType, MakeMatchType>::make_matches(
+    const PopulationType& _population, const DataFrame& _peripheral,
+    const std::span<const size_t> _ix_outputs, const MakeMatchType _make_match,
+    std::vector<size_t>* _offsets, std::vector<MatchType>* _matches) {
+  const auto order = sort_by_keys(_population, _ix_outputs);
 
-    const bool match_in_range = lower <= _time_stamp_out &&
-                                (std::isnan(upper) || upper > _time_stamp_out);
+  auto& offsets = *_offsets;
 
-    if (match_in_range) {
-      _matches->push_back(_make_match(ix_input, _ix_output));
+  offsets.assign(_ix_outputs.size() + 1, 0);
+
+  // The candidates are the rows in the peripheral table with the same join
+  // key. When there is a ts_index_, they are taken from its row indices and
+  // are already restricted to the time window. Otherwise they still need to
+  // be checked one by one.
+  using Candidates = std::pair<const size_t*, const size_t*>;
+
+  const auto row_indices = _peripheral.ts_index_
+                               ? _peripheral.ts_index_->row_indices().begin()
+                               : static_cast<const size_t*>(nullptr);
+
+  const auto for_each_sample = [&](const auto& _f) {
+    auto join_key = Int();
+    auto candidates = Candidates(nullptr, nullptr);
+    for (size_t i = 0; i < order.size(); ++i) {
+      const auto k = order[i];
+      const auto ix_output = _ix_outputs[k];
+      const auto jk = _population.join_key(ix_output);
+      const auto ts = _population.time_stamp(ix_output);
+      if (i == 0 || jk != join_key) {
+        join_key = jk;
+        candidates = _peripheral.find(jk);
+      }
+      if (candidates.first != candidates.second && row_indices) {
+        const auto [begin, end] = _peripheral.ts_index_->find_ix_range(jk, ts);
+        _f(k, ix_output, Candidates(row_indices + begin, row_indices + end),
+           ts, false);
+      } else {
+        _f(k, ix_output, candidates, ts, true);
+      }
     }
-  }
+  };
+
+  const auto count = [&](const size_t _k, const size_t, const Candidates _c,
+                         const Float _ts, const bool _check) {
+    const auto in_range = [&_peripheral, _ts](const size_t _ix) {
+      return is_in_range(_peripheral, _ix, _ts);
+    };
+    offsets[_k + 1] =
+        _check ? static_cast<size_t>(std::count_if(_c.first, _c.second,
+                                                   in_range))
+               : static_cast<size_t>(_c.second - _c.first);
+  };
+
+  for_each_sample(count);
+
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  _matches->resize(offsets.back());
+
+  const auto fill = [&](const size_t _k, const size_t _ix_output,
+                        const Candidates _c, const Float _ts,
+                        const bool _check) {
+    auto out = _matches->begin() + offsets[_k];
+    for (auto it = _c.first; it != _c.second; ++it) {
+      if (!_check || is_in_range(_peripheral, *it, _ts)) {
+        *(out++) = _make_match(*it, _ix_output);
+      }
+    }
+    assert_true(out == _matches->begin() + offsets[_k + 1]);
+  };
+
+  for_each_sample(fill);
+}
+
+// ----------------------------------------------------------------------------
+
+template <class PopulationType, class MatchType, class MakeMatchType>
+std::vector<size_t>
+Matchmaker<PopulationType, MatchType, MakeMatchType>::sort_by_keys(
+    const PopulationType& _population,
+    const std::span<const size_t> _ix_outputs) {
+  auto order = std::vector<size_t>(_ix_outputs.size());
+
+  std::iota(order.begin(), order.end(), 0);
+
+  const auto by_keys = [&_population, _ix_outputs](const size_t _i,
+                                                   const size_t _j) {
+    const auto jk_i = _population.join_key(_ix_outputs[_i]);
+    const auto jk_j = _population.join_key(_ix_outputs[_j]);
+    if (jk_i != jk_j) {
+      return jk_i < jk_j;
+    }
+    const auto ts_i = _population.time_stamp(_ix_outputs[_i]);
+    const auto ts_j = _population.time_stamp(_ix_outputs[_j]);
+    return ts_i < ts_j || (!std::isnan(ts_i) && std::isnan(ts_j));
+  };
+
+  std::ranges::sort(order, by_keys);
+
+  return order;
 }
 
 // ----------------------------------------------------------------------------
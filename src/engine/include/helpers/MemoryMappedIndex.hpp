@@ -8,12 +8,14 @@
 #ifndef HELPERS_MEMORYMAPPEDINDEX_HPP_
 #define HELPERS_MEMORYMAPPEDINDEX_HPP_
 
+#include "helpers/CSRIndex.hpp"
 #include "helpers/Int.hpp"
-#include "memmap/Index.hpp"
+
+#include <functional>
 
 namespace helpers {
 
-using MemoryMappedIndex = memmap::Index<Int>;
+using MemoryMappedIndex = CSRIndex<Int, std::hash<Int>, true>;
 
 }  // namespace helpers
 
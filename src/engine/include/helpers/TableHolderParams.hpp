@@ -15,6 +15,7 @@
 #include "helpers/WordIndexContainer.hpp"
 
 #include <functional>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,10 @@ struct TableHolderParams {
   /// Maps words to rows.
   const std::optional<RowIndexContainer> row_index_container_ = std::nullopt;
 
+  /// The directory for memory-mapped data. If this is set, the time series
+  /// indices are memory-mapped as well.
+  const std::optional<std::string> temp_dir_ = std::nullopt;
+
   /// Maps rows to words.
   const std::optional<WordIndexContainer> word_index_container_ = std::nullopt;
 };
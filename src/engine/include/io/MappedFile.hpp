@@ -0,0 +1,49 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef IO_MAPPEDFILE_HPP_
+#define IO_MAPPEDFILE_HPP_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace io {
+
+/// A file that is mapped into memory read-only, so it can be read by several
+/// threads at once without any copies.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& _fname);
+
+  MappedFile(const MappedFile& _other) = delete;
+
+  ~MappedFile();
+
+ public:
+  /// The entire content of the file.
+  std::string_view content() const { return std::string_view(data_, size_); }
+
+  /// Copy assignment operator.
+  MappedFile& operator=(const MappedFile& _other) = delete;
+
+  /// Tells the operating system that the pages covering the _size bytes
+  /// beginning at _begin are no longer needed. They are read from the file
+  /// again, if they are accessed after that.
+  void release(const size_t _begin, const size_t _size) const;
+
+ private:
+  /// The beginning of the mapped memory, nullptr for empty files.
+  const char* data_;
+
+  /// The size of the file in bytes.
+  size_t size_;
+};
+
+}  // namespace io
+
+#endif  // IO_MAPPEDFILE_HPP_
@@ -0,0 +1,87 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef IO_PARALLELCSVREADER_HPP_
+#define IO_PARALLELCSVREADER_HPP_
+
+#include "io/MappedFile.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace io {
+
+/// Reads the same files as the CSVReader, but maps them into memory and
+/// splits them into chunks of complete lines, which can be parsed by
+/// different threads. Just like in the CSVReader, every line is a record
+/// and quotes cannot span several lines, so a chunk can end at any line
+/// break. Fields are returned as string views pointing directly into the
+/// file, unless they contain quotes.
+class ParallelCSVReader {
+ public:
+  ParallelCSVReader(const std::optional<std::vector<std::string>>& _colnames,
+                    const std::string& _fname, const size_t _limit,
+                    const char _quotechar, const char _sep);
+
+  ~ParallelCSVReader() = default;
+
+ public:
+  /// Colnames are either passed by the user or they are the first line of the
+  /// CSV file.
+  const std::vector<std::string>& colnames() const { return colnames_; }
+
+  /// Skips the first _skip lines and splits the remaining lines (up to the
+  /// limit) into chunks of roughly _chunk_size bytes.
+  std::vector<std::string_view> make_chunks(const size_t _skip,
+                                            const size_t _chunk_size) const;
+
+  /// The number of bytes following the header.
+  size_t size() const { return data_.size(); }
+
+  /// Returns the first line of *_chunk, without the line break, and removes
+  /// it from *_chunk.
+  static std::string_view pop_line(std::string_view* _chunk);
+
+  /// Splits _line into _fields using the same rules as the CSVReader. Fields
+  /// that contain quotes are unquoted into _buffer, so the fields are only
+  /// valid until _buffer is modified.
+  void split_line(const std::string_view _line,
+                  std::vector<std::string_view>* _fields,
+                  std::string* _buffer) const;
+
+ private:
+  /// Removes whitespace from the beginning and end of _field, like
+  /// Parser::trim(...).
+  static std::string_view trim(const std::string_view _field);
+
+ private:
+  /// Colnames are either passed by the user or they are the first line of the
+  /// CSV file.
+  std::vector<std::string> colnames_;
+
+  /// The file content following the header.
+  std::string_view data_;
+
+  /// The mapped CSV source file.
+  const MappedFile file_;
+
+  /// The maximum number of lines following the header, if any.
+  std::optional<size_t> max_lines_;
+
+  /// The character used for quotes.
+  const char quotechar_;
+
+  /// The character used for separating fields.
+  const char sep_;
+};
+
+}  // namespace io
+
+#endif  // IO_PARALLELCSVREADER_HPP_
@@ -10,10 +10,10 @@
 
 #include "io/Float.hpp"
 #include "io/Int.hpp"
+#include "io/TimeStampParser.hpp"
 
 #include <Poco/DateTimeFormat.h>
 #include <Poco/DateTimeFormatter.h>
-#include <Poco/DateTimeParser.h>
 #include <Poco/Timestamp.h>
 
 #include <algorithm>
@@ -146,31 +146,11 @@ class Parser {
 
   // -------------------------------
 
-  /// Transforms a string to a time stamp.
+  /// Transforms a string to a time stamp. When parsing many values, construct
+  /// a TimeStampParser once instead, so the formats are only compiled once.
   static std::pair<Float, bool> to_time_stamp(
       const std::string& _str, const std::vector<std::string>& _time_formats) {
-    const auto trimmed = trim(_str);
-
-    int utc = Poco::DateTimeFormatter::UTC;
-
-    for (const auto& fmt : _time_formats) {
-      Poco::DateTime date_time;
-
-      const auto success =
-          Poco::DateTimeParser::tryParse(fmt, trimmed, date_time, utc);
-
-      const auto time_stamp = date_time.timestamp();
-
-      if (!success ||
-          Poco::DateTimeFormatter::format(time_stamp, fmt) != trimmed) {
-        continue;
-      }
-
-      return std::pair<Float, bool>(
-          static_cast<Float>(time_stamp.epochMicroseconds()) / 1.0e6, true);
-    }
-
-    return std::pair<Float, bool>(0.0, false);
+    return TimeStampParser(_time_formats).parse(_str);
   }
 
   // -------------------------------
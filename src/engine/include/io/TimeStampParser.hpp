@@ -0,0 +1,111 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef IO_TIMESTAMPPARSER_HPP_
+#define IO_TIMESTAMPPARSER_HPP_
+
+#include "io/Float.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace io {
+
+/// Transforms strings to time stamps using a list of time formats in Poco's
+/// notation. The formats are compiled once: Formats that only consist of
+/// fixed-width numeric fields (%Y, %m, %d, %H, %M, %S, %s, %F, %i), the time
+/// zone designators %z and %Z and literals are matched directly, all other
+/// formats fall back to Poco::DateTimeParser. Either way, a string only
+/// matches a format, if formatting the time stamp reproduces it exactly.
+class TimeStampParser {
+  /// The numeric fields of a compiled format.
+  enum class Field : std::uint8_t {
+    year,
+    month,
+    day,
+    hour,
+    minute,
+    second,
+    fraction
+  };
+
+  /// A numeric field and its position in the string.
+  struct Token {
+    Field field_;
+    size_t begin_;
+    size_t width_;
+  };
+
+  /// A time format, compiled if possible.
+  struct Format {
+    /// The time format in Poco's notation.
+    std::string fmt_;
+
+    /// Whether the format could be compiled. If not, we use Poco.
+    bool is_compiled_;
+
+    /// Whether no preceding format can match the same strings, which means
+    /// that the format can be tried first without changing the result.
+    bool is_exclusive_;
+
+    /// The literals expected at every position, '\0' marks digits.
+    std::string shape_;
+
+    /// The numeric fields.
+    std::vector<Token> tokens_;
+  };
+
+ public:
+  explicit TimeStampParser(const std::vector<std::string>& _time_formats);
+
+  TimeStampParser(const TimeStampParser& _other);
+
+  ~TimeStampParser() = default;
+
+ public:
+  /// Transforms a string to a time stamp, returning the number of seconds
+  /// since epoch and whether any of the formats matched. Leading and trailing
+  /// whitespace is ignored. The first format that matches is used, but the
+  /// format that matched the last string is tried first, whenever that
+  /// cannot change the result. Can be called concurrently.
+  std::pair<Float, bool> parse(const std::string_view _str) const;
+
+ private:
+  /// Compiles a time format.
+  static Format compile(const std::string& _fmt);
+
+  /// Whether there can be strings that match both formats.
+  static bool may_overlap(const Format& _f1, const Format& _f2);
+
+  /// Parses a trimmed string using a single format.
+  static std::pair<Float, bool> parse(const Format& _format,
+                                      const std::string_view _trimmed);
+
+  /// Parses a trimmed string using a compiled format.
+  static std::pair<Float, bool> parse_compiled(const Format& _format,
+                                               const std::string_view _trimmed);
+
+  /// Parses a trimmed string using Poco.
+  static std::pair<Float, bool> parse_with_poco(
+      const std::string& _fmt, const std::string_view _trimmed);
+
+ private:
+  /// The compiled formats, in the order they were passed.
+  std::vector<Format> formats_;
+
+  /// The index of the format that matched the last string.
+  mutable std::atomic<size_t> last_match_;
+};
+
+}  // namespace io
+
+#endif  // IO_TIMESTAMPPARSER_HPP_
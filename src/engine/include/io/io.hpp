@@ -14,9 +14,12 @@
 #include "io/Datatype.hpp"
 #include "io/Float.hpp"
 #include "io/Int.hpp"
+#include "io/MappedFile.hpp"
+#include "io/ParallelCSVReader.hpp"
 #include "io/Parser.hpp"
 #include "io/Reader.hpp"
 #include "io/Sniffer.hpp"
 #include "io/StatementMaker.hpp"
+#include "io/TimeStampParser.hpp"
 
 #endif  // IO_IO_HPP_
@@ -15,9 +15,11 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 namespace memmap {
 
@@ -44,6 +46,12 @@ class BTree {
   ~BTree() { deallocate(); }
 
  public:
+  /// Builds the tree bottom-up from key-value-pairs sorted by their keys,
+  /// which must be unique. This is much faster than inserting the pairs one
+  /// by one, because there are no node splits and every node is written
+  /// exactly once. The tree must be empty.
+  void bulk_load(const std::vector<std::pair<KeyType, ValueType>> &_pairs);
+
   /// Inserts a new key-value-pair into the tree
   void insert(const KeyType _key, const ValueType _value);
 
@@ -86,6 +94,24 @@ class BTree {
   std::optional<ValueType> get_value(
       const KeyType _key, const BTreeNode<KeyType, ValueType> &_node) const;
 
+  /// Builds the leaves for bulk_load(...). The pairs between two
+  /// neighbouring leaves are written into _separators.
+  void make_leaves(const std::vector<KeyValuePair> &_pairs,
+                   std::vector<BTreeNode<KeyType, ValueType>> *_leaves,
+                   std::vector<KeyValuePair> *_separators) const;
+
+  /// Builds the next level of the tree for bulk_load(...). _separators[i]
+  /// is the pair between _nodes[i] and _nodes[i + 1]. Both are replaced by
+  /// the parent nodes and the pairs between them.
+  void make_parents(std::vector<BTreeNode<KeyType, ValueType>> *_nodes,
+                    std::vector<KeyValuePair> *_separators) const;
+
+  /// Splits _num_pairs into as few nodes containing at most order_ pairs as
+  /// possible, with one pair between every two nodes that goes into the
+  /// level above. Returns the number of pairs in each node. The nodes are as
+  /// evenly sized as possible.
+  std::vector<size_t> plan_nodes(const size_t _num_pairs) const;
+
   /// Inserts a new child node pair into a node,
   /// assuming we already now that it is the correct node
   /// and the desired position and have already added the corresponding
@@ -179,15 +205,45 @@ BTreeNode<KeyType, ValueType> BTree<KeyType, ValueType>::allocate_new_node(
 // ----------------------------------------------------------------------------
 
 template <class KeyType, class ValueType>
-size_t BTree<KeyType, ValueType>::find_pos(
-    const KeyType _key, const VectorImpl<KeyType> &_keys) const {
-  for (size_t i = 0; i < _keys.size(); ++i) {
-    if (_keys[i] >= _key) {
-      return i;
-    }
+void BTree<KeyType, ValueType>::bulk_load(
+    const std::vector<std::pair<KeyType, ValueType>> &_pairs) {
+  assert_true(size() == 0);
+
+  assert_true(std::adjacent_find(_pairs.begin(), _pairs.end(),
+                                 [](const auto &_p1, const auto &_p2) {
+                                   return _p1.first >= _p2.first;
+                                 }) == _pairs.end());
+
+  if (_pairs.size() == 0) {
+    return;
+  }
+
+  auto nodes = std::vector<BTreeNode<KeyType, ValueType>>();
+
+  auto separators = std::vector<KeyValuePair>();
+
+  make_leaves(_pairs, &nodes, &separators);
+
+  while (nodes.size() > 1) {
+    make_parents(&nodes, &separators);
   }
 
-  return _keys.size();
+  assert_true(separators.size() == 0);
+
+  deallocate();
+
+  root_ = nodes.at(0);
+}
+
+// ----------------------------------------------------------------------------
+
+template <class KeyType, class ValueType>
+size_t BTree<KeyType, ValueType>::find_pos(
+    const KeyType _key, const VectorImpl<KeyType> &_keys) const {
+  // The keys of a node fill about one page, so a binary search touches far
+  // fewer cache lines than a linear scan.
+  return static_cast<size_t>(
+      std::lower_bound(_keys.begin(), _keys.end(), _key) - _keys.begin());
 }
 
 // ----------------------------------------------------------------------------
@@ -378,13 +434,114 @@ void BTree<KeyType, ValueType>::insert_values(
 template <class KeyType, class ValueType>
 Vector<KeyType> BTree<KeyType, ValueType>::keys() const {
   assert_true(pool_);
-  auto vec = Vector<KeyType>(std::make_shared<memmap::Pool>(pool_->temp_dir()));
+  auto vec = Vector<KeyType>(
+      std::make_shared<memmap::Pool>(pool_->temp_dir(), pool_->options()));
   insert_keys(root_, &vec);
   return vec;
 }
 
 // ----------------------------------------------------------------------------
 
+template <class KeyType, class ValueType>
+void BTree<KeyType, ValueType>::make_leaves(
+    const std::vector<KeyValuePair> &_pairs,
+    std::vector<BTreeNode<KeyType, ValueType>> *_leaves,
+    std::vector<KeyValuePair> *_separators) const {
+  const auto sizes = plan_nodes(_pairs.size());
+
+  _leaves->clear();
+
+  _separators->clear();
+
+  auto begin = _pairs.begin();
+
+  for (const auto size : sizes) {
+    if (_leaves->size() != 0) {
+      _separators->push_back(*(begin++));
+    }
+
+    auto keys = Vector<KeyType>(pool_);
+
+    auto values = Vector<ValueType>(pool_);
+
+    keys.reserve(size);
+
+    values.reserve(size);
+
+    for (auto it = begin; it != begin + size; ++it) {
+      keys.push_back(it->first);
+      values.push_back(it->second);
+    }
+
+    _leaves->push_back(
+        BTreeNode<KeyType, ValueType>{.child_nodes_ = {},
+                                      .keys_ = keys.yield_impl(),
+                                      .values_ = values.yield_impl()});
+
+    begin += size;
+  }
+
+  assert_true(begin == _pairs.end());
+}
+
+// ----------------------------------------------------------------------------
+
+template <class KeyType, class ValueType>
+void BTree<KeyType, ValueType>::make_parents(
+    std::vector<BTreeNode<KeyType, ValueType>> *_nodes,
+    std::vector<KeyValuePair> *_separators) const {
+  assert_true(_nodes->size() == _separators->size() + 1);
+
+  const auto sizes = plan_nodes(_separators->size());
+
+  auto parents = std::vector<BTreeNode<KeyType, ValueType>>();
+
+  auto separators = std::vector<KeyValuePair>();
+
+  size_t pos = 0;
+
+  for (const auto size : sizes) {
+    if (parents.size() != 0) {
+      separators.push_back(_separators->at(pos++));
+    }
+
+    auto child_nodes = Vector<BTreeNode<KeyType, ValueType>>(pool_);
+
+    auto keys = Vector<KeyType>(pool_);
+
+    auto values = Vector<ValueType>(pool_);
+
+    child_nodes.reserve(size + 1);
+
+    keys.reserve(size);
+
+    values.reserve(size);
+
+    for (size_t i = pos; i < pos + size; ++i) {
+      child_nodes.push_back(_nodes->at(i));
+      keys.push_back(_separators->at(i).first);
+      values.push_back(_separators->at(i).second);
+    }
+
+    child_nodes.push_back(_nodes->at(pos + size));
+
+    parents.push_back(
+        BTreeNode<KeyType, ValueType>{.child_nodes_ = child_nodes.yield_impl(),
+                                      .keys_ = keys.yield_impl(),
+                                      .values_ = values.yield_impl()});
+
+    pos += size;
+  }
+
+  assert_true(pos == _separators->size());
+
+  *_nodes = std::move(parents);
+
+  *_separators = std::move(separators);
+}
+
+// ----------------------------------------------------------------------------
+
 template <class KeyType, class ValueType>
 void BTree<KeyType, ValueType>::move(BTree<KeyType, ValueType> *_other) {
   root_ = _other->root_.yield_ressources();
@@ -407,25 +564,42 @@ std::optional<ValueType> BTree<KeyType, ValueType>::get_value(
   assert_true(_node.is_leaf() ||
               _node.keys_.size() + 1 == _node.child_nodes_.size());
 
-  for (size_t i = 0; i < _node.keys_.size(); ++i) {
-    if (_node.keys_[i] == _key) {
-      return _node.values_[i];
-    }
-
-    if (_node.keys_[i] > _key) {
-      if (_node.is_leaf()) {
-        return std::nullopt;
-      }
+  const auto pos = find_pos(_key, _node.keys_);
 
-      return get_value(_key, _node.child_nodes_[i]);
-    }
+  if (pos < _node.keys_.size() && _node.keys_[pos] == _key) {
+    return _node.values_[pos];
   }
 
   if (_node.is_leaf()) {
     return std::nullopt;
   }
 
-  return get_value(_key, _node.child_nodes_[_node.keys_.size()]);
+  return get_value(_key, _node.child_nodes_[pos]);
+}
+
+// ----------------------------------------------------------------------------
+
+template <class KeyType, class ValueType>
+std::vector<size_t> BTree<KeyType, ValueType>::plan_nodes(
+    const size_t _num_pairs) const {
+  assert_true(_num_pairs > 0);
+
+  // Every node but the last is followed by a pair, so n nodes can hold
+  // n * order_ + n - 1 pairs.
+  const auto num_nodes = (_num_pairs + 1 + order_) / (order_ + 1);
+
+  const auto num_in_nodes = _num_pairs - (num_nodes - 1);
+
+  auto sizes = std::vector<size_t>(num_nodes, num_in_nodes / num_nodes);
+
+  for (size_t i = 0; i < num_in_nodes % num_nodes; ++i) {
+    ++sizes[i];
+  }
+
+  assert_true(sizes.back() > 0);
+  assert_true(sizes.front() <= order_);
+
+  return sizes;
 }
 
 // ----------------------------------------------------------------------------
@@ -545,8 +719,8 @@ BTree<KeyType, ValueType>::split_node_make_greater(
 template <class KeyType, class ValueType>
 Vector<ValueType> BTree<KeyType, ValueType>::values() const {
   assert_true(pool_);
-  auto vec =
-      Vector<ValueType>(std::make_shared<memmap::Pool>(pool_->temp_dir()));
+  auto vec = Vector<ValueType>(
+      std::make_shared<memmap::Pool>(pool_->temp_dir(), pool_->options()));
   insert_values(root_, &vec);
   return vec;
 }
@@ -11,7 +11,9 @@
 #include "debug/assert_true.hpp"
 #include "memmap/FreeBlocksTracker.hpp"
 #include "memmap/Page.hpp"
+#include "memmap/PoolOptions.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
 #include <string>
@@ -23,7 +25,8 @@ class Pool {
   constexpr static size_t NOT_ALLOCATED = std::numeric_limits<size_t>::max();
 
  public:
-  explicit Pool(const std::string &_temp_dir);
+  explicit Pool(const std::string &_temp_dir,
+                const PoolOptions &_options = PoolOptions());
 
   /// Move constructor
   Pool(Pool &&_other) noexcept = delete;
@@ -73,12 +76,18 @@ class Pool {
   /// Copy assignment operator.
   Pool &operator=(const Pool &_other) = delete;
 
+  /// The number of pages currently allocated to a block.
+  size_t num_allocated_pages() const { return num_allocated_pages_; }
+
   /// The number of bytes currently in the pool.
   size_t num_bytes() const { return page_size_ * num_pages_; }
 
   /// The number of pages currently in the pool.
   size_t num_pages() const { return num_pages_; }
 
+  /// Trivial (const) accessor
+  const PoolOptions &options() const { return options_; }
+
   /// The size of a single page.
   size_t page_size() const { return page_size_; }
 
@@ -92,6 +101,9 @@ class Pool {
   /// Allocates the first page in the block.
   void allocate_page(const size_t _block_size, const size_t _page_num);
 
+  /// Passes the expected access pattern on to the kernel.
+  void advise(const size_t _num_pages) const;
+
   /// Make sure that enough space is left on the machine.
   void check_space_left(const size_t _num_bytes) const;
 
@@ -102,6 +114,17 @@ class Pool {
   bool current_block_can_be_extended(const size_t _num_pages,
                                      const size_t _current_page) const;
 
+  /// Whether all pages after the block beginning with _current_page are
+  /// free, so the block can be extended once the pool is resized.
+  bool current_block_is_at_end(const size_t _current_page) const;
+
+  /// The number of pages we resize the pool to, if we need at least
+  /// _min_num_pages. The pool grows geometrically, so the number of resizes
+  /// is logarithmic in its final size.
+  size_t grow_to(const size_t _min_num_pages) const {
+    return std::max(num_pages_ * 2, _min_num_pages);
+  }
+
   /// Initializes the pages (RAII does not work for memory mapping,
   /// so we need to do this manually).
   void init_pages(const size_t _first_new_page, const size_t _last_new_page);
@@ -114,7 +137,13 @@ class Pool {
   void move_data_to_new_block(const size_t _old_page_num,
                               const size_t _new_page_num);
 
-  /// Remaps the memory pages after a file has been resized.
+  /// Convenience wrapper around mremap.
+  char *memremap(char *_addr, const size_t _old_length,
+                 const size_t _new_length) const;
+
+  /// Remaps the memory pages after a file has been resized. The existing
+  /// mappings are extended (and moved, if necessary) by the kernel, so the
+  /// pages already in memory are neither written back nor read again.
   void remap(const size_t _num_pages);
 
   /// Removes a file (either for the raw data or the pages).
@@ -126,7 +155,7 @@ class Pool {
   /// Resizes the entire pool.
   void resize_pool(const size_t _num_pages);
 
-  /// Unmaps the memory pages, so the pool can be resized.
+  /// Unmaps the memory pages.
   void unmap();
 
  private:
@@ -142,9 +171,15 @@ class Pool {
   /// Helps us find free blocks more quickly
   FreeBlocksTracker free_blocks_tracker_;
 
-  /// The number of pages currently allocated.
+  /// The number of pages currently allocated to a block.
+  size_t num_allocated_pages_;
+
+  /// The number of pages currently in the pool.
   size_t num_pages_;
 
+  /// The options passed by the user.
+  const PoolOptions options_;
+
   /// The size of a single page, in bytes.
   const size_t page_size_;
 
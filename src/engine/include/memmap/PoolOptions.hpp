@@ -0,0 +1,29 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef MEMMAP_POOLOPTIONS_HPP_
+#define MEMMAP_POOLOPTIONS_HPP_
+
+#include <string>
+
+namespace memmap {
+
+struct PoolOptions {
+  /// The access pattern we expect, passed on to madvise. Either "normal",
+  /// "random" or "sequential".
+  std::string advice_ = "normal";
+
+  /// Whether we ask the kernel to back the pool with transparent huge pages.
+  /// This only has an effect if the temporary directory is on a file system
+  /// supporting them, such as tmpfs.
+  bool huge_pages_ = false;
+};
+
+// ----------------------------------------------------------------------------
+}  // namespace memmap
+
+#endif  // MEMMAP_POOLOPTIONS_HPP_
@@ -12,6 +12,7 @@
 #include "memmap/VectorImpl.hpp"
 
 #include <cstddef>
+#include <iterator>
 #include <memory>
 
 namespace memmap {
@@ -38,6 +39,9 @@ class Vector {
   Vector(const std::shared_ptr<Pool> &_pool, IteratorType _begin,
          IteratorType _end)
       : Vector(_pool) {
+    if constexpr (std::random_access_iterator<IteratorType>) {
+      reserve(static_cast<size_t>(_end - _begin));
+    }
     for (auto it = _begin; it != _end; ++it) {
       push_back(*it);
     }
@@ -45,6 +49,7 @@ class Vector {
 
   Vector(const std::shared_ptr<Pool> &_pool, const size_t _size)
       : Vector(_pool) {
+    reserve(_size);
     for (size_t i = 0; i < _size; ++i) {
       push_back(T());
     }
@@ -126,6 +131,14 @@ class Vector {
   /// Adds a new element on the back of the Vector.
   void push_back(const T _val) { impl_.push_back(_val); }
 
+  /// Makes sure that the vector can hold at least _capacity elements without
+  /// being reallocated.
+  void reserve(const size_t _capacity) {
+    if (_capacity > capacity()) {
+      allocate(_capacity);
+    }
+  }
+
   /// The size of the vector.
   size_t size() const { return impl_.size(); }
 
@@ -13,6 +13,7 @@
 #include "memmap/Index.hpp"
 #include "memmap/Page.hpp"
 #include "memmap/Pool.hpp"
+#include "memmap/PoolOptions.hpp"
 #include "memmap/StringVector.hpp"
 #include "memmap/Vector.hpp"
 #include "memmap/VectorImpl.hpp"
@@ -0,0 +1,44 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef MULTITHREADING_CANCELLATIONTOKEN_HPP_
+#define MULTITHREADING_CANCELLATIONTOKEN_HPP_
+
+#include <atomic>
+
+namespace multithreading {
+// ----------------------------------------------------------------------------
+
+/// Signals to tasks running on the ThreadPool that they should stop. Tasks
+/// that have not been started yet will not be started at all.
+class CancellationToken {
+ public:
+  CancellationToken() : cancelled_(false) {}
+
+  ~CancellationToken() = default;
+
+  // -------------------------------
+
+  /// Requests cancellation.
+  void cancel() { cancelled_.store(true, std::memory_order_release); }
+
+  /// Whether cancellation has been requested.
+  bool is_cancelled() const {
+    return cancelled_.load(std::memory_order_acquire);
+  }
+
+  // -------------------------------
+
+ private:
+  /// Whether cancellation has been requested.
+  std::atomic<bool> cancelled_;
+};
+
+// ----------------------------------------------------------------------------
+}  // namespace multithreading
+
+#endif  // MULTITHREADING_CANCELLATIONTOKEN_HPP_
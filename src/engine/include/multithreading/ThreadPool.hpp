@@ -0,0 +1,176 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef MULTITHREADING_THREADPOOL_HPP_
+#define MULTITHREADING_THREADPOOL_HPP_
+
+#include "multithreading/CancellationToken.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace multithreading {
+// ----------------------------------------------------------------------------
+
+/// A persistent pool of worker threads shared by the entire engine. The
+/// engine-wide pool is created once in main.cpp and can be retrieved using
+/// ThreadPool::get().
+class ThreadPool {
+ public:
+  /// Aggregated timings over all tasks the pool has executed.
+  struct Stats {
+    /// The number of worker threads.
+    size_t num_threads_;
+
+    /// The number of tasks executed so far.
+    size_t num_tasks_;
+
+    /// The number of tasks currently waiting in the queue.
+    size_t num_queued_;
+
+    /// The total time spent executing tasks.
+    std::chrono::nanoseconds busy_time_;
+
+    /// The time the longest task took.
+    std::chrono::nanoseconds max_task_time_;
+
+    /// The total time tasks spent waiting in the queue.
+    std::chrono::nanoseconds wait_time_;
+  };
+
+ private:
+  /// A task waiting in the queue.
+  struct Task {
+    /// The actual work.
+    std::function<void()> f_;
+
+    /// When the task was added to the queue.
+    std::chrono::steady_clock::time_point enqueued_;
+  };
+
+ public:
+  /// When _num_threads is 0, we use the hardware concurrency.
+  explicit ThreadPool(const size_t _num_threads);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // -------------------------------
+
+  /// Returns the engine-wide pool. If init(...) has never been called, a pool
+  /// using the hardware concurrency is created.
+  static ThreadPool& get();
+
+  /// Sets the engine-wide pool - called once in main.cpp.
+  static void init(const std::shared_ptr<ThreadPool>& _pool);
+
+  /// Calls _f(0), ..., _f(_num_tasks - 1) in parallel. The calling thread
+  /// participates, so parallel_for(...) can safely be nested. Rethrows the
+  /// first exception thrown by any of the calls and throws, if _token has
+  /// been cancelled before all calls could be made. When _timings is passed,
+  /// the time each call took is written into it.
+  void parallel_for(
+      const size_t _num_tasks, const std::function<void(size_t)>& _f,
+      const std::shared_ptr<const CancellationToken>& _token = nullptr,
+      std::vector<std::chrono::nanoseconds>* _timings = nullptr);
+
+  /// Returns the timings aggregated over all tasks.
+  Stats stats() const;
+
+  // -------------------------------
+
+  /// Trivial accessor.
+  size_t num_threads() const { return workers_.size(); }
+
+  /// Runs _f on the pool. If _token has been cancelled before _f could be
+  /// started, the future will contain an exception.
+  template <class F>
+  auto submit(F&& _f,
+              const std::shared_ptr<const CancellationToken>& _token = nullptr)
+      -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+  // -------------------------------
+
+ private:
+  /// Adds a new task to the queue.
+  void enqueue(std::function<void()> _f);
+
+  /// The loop executed by each worker.
+  void run_worker();
+
+  // -------------------------------
+
+ private:
+  /// The total time spent executing tasks, in nanoseconds.
+  std::atomic<std::int64_t> busy_time_;
+
+  /// Signals to the workers that there is something new in the queue.
+  std::condition_variable cond_;
+
+  /// The time the longest task took, in nanoseconds.
+  std::atomic<std::int64_t> max_task_time_;
+
+  /// Protects the queue.
+  mutable std::mutex mtx_;
+
+  /// The number of tasks executed so far.
+  std::atomic<size_t> num_tasks_;
+
+  /// The tasks waiting to be executed.
+  std::deque<Task> queue_;
+
+  /// Signals to the workers that they should shut down.
+  bool stopped_;
+
+  /// The total time tasks spent waiting in the queue, in nanoseconds.
+  std::atomic<std::int64_t> wait_time_;
+
+  /// The worker threads.
+  std::vector<std::thread> workers_;
+};
+
+// ----------------------------------------------------------------------------
+
+template <class F>
+auto ThreadPool::submit(F&& _f,
+                        const std::shared_ptr<const CancellationToken>& _token)
+    -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+  using ResultType = std::invoke_result_t<std::decay_t<F>>;
+
+  auto task = std::make_shared<std::packaged_task<ResultType()>>(
+      [f = std::forward<F>(_f), _token]() mutable -> ResultType {
+        if (_token && _token->is_cancelled()) {
+          throw std::runtime_error("Interrupted.");
+        }
+        return f();
+      });
+
+  auto future = task->get_future();
+
+  enqueue([task]() { (*task)(); });
+
+  return future;
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace multithreading
+
+#endif  // MULTITHREADING_THREADPOOL_HPP_
@@ -0,0 +1,107 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef MULTITHREADING_WORKSTEALINGSCHEDULER_HPP_
+#define MULTITHREADING_WORKSTEALINGSCHEDULER_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace multithreading {
+// ----------------------------------------------------------------------------
+
+/// Hands out chunks of rows to a fixed number of threads. Every thread starts
+/// out with a contiguous block of chunks, which it consumes from the front.
+/// Once a thread runs out of chunks, it steals from the back of the other
+/// threads' blocks, so threads that happen to get expensive rows do not hold
+/// up the others.
+class WorkStealingScheduler {
+ public:
+  /// _boundaries must be sorted and start with 0 - chunk i is
+  /// [_boundaries[i], _boundaries[i + 1]).
+  WorkStealingScheduler(const std::shared_ptr<const std::vector<size_t>>&
+                            _boundaries,
+                        const size_t _num_threads);
+
+  ~WorkStealingScheduler() = default;
+
+  WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+  WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+  // -----------------------------------------
+
+  /// Cuts the rows into chunks of roughly equal total weight, such that there
+  /// are about _num_chunks chunks and no chunk contains more than
+  /// _max_chunk_size rows. Returns the chunk boundaries.
+  static std::shared_ptr<const std::vector<size_t>> make_boundaries(
+      const std::vector<size_t>& _weights, const size_t _num_chunks,
+      const size_t _max_chunk_size);
+
+  /// Returns the next chunk of rows for the thread signified by _thread_num,
+  /// or std::nullopt, if there is nothing left to do.
+  std::optional<std::pair<size_t, size_t>> next(const size_t _thread_num);
+
+  // -----------------------------------------
+
+ public:
+  /// The number of chunks.
+  size_t num_chunks() const { return boundaries_->size() - 1; }
+
+  /// The number of threads the chunks are distributed over.
+  size_t num_threads() const { return num_threads_; }
+
+  // -----------------------------------------
+
+ private:
+  /// The chunks still owned by a thread, packed as begin << 32 | end, so
+  /// that owner and thieves can both update them with a single CAS.
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> range_;
+  };
+
+  // -----------------------------------------
+
+ private:
+  /// Packs a range of chunks.
+  static std::uint64_t pack(const std::uint64_t _begin,
+                            const std::uint64_t _end) {
+    return (_begin << 32) | _end;
+  }
+
+  /// Takes a chunk from the front of the slot - used by the owner.
+  std::optional<size_t> pop_front(const size_t _thread_num);
+
+  /// Takes a chunk from the back of the slot - used by thieves.
+  std::optional<size_t> steal_back(const size_t _victim);
+
+  /// Expresses a chunk in terms of rows.
+  std::pair<size_t, size_t> to_rows(const size_t _chunk) const {
+    return std::make_pair((*boundaries_)[_chunk], (*boundaries_)[_chunk + 1]);
+  }
+
+  // -----------------------------------------
+
+ private:
+  /// The chunk boundaries.
+  const std::shared_ptr<const std::vector<size_t>> boundaries_;
+
+  /// The number of threads.
+  const size_t num_threads_;
+
+  /// One slot for every thread.
+  const std::unique_ptr<Slot[]> slots_;
+};
+
+// ----------------------------------------------------------------------------
+}  // namespace multithreading
+
+#endif  // MULTITHREADING_WORKSTEALINGSCHEDULER_HPP_
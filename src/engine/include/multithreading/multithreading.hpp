@@ -8,11 +8,14 @@
 #ifndef MULTITHREADING_HPP_
 #define MULTITHREADING_HPP_
 
+#include "multithreading/CancellationToken.hpp"
 #include "multithreading/Communicator.hpp"
 #include "multithreading/ReadLock.hpp"
 #include "multithreading/ReadWriteLock.hpp"
 #include "multithreading/Reducer.hpp"
+#include "multithreading/ThreadPool.hpp"
 #include "multithreading/WeakWriteLock.hpp"
+#include "multithreading/WorkStealingScheduler.hpp"
 #include "multithreading/WriteLock.hpp"
 #include "multithreading/all_reduce.hpp"
 #include "multithreading/broadcast.hpp"
@@ -9,18 +9,40 @@
 #define STRINGS_STRING_HPP_
 
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
-#include <memory>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace strings {
 
-// String is an implementation of a string class that has
-// no memory overhead over a standard C-string.
+// String is an immutable string class optimized for the large number of
+// short strings contained in text and categorical columns: It stores its
+// size and its hash, keeps strings of up to MAX_INLINE_SIZE characters
+// inline and shares longer strings between copies using a reference-counted
+// heap block. Just like a C-string, the characters are always
+// null-terminated.
 class String {
   static constexpr char nullstr = '\0';
 
+  /// Strings of up to this size do not require a heap allocation.
+  static constexpr size_t MAX_INLINE_SIZE = 15;
+
+  /// Signifies that the string is not set.
+  static constexpr size_t NULL_SIZE = std::numeric_limits<size_t>::max();
+
+  /// Holds the characters of long strings, which directly follow the block.
+  struct Block {
+    char* chars() { return reinterpret_cast<char*>(this + 1); }
+
+    std::atomic<size_t> ref_count_;
+  };
+
  public:
   using ReflectionType = std::string;
 
@@ -39,8 +61,6 @@ class String {
 
   String(const std::string& _str);
 
-  String(const uint64_t _size);
-
   String(const char* _str);
 
   String(const char* _str, const size_t _size);
@@ -49,7 +69,7 @@ class String {
 
   String(String&& _other) noexcept;
 
-  ~String() = default;
+  ~String() { release(); }
 
  public:
   /// Checks whether the string contains another string.
@@ -59,23 +79,24 @@ class String {
 
   /// Returns a pointer to the underlying C-String.
   const char* c_str() const {
-    if (!chars_) {
+    if (size_ <= MAX_INLINE_SIZE) {
+      return data_.inline_;
+    }
+    if (size_ == NULL_SIZE) {
       return &nullstr;
     }
-    return chars_.get();
+    return data_.block_->chars();
   }
 
-  /// Calculates the hash function of this string.
+  /// Returns the hash of this string, which is calculated on construction.
   /// This is useful for std::unordered_map.
-  size_t hash() const {
-    return std::hash<std::string_view>()(std::string_view(c_str(), size()));
-  }
+  size_t hash() const { return hash_; }
 
   /// Needed for parsing.
   std::string reflection() const { return str(); }
 
   /// Whether the string is set.
-  operator bool() const { return (chars_ && true); }
+  operator bool() const { return size_ != NULL_SIZE; }
 
   /// Copy assignment operator.
   String& operator=(const String& _other) {
@@ -87,62 +108,95 @@ class String {
   /// Move assignment operator
   String& operator=(String&& _other) noexcept {
     if (this == &_other) return *this;
-    chars_ = std::move(_other.chars_);
+    release();
+    take(&_other);
     return *this;
   }
 
-  /// Equal to operator
+  /// Equal to operator. Strings of different sizes or hashes can be told
+  /// apart without looking at the characters.
   bool operator==(const String& _other) const {
-    return (strcmp(c_str(), _other.c_str()) == 0);
+    const auto len = size();
+    return len == _other.size() && hash_ == _other.hash_ &&
+           std::memcmp(c_str(), _other.c_str(), len) == 0;
   }
 
   /// Equal to operator
   bool operator==(const char* _other) const {
-    return (strcmp(c_str(), _other) == 0);
+    const auto len = size();
+    return strlen(_other) == len && std::memcmp(c_str(), _other, len) == 0;
   }
 
   /// Less than operator
   bool operator<(const String& _other) const {
-    return (strcmp(c_str(), _other.c_str()) < 0);
+    return std::string_view(c_str(), size()) <
+           std::string_view(_other.c_str(), _other.size());
   }
 
   /// Returns the size of the underlying string.
-  size_t size() const {
-    if (!chars_) {
-      return 0;
-    }
-    return static_cast<size_t>(strlen(chars_.get()));
-  }
+  size_t size() const { return size_ == NULL_SIZE ? 0 : size_; }
 
   /// Returns a std::string created from the underlying data.
   std::string str() const {
-    if (!chars_) {
+    if (size_ == NULL_SIZE) {
       return "NULL";
     }
-    return std::string(chars_.get());
+    return std::string(c_str(), size_);
   }
 
   /// Returns a lower case version of this string.
   String to_lower() const {
     const auto tolower = [](const char c) { return std::tolower(c); };
-    auto lower = String(*this);
-    std::transform(lower.c_str(), lower.c_str() + lower.size(),
-                   lower.chars_.get(), tolower);
-    return lower;
+    return transform(tolower);
   }
 
   /// Returns a upper case version of this string.
   String to_upper() const {
     const auto toupper = [](const char c) { return std::toupper(c); };
-    auto upper = String(*this);
-    std::transform(upper.c_str(), upper.c_str() + upper.size(),
-                   upper.chars_.get(), toupper);
-    return upper;
+    return transform(toupper);
+  }
+
+ private:
+  /// Allocates the memory for _size characters plus the null terminator and
+  /// returns a pointer to it. The caller must fill it and then call
+  /// finalize().
+  char* allocate(const size_t _size);
+
+  /// Writes the null terminator and calculates the hash.
+  void finalize();
+
+  /// Decrements the reference count of the block, if there is one, and
+  /// deletes it, if this was the last reference.
+  void release() noexcept;
+
+  /// Takes over the data of _other, leaving it NULL.
+  void take(String* _other) noexcept;
+
+  /// Applies _f to every character.
+  template <class F>
+  String transform(const F& _f) const {
+    if (size_ == NULL_SIZE) {
+      return *this;
+    }
+    auto result = String(nullptr);
+    const auto begin = c_str();
+    std::transform(begin, begin + size_, result.allocate(size_), _f);
+    result.finalize();
+    return result;
   }
 
  private:
-  /// The underlying data.
-  std::unique_ptr<char[]> chars_;
+  /// The number of characters or NULL_SIZE, if the string is not set.
+  size_t size_;
+
+  /// The hash of the characters.
+  size_t hash_;
+
+  /// The characters of short strings or the block holding long strings.
+  union {
+    char inline_[MAX_INLINE_SIZE + 1];
+    Block* block_;
+  } data_;
 };
 
 }  // namespace strings
@@ -8,13 +8,14 @@
 #ifndef CONTAINERS_TSINDEX_INMEMORYINDEX_HPP_
 #define CONTAINERS_TSINDEX_INMEMORYINDEX_HPP_
 
+#include "fct/Range.hpp"
 #include "tsindex/Float.hpp"
 #include "tsindex/IndexParams.hpp"
+#include "tsindex/IndexView.hpp"
 #include "tsindex/Int.hpp"
-#include "tsindex/Key.hpp"
 
 #include <cstddef>
-#include <map>
+#include <utility>
 #include <vector>
 
 namespace tsindex {
@@ -30,44 +31,57 @@ class InMemoryIndex {
   /// <= _time_stamp and time_stamp_ + memory_ > _time_stamp.
   fct::Range<const size_t*> find_range(const Int _join_key,
                                        const Float _time_stamp) const {
-    const auto ix_begin = find_ix(_join_key, _time_stamp - memory_);
-    const auto ix_end = find_ix(_join_key, _time_stamp);
+    const auto [ix_begin, ix_end] = find_ix_range(_join_key, _time_stamp);
     return fct::Range<const size_t*>(row_indices_.data() + ix_begin,
                                      row_indices_.data() + ix_end);
   }
 
- private:
-  /// Initializer for the key map.
-  static std::map<Key, size_t> make_key_map(
-      const IndexParams& _params, const std::vector<size_t>& _row_indices);
+  /// Like find_range(...), but returns the positions in row_indices()
+  /// instead. For a fixed join key, both positions are monotonic in
+  /// _time_stamp, which is what sliding-window aggregations rely on.
+  std::pair<size_t, size_t> find_ix_range(const Int _join_key,
+                                          const Float _time_stamp) const {
+    return view().find_ix_range(_join_key, _time_stamp);
+  }
 
-  /// Initializer for the row indices.
-  static std::vector<size_t> make_row_indices(const IndexParams& _params);
+  /// The row numbers, sorted by join key and time stamp.
+  fct::Range<const size_t*> row_indices() const {
+    return fct::Range<const size_t*>(
+        row_indices_.data(), row_indices_.data() + row_indices_.size());
+  }
 
- private:
-  /// Finds the upper bound to the index corresponding to the join_key and
-  /// time_stamp.
-  size_t find_ix(const Int _join_key, const Float _time_stamp) const {
-    const auto key = Key{.join_key_ = _join_key, .time_stamp_ = _time_stamp};
-    const auto it = key_map_.upper_bound(key);
-    return (it == key_map_.end()) ? row_indices_.size() : it->second;
+  /// A view on the flat arrays.
+  IndexView view() const {
+    return IndexView{.join_keys_ = is_dense_ ? nullptr : join_keys_.data(),
+                     .memory_ = memory_,
+                     .num_slots_ = offsets_.size() - 1,
+                     .offsets_ = offsets_.data(),
+                     .row_indices_ = row_indices_.data(),
+                     .time_stamps_ = time_stamps_.data()};
   }
 
  private:
+  /// Whether the join keys can be used as slots directly.
+  bool is_dense_;
+
+  /// The sorted join keys, one per slot (only if the index is not dense).
+  std::vector<Int> join_keys_;
+
   /// The difference between the lower_ts and the upper_ts.
-  const Float memory_;
+  Float memory_;
+
+  /// offsets_[s] to offsets_[s + 1] are the positions of the rows in slot s.
+  std::vector<size_t> offsets_;
 
   /// Row indices signify the order of the rows in the data frame, when sorted
   /// by the keys.
-  const std::vector<size_t> row_indices_;
+  std::vector<size_t> row_indices_;
 
-  /// Maps a key to the first element of row_indices, which is equal to said
-  /// key (not in alphabetical order, because row_indices is created before
-  /// key_map_).
-  const std::map<Key, size_t> key_map_;
+  /// The lower time stamps, in the same order as row_indices_.
+  std::vector<Float> time_stamps_;
 };
 }  // namespace tsindex
 
 // ----------------------------------------------------------------------------
 
-#endif  // CONTAINERS_TSINDEX_INMEMORY_HPP_
+#endif  // CONTAINERS_TSINDEX_INMEMORYINDEX_HPP_
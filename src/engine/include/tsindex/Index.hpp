@@ -11,9 +11,15 @@
 #include "tsindex/Float.hpp"
 #include "tsindex/InMemoryIndex.hpp"
 #include "tsindex/Int.hpp"
+#include "tsindex/MemoryMappedIndex.hpp"
+
+#include <variant>
 
 namespace tsindex {
 class Index {
+ public:
+  typedef std::variant<InMemoryIndex, MemoryMappedIndex> ImplType;
+
  public:
   explicit Index(const IndexParams& _params);
 
@@ -25,12 +31,37 @@ class Index {
   /// <= _time_stamp and time_stamp_ + memory_ > _time_stamp.
   fct::Range<const size_t*> find_range(const Int _join_key,
                                        const Float _time_stamp) const {
-    return impl_.find_range(_join_key, _time_stamp);
+    const auto v = view();
+    const auto [ix_begin, ix_end] = v.find_ix_range(_join_key, _time_stamp);
+    return fct::Range<const size_t*>(v.row_indices_ + ix_begin,
+                                     v.row_indices_ + ix_end);
   }
 
+  /// Like find_range(...), but returns the positions in row_indices()
+  /// instead.
+  std::pair<size_t, size_t> find_ix_range(const Int _join_key,
+                                          const Float _time_stamp) const {
+    return view().find_ix_range(_join_key, _time_stamp);
+  }
+
+  /// The row numbers, sorted by join key and time stamp.
+  fct::Range<const size_t*> row_indices() const {
+    return std::visit([](const auto& _impl) { return _impl.row_indices(); },
+                      impl_);
+  }
+
+  /// A view on the flat arrays of the underlying implementation.
+  IndexView view() const {
+    return std::visit([](const auto& _impl) { return _impl.view(); }, impl_);
+  }
+
+ private:
+  /// Generates the implementation, depending on whether there is a pool.
+  static ImplType make_impl(const IndexParams& _params);
+
  private:
   /// Implements the index functionality
-  const InMemoryIndex impl_;
+  const ImplType impl_;
 };
 }  // namespace tsindex
 
@@ -0,0 +1,268 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef CONTAINERS_TSINDEX_INDEXBUILDER_HPP_
+#define CONTAINERS_TSINDEX_INDEXBUILDER_HPP_
+
+#include "debug/assert_true.hpp"
+#include "multithreading/ThreadPool.hpp"
+#include "tsindex/Float.hpp"
+#include "tsindex/IndexParams.hpp"
+#include "tsindex/Int.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace tsindex {
+
+/// Builds the flat arrays shared by the InMemoryIndex and the
+/// MemoryMappedIndex. The arrays are allocated through _alloc, which must
+/// replace the vector it is passed by a value-initialized one of the
+/// requested size. That way, the MemoryMappedIndex can build its arrays
+/// directly in the pool.
+class IndexBuilder {
+ public:
+  /// Fills the arrays and returns whether the index is dense, meaning that
+  /// the join keys can be used as slots directly. _join_keys is only filled,
+  /// if the index is not dense.
+  template <class AllocType, class IntVectorType, class SizeVectorType,
+            class FloatVectorType>
+  static bool build(const IndexParams& _params, const AllocType& _alloc,
+                    IntVectorType* _join_keys, SizeVectorType* _offsets,
+                    SizeVectorType* _row_indices,
+                    FloatVectorType* _time_stamps);
+
+ private:
+  /// Groups the row numbers by their slots, keeping the original order
+  /// within each slot. Expects _offsets to contain zeros.
+  template <class AllocType, class SizeVectorType>
+  static void group_by_slots(const IndexParams& _params,
+                             const std::vector<size_t>& _slots,
+                             const AllocType& _alloc, SizeVectorType* _offsets,
+                             SizeVectorType* _row_indices);
+
+  /// Assigns every row to the slot of its join key. Also decides whether the
+  /// index is dense and fills _join_keys, if it is not.
+  template <class AllocType, class IntVectorType, class SizeVectorType>
+  static std::vector<size_t> make_slots(const IndexParams& _params,
+                                        const AllocType& _alloc,
+                                        bool* _is_dense,
+                                        IntVectorType* _join_keys,
+                                        SizeVectorType* _offsets);
+
+  /// Sorts the rows within each slot by their time stamps, in parallel, and
+  /// fills _time_stamps.
+  template <class AllocType, class SizeVectorType, class FloatVectorType>
+  static void sort_slots(const IndexParams& _params, const AllocType& _alloc,
+                         const SizeVectorType& _offsets,
+                         SizeVectorType* _row_indices,
+                         FloatVectorType* _time_stamps);
+};
+
+// ----------------------------------------------------------------------------
+
+template <class AllocType, class IntVectorType, class SizeVectorType,
+          class FloatVectorType>
+bool IndexBuilder::build(const IndexParams& _params, const AllocType& _alloc,
+                         IntVectorType* _join_keys, SizeVectorType* _offsets,
+                         SizeVectorType* _row_indices,
+                         FloatVectorType* _time_stamps) {
+  assert_true(_params.join_keys_.end() >= _params.join_keys_.begin());
+
+  assert_true(_params.lower_ts_.size() == _params.join_keys_.size());
+
+  assert_true(_params.rownums_);
+
+  bool is_dense = true;
+
+  const auto slots =
+      make_slots(_params, _alloc, &is_dense, _join_keys, _offsets);
+
+  group_by_slots(_params, slots, _alloc, _offsets, _row_indices);
+
+  sort_slots(_params, _alloc, *_offsets, _row_indices, _time_stamps);
+
+  return is_dense;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class AllocType, class SizeVectorType>
+void IndexBuilder::group_by_slots(const IndexParams& _params,
+                                  const std::vector<size_t>& _slots,
+                                  const AllocType& _alloc,
+                                  SizeVectorType* _offsets,
+                                  SizeVectorType* _row_indices) {
+  const auto& rownums = *_params.rownums_;
+
+  auto& offsets = *_offsets;
+
+  assert_true(_slots.size() == rownums.size());
+
+  for (const auto slot : _slots) {
+    ++offsets[slot + 1];
+  }
+
+  for (size_t s = 1; s < offsets.size(); ++s) {
+    offsets[s] += offsets[s - 1];
+  }
+
+  auto next = std::vector<size_t>(offsets.begin(), offsets.end() - 1);
+
+  _alloc(_row_indices, rownums.size());
+
+  auto& row_indices = *_row_indices;
+
+  for (size_t i = 0; i < rownums.size(); ++i) {
+    row_indices[next[_slots[i]]++] = rownums[i];
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+template <class AllocType, class IntVectorType, class SizeVectorType>
+std::vector<size_t> IndexBuilder::make_slots(const IndexParams& _params,
+                                             const AllocType& _alloc,
+                                             bool* _is_dense,
+                                             IntVectorType* _join_keys,
+                                             SizeVectorType* _offsets) {
+  constexpr size_t block_size = 100000;
+
+  const auto& rownums = *_params.rownums_;
+
+  const auto join_key = [&_params](const size_t _ix) -> Int {
+    assert_true(_ix < _params.join_keys_.size());
+    return *(_params.join_keys_.begin() + _ix);
+  };
+
+  Int max_join_key = -1;
+
+  for (const auto ix : rownums) {
+    assert_true(join_key(ix) >= 0);
+    max_join_key = std::max(max_join_key, join_key(ix));
+  }
+
+  const auto num_dense_slots = static_cast<size_t>(max_join_key + 1);
+
+  // A dense table is more than twice as large as the rows it indexes, if the
+  // join keys are sparse, which is why we fall back to searching the sorted
+  // join keys in that case.
+  *_is_dense = num_dense_slots <= 2 * rownums.size();
+
+  auto slots = std::vector<size_t>(rownums.size());
+
+  if (*_is_dense) {
+    for (size_t i = 0; i < rownums.size(); ++i) {
+      slots[i] = static_cast<size_t>(join_key(rownums[i]));
+    }
+    _alloc(_offsets, num_dense_slots + 1);
+    return slots;
+  }
+
+  auto unique_join_keys = std::vector<Int>(rownums.size());
+
+  for (size_t i = 0; i < rownums.size(); ++i) {
+    unique_join_keys[i] = join_key(rownums[i]);
+  }
+
+  std::ranges::sort(unique_join_keys);
+
+  unique_join_keys.erase(
+      std::unique(unique_join_keys.begin(), unique_join_keys.end()),
+      unique_join_keys.end());
+
+  const auto find_slots = [block_size, &rownums, &join_key, &slots,
+                           &unique_join_keys](const size_t _block) {
+    const auto end = std::min((_block + 1) * block_size, rownums.size());
+    for (size_t i = _block * block_size; i < end; ++i) {
+      const auto jk = join_key(rownums[i]);
+      const auto it = std::ranges::lower_bound(unique_join_keys, jk);
+      slots[i] = static_cast<size_t>(it - unique_join_keys.begin());
+    }
+  };
+
+  multithreading::ThreadPool::get().parallel_for(
+      (rownums.size() + block_size - 1) / block_size, find_slots);
+
+  _alloc(_join_keys, unique_join_keys.size());
+
+  std::ranges::copy(unique_join_keys, _join_keys->begin());
+
+  _alloc(_offsets, unique_join_keys.size() + 1);
+
+  return slots;
+}
+
+// ----------------------------------------------------------------------------
+
+template <class AllocType, class SizeVectorType, class FloatVectorType>
+void IndexBuilder::sort_slots(const IndexParams& _params,
+                              const AllocType& _alloc,
+                              const SizeVectorType& _offsets,
+                              SizeVectorType* _row_indices,
+                              FloatVectorType* _time_stamps) {
+  constexpr size_t min_block_size = 10000;
+
+  const auto lower_ts = [&_params](const size_t _ix) -> Float {
+    assert_true(_ix < _params.lower_ts_.size());
+    return *(_params.lower_ts_.begin() + _ix);
+  };
+
+  // NaN is sorted to the end of each slot, so it can never be found.
+  const auto comp = [&lower_ts](const size_t _i, const size_t _j) -> bool {
+    const auto ts_i = lower_ts(_i);
+    const auto ts_j = lower_ts(_j);
+    return ts_i < ts_j || (!std::isnan(ts_i) && std::isnan(ts_j));
+  };
+
+  auto& row_indices = *_row_indices;
+
+  const auto num_threads = multithreading::ThreadPool::get().num_threads();
+
+  const auto block_size =
+      std::max(min_block_size, row_indices.size() / (4 * num_threads + 1));
+
+  auto boundaries = std::vector<size_t>({0});
+
+  for (size_t s = 0; s + 1 < _offsets.size(); ++s) {
+    if (_offsets[s + 1] - _offsets[boundaries.back()] >= block_size) {
+      boundaries.push_back(s + 1);
+    }
+  }
+
+  if (boundaries.back() + 1 < _offsets.size()) {
+    boundaries.push_back(_offsets.size() - 1);
+  }
+
+  _alloc(_time_stamps, row_indices.size());
+
+  auto& time_stamps = *_time_stamps;
+
+  const auto sort_block = [&_offsets, &boundaries, &comp, &lower_ts,
+                           &row_indices, &time_stamps](const size_t _block) {
+    for (size_t s = boundaries[_block]; s < boundaries[_block + 1]; ++s) {
+      const auto begin = row_indices.begin() + _offsets[s];
+      const auto end = row_indices.begin() + _offsets[s + 1];
+      std::stable_sort(begin, end, comp);
+    }
+    for (size_t k = _offsets[boundaries[_block]];
+         k < _offsets[boundaries[_block + 1]]; ++k) {
+      time_stamps[k] = lower_ts(row_indices[k]);
+    }
+  };
+
+  multithreading::ThreadPool::get().parallel_for(boundaries.size() - 1,
+                                                 sort_block);
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace tsindex
+
+#endif  // CONTAINERS_TSINDEX_INDEXBUILDER_HPP_
@@ -9,6 +9,7 @@
 #define CONTAINERS_TSINDEX_INDEXPARAMS_HPP_
 
 #include "fct/Range.hpp"
+#include "memmap/Pool.hpp"
 #include "tsindex/Float.hpp"
 #include "tsindex/Int.hpp"
 
@@ -27,6 +28,10 @@ class IndexParams {
   /// The difference between the lower_ts and the upper_ts.
   const Float memory_;
 
+  /// The pool to store the index in. If this is a nullptr, the index is
+  /// kept in memory.
+  const std::shared_ptr<memmap::Pool> pool_ = nullptr;
+
   /// The rownums over which we actually have to build the index.
   /// We might not have to index the full data, because of
   /// multithreading or because there are entries in the peripheral
@@ -0,0 +1,104 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef CONTAINERS_TSINDEX_INDEXVIEW_HPP_
+#define CONTAINERS_TSINDEX_INDEXVIEW_HPP_
+
+#include "tsindex/Float.hpp"
+#include "tsindex/Int.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace tsindex {
+
+/// A non-owning view on the flat arrays making up a time series index. The
+/// rows are grouped into slots, one slot per join key, and sorted by their
+/// lower time stamps within each slot. Lookups first find the slot of the
+/// join key and then run a branchless binary search over the time stamps of
+/// that slot, which only touches a few contiguous cache lines.
+///
+/// The lookup is shared by the in-memory and the memory-mapped index. The
+/// pointers are only valid until the underlying storage is modified, so
+/// views should not be kept around.
+struct IndexView {
+  /// Finds the positions in row_indices_ of the rows for which .join_key_ ==
+  /// _join_key and .time_stamp_ <= _time_stamp and time_stamp_ + memory_ >
+  /// _time_stamp.
+  std::pair<size_t, size_t> find_ix_range(const Int _join_key,
+                                          const Float _time_stamp) const {
+    const auto slot = find_slot(_join_key);
+    if (!slot) {
+      return std::make_pair<size_t, size_t>(0, 0);
+    }
+    const auto begin = offsets_[*slot];
+    const auto end = offsets_[*slot + 1];
+    return std::make_pair(upper_bound(begin, end, _time_stamp - memory_),
+                          upper_bound(begin, end, _time_stamp));
+  }
+
+  /// Finds the slot belonging to _join_key, if there is one.
+  std::optional<size_t> find_slot(const Int _join_key) const {
+    if (_join_key < 0) {
+      return std::nullopt;
+    }
+    if (!join_keys_) {
+      const auto slot = static_cast<size_t>(_join_key);
+      return slot < num_slots_ ? std::make_optional(slot) : std::nullopt;
+    }
+    const auto it =
+        std::lower_bound(join_keys_, join_keys_ + num_slots_, _join_key);
+    if (it == join_keys_ + num_slots_ || *it != _join_key) {
+      return std::nullopt;
+    }
+    return static_cast<size_t>(it - join_keys_);
+  }
+
+  /// Returns the first position in [_begin, _end) for which the time stamp
+  /// is greater than _time_stamp (or NaN), _end if there is no such position.
+  size_t upper_bound(const size_t _begin, const size_t _end,
+                     const Float _time_stamp) const {
+    if (_begin == _end) {
+      return _begin;
+    }
+    const Float* base = time_stamps_ + _begin;
+    size_t len = _end - _begin;
+    while (len > 1) {
+      const auto half = len / 2;
+      base = (base[half - 1] <= _time_stamp) ? base + half : base;
+      len -= half;
+    }
+    const auto ix = static_cast<size_t>(base - time_stamps_);
+    return (*base <= _time_stamp) ? ix + 1 : ix;
+  }
+
+  /// The sorted join keys, one per slot. A nullptr signifies that the index
+  /// is dense, meaning that the join key itself is the slot.
+  const Int* join_keys_;
+
+  /// The difference between the lower_ts and the upper_ts.
+  Float memory_;
+
+  /// The number of slots.
+  size_t num_slots_;
+
+  /// offsets_[s] to offsets_[s + 1] are the positions of the rows in slot s.
+  /// Contains num_slots_ + 1 elements.
+  const size_t* offsets_;
+
+  /// The row numbers, sorted by join key and time stamp.
+  const size_t* row_indices_;
+
+  /// The lower time stamps, in the same order as row_indices_.
+  const Float* time_stamps_;
+};
+
+}  // namespace tsindex
+
+#endif  // CONTAINERS_TSINDEX_INDEXVIEW_HPP_
@@ -0,0 +1,93 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#ifndef CONTAINERS_TSINDEX_MEMORYMAPPEDINDEX_HPP_
+#define CONTAINERS_TSINDEX_MEMORYMAPPEDINDEX_HPP_
+
+#include "fct/Range.hpp"
+#include "memmap/Pool.hpp"
+#include "memmap/Vector.hpp"
+#include "tsindex/Float.hpp"
+#include "tsindex/IndexParams.hpp"
+#include "tsindex/IndexView.hpp"
+#include "tsindex/Int.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace tsindex {
+
+/// The same flat index as the InMemoryIndex, but the arrays are built
+/// directly in a memmap::Pool, like the other memory-mapped indices.
+class MemoryMappedIndex {
+ public:
+  explicit MemoryMappedIndex(const IndexParams& _params);
+
+  ~MemoryMappedIndex() = default;
+
+  MemoryMappedIndex(MemoryMappedIndex&&) noexcept = default;
+
+ public:
+  /// Finds a range of rownums for which .join_key_ == _join_key and
+  /// .time_stamp_
+  /// <= _time_stamp and time_stamp_ + memory_ > _time_stamp.
+  fct::Range<const size_t*> find_range(const Int _join_key,
+                                       const Float _time_stamp) const {
+    const auto [ix_begin, ix_end] = find_ix_range(_join_key, _time_stamp);
+    return fct::Range<const size_t*>(row_indices_.data() + ix_begin,
+                                     row_indices_.data() + ix_end);
+  }
+
+  /// Like find_range(...), but returns the positions in row_indices()
+  /// instead.
+  std::pair<size_t, size_t> find_ix_range(const Int _join_key,
+                                          const Float _time_stamp) const {
+    return view().find_ix_range(_join_key, _time_stamp);
+  }
+
+  /// The row numbers, sorted by join key and time stamp.
+  fct::Range<const size_t*> row_indices() const {
+    return fct::Range<const size_t*>(
+        row_indices_.data(), row_indices_.data() + row_indices_.size());
+  }
+
+  /// A view on the flat arrays.
+  IndexView view() const {
+    return IndexView{.join_keys_ = is_dense_ ? nullptr : join_keys_.data(),
+                     .memory_ = memory_,
+                     .num_slots_ = offsets_.size() - 1,
+                     .offsets_ = offsets_.data(),
+                     .row_indices_ = row_indices_.data(),
+                     .time_stamps_ = time_stamps_.data()};
+  }
+
+ private:
+  /// Whether the join keys can be used as slots directly.
+  bool is_dense_;
+
+  /// The sorted join keys, one per slot (only if the index is not dense).
+  memmap::Vector<Int> join_keys_;
+
+  /// The difference between the lower_ts and the upper_ts.
+  Float memory_;
+
+  /// offsets_[s] to offsets_[s + 1] are the positions of the rows in slot s.
+  memmap::Vector<size_t> offsets_;
+
+  /// Row indices signify the order of the rows in the data frame, when sorted
+  /// by the keys.
+  memmap::Vector<size_t> row_indices_;
+
+  /// The lower time stamps, in the same order as row_indices_.
+  memmap::Vector<Float> time_stamps_;
+};
+}  // namespace tsindex
+
+// ----------------------------------------------------------------------------
+
+#endif  // CONTAINERS_TSINDEX_MEMORYMAPPEDINDEX_HPP_
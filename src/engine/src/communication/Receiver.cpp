@@ -9,8 +9,33 @@
 
 #include "communication/Int.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace communication {
 
+void Receiver::recv_bytes(const ULong _size, Poco::Net::StreamSocket *_socket,
+                          char *_data) {
+  constexpr auto max_len =
+      static_cast<ULong>(std::numeric_limits<int>::max());
+
+  for (ULong num_bytes_received = 0; num_bytes_received < _size;) {
+    const auto nbytes = _socket->receiveBytes(
+        _data + num_bytes_received,
+        static_cast<int>(std::min(max_len, _size - num_bytes_received)));
+
+    if (nbytes <= 0) {
+      throw std::runtime_error(
+          "Broken pipe while attempting to receive "
+          "data.");
+    }
+
+    num_bytes_received += static_cast<ULong>(nbytes);
+  }
+}
+
+// -----------------------------------------------------------------------------
+
 std::string Receiver::recv_cmd(
     const rfl::Ref<const communication::Logger> &_logger,
     Poco::Net::StreamSocket *_socket) {
@@ -9,11 +9,98 @@
 
 #include "communication/Int.hpp"
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <limits>
 #include <numeric>
 
 namespace communication {
 // ------------------------------------------------------------------------
 
+void Sender::send_buffers(std::vector<std::string_view> _buffers,
+                          Poco::Net::StreamSocket* _socket) {
+  const auto fd = _socket->impl()->sockfd();
+
+  auto iov = std::vector<iovec>();
+
+  for (size_t first = 0; first < _buffers.size();) {
+    iov.clear();
+
+    for (size_t i = first; i < _buffers.size() && iov.size() < IOV_MAX; ++i) {
+      iov.push_back(iovec{.iov_base = const_cast<char*>(_buffers[i].data()),
+                          .iov_len = _buffers[i].size()});
+    }
+
+    auto msg = msghdr{};
+
+    msg.msg_iov = iov.data();
+
+    msg.msg_iovlen = iov.size();
+
+    // Unlike writev(...), sendmsg(...) lets us suppress SIGPIPE, just like
+    // Poco does.
+    const auto nbytes = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+
+    if (nbytes < 0 && errno == EINTR) {
+      continue;
+    }
+
+    // The socket is non-blocking or its send timeout has expired, so we wait
+    // until it becomes writable again.
+    if (nbytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (!_socket->poll(_socket->getSendTimeout(),
+                         Poco::Net::Socket::SELECT_WRITE)) {
+        throw std::runtime_error("Timeout while attempting to send data.");
+      }
+      continue;
+    }
+
+    if (nbytes < 0) {
+      throw std::runtime_error("Could not send data: " +
+                               std::string(std::strerror(errno)));
+    }
+
+    // The kernel might have sent only part of the data, in which case we
+    // continue where it stopped.
+    auto remaining = static_cast<size_t>(nbytes);
+
+    while (first < _buffers.size() && remaining >= _buffers[first].size()) {
+      remaining -= _buffers[first].size();
+      ++first;
+    }
+
+    if (remaining > 0) {
+      _buffers[first].remove_prefix(remaining);
+    }
+  }
+}
+
+// ------------------------------------------------------------------------
+
+void Sender::send_bytes(const char* _data, const ULong _size,
+                        Poco::Net::StreamSocket* _socket) {
+  constexpr auto max_len =
+      static_cast<ULong>(std::numeric_limits<int>::max());
+
+  for (ULong num_bytes_sent = 0; num_bytes_sent < _size;) {
+    const auto nbytes = _socket->sendBytes(
+        _data + num_bytes_sent,
+        static_cast<int>(std::min(max_len, _size - num_bytes_sent)));
+
+    if (nbytes <= 0) {
+      throw std::runtime_error("Broken pipe while attempting to send data.");
+    }
+
+    num_bytes_sent += static_cast<ULong>(nbytes);
+  }
+}
+
+// ------------------------------------------------------------------------
+
 void Sender::send_categorical_column(const std::vector<std::string>& _col,
                                      Poco::Net::StreamSocket* _socket) {
   const auto get_str_len = [](const size_t _init,
@@ -111,35 +198,32 @@ void Sender::send_features(const containers::NumericalFeatures& _features,
 
   // ------------------------------------------------
 
-  const ULong size = nrows * ncols;
+  // The features are transposed and byte-swapped in a single pass.
 
-  constexpr ULong len = 16384;
+  const bool is_little_endian = helpers::Endianness::is_little_endian();
 
-  ULong ix = 0;
+  const ULong size = nrows * ncols;
 
-  auto buffer = std::array<Float, len>();
+  constexpr ULong len = CHUNK_SIZE / sizeof(Float);
 
-  while (true) {
-    // ---------------------------------------------------------------
+  auto buffer = std::vector<Float>(std::min(len, size));
 
+  for (ULong ix = 0; ix < size;) {
     const ULong current_len = std::min(len, size - ix);
 
-    if (current_len == 0) {
-      break;
-    }
-
     for (ULong ix2 = 0; ix2 < current_len; ++ix, ++ix2) {
       const ULong i = ix / ncols;
       const ULong j = ix % ncols;
 
       buffer[ix2] = _features[j][i];
-    }
 
-    // ---------------------------------------------------------------
-
-    Sender::send<Float>(current_len * sizeof(Float), buffer.data(), _socket);
+      if (is_little_endian) {
+        helpers::Endianness::reverse_byte_order(&buffer[ix2]);
+      }
+    }
 
-    // ---------------------------------------------------------------
+    Sender::send_bytes(reinterpret_cast<const char*>(buffer.data()),
+                       current_len * sizeof(Float), _socket);
   }
 
   // ------------------------------------------------
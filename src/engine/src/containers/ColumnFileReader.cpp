@@ -0,0 +1,224 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "containers/ColumnFileReader.hpp"
+
+#include "containers/ColumnFileWriter.hpp"
+
+#include <rfl/json/read.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace containers {
+
+ColumnFileReader::ColumnFileReader(const std::string& _fname)
+    : file_(_fname),
+      fname_(_fname),
+      index_(read_index(file_, _fname)),
+      codec_(ColumnFileWriter::make_codec(index_.compression())) {}
+
+// ----------------------------------------------------------------------------
+
+const ColumnFileEntry& ColumnFileReader::find(const std::string& _key,
+                                              const std::string& _type) const {
+  for (const auto& entry : index_.columns()) {
+    if (entry.key() != _key) {
+      continue;
+    }
+
+    if (entry.type() != _type) {
+      throw std::runtime_error("Column '" + _key + "' in '" + fname_ +
+                               "' is of type '" + entry.type() +
+                               "', expected '" + _type + "'.");
+    }
+
+    return entry;
+  }
+
+  throw std::runtime_error("Column '" + _key + "' not found in '" + fname_ +
+                           "'.");
+}
+
+// ----------------------------------------------------------------------------
+
+bool ColumnFileReader::has(const std::string& _key) const {
+  for (const auto& entry : index_.columns()) {
+    if (entry.key() == _key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ----------------------------------------------------------------------------
+
+size_t ColumnFileReader::raw_size(const ColumnFileSegment& _segment) {
+  size_t size = 0;
+  for (const auto& block : _segment) {
+    size += block.raw_size();
+  }
+  return size;
+}
+
+// ----------------------------------------------------------------------------
+
+ColumnFileIndex ColumnFileReader::read_index(const io::MappedFile& _file,
+                                             const std::string& _fname) {
+  const auto content = _file.content();
+
+  const auto magic = std::string_view(ColumnFileWriter::MAGIC);
+
+  const auto trailer_size = 2 * sizeof(std::uint64_t) + magic.size();
+
+  if (content.size() < magic.size() + trailer_size ||
+      !content.starts_with(magic) || !content.ends_with(magic)) {
+    throw std::runtime_error("'" + _fname + "' is not a valid column file.");
+  }
+
+  std::uint64_t index_offset = 0;
+
+  std::uint64_t index_size = 0;
+
+  const auto trailer = content.data() + content.size() - trailer_size;
+
+  std::memcpy(&index_offset, trailer, sizeof(std::uint64_t));
+
+  std::memcpy(&index_size, trailer + sizeof(std::uint64_t),
+              sizeof(std::uint64_t));
+
+  if (!helpers::Endianness::is_little_endian()) {
+    helpers::Endianness::reverse_byte_order(&index_offset);
+    helpers::Endianness::reverse_byte_order(&index_size);
+  }
+
+  if (index_offset + index_size != content.size() - trailer_size) {
+    throw std::runtime_error("'" + _fname + "' is not a valid column file.");
+  }
+
+  const auto json = std::string(content.substr(index_offset, index_size));
+
+  return rfl::json::read<ColumnFileIndex>(json).value();
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnFileReader::read_segment(const ColumnFileSegment& _segment,
+                                    char* _out, const size_t _size) const {
+  const auto content = file_.content();
+
+  size_t pos = 0;
+
+  for (const auto& block : _segment) {
+    const auto offset = block.offset();
+
+    const auto size = block.size();
+
+    const auto raw_size = block.raw_size();
+
+    if (offset + size > content.size() || pos + raw_size > _size) {
+      throw std::runtime_error("'" + fname_ + "' is corrupted.");
+    }
+
+    if (codec_) {
+      const auto decompressed_len = codec_->Decompress(
+          static_cast<std::int64_t>(size),
+          reinterpret_cast<const std::uint8_t*>(content.data() + offset),
+          static_cast<std::int64_t>(raw_size),
+          reinterpret_cast<std::uint8_t*>(_out + pos));
+
+      if (!decompressed_len.ok() ||
+          static_cast<size_t>(*decompressed_len) != raw_size) {
+        throw std::runtime_error("'" + fname_ + "' is corrupted.");
+      }
+    } else {
+      if (size != raw_size) {
+        throw std::runtime_error("'" + fname_ + "' is corrupted.");
+      }
+      std::memcpy(_out + pos, content.data() + offset, size);
+    }
+
+    file_.release(offset, size);
+
+    pos += raw_size;
+  }
+
+  if (pos != _size) {
+    throw std::runtime_error("'" + fname_ + "' is corrupted.");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+Column<strings::String> ColumnFileReader::read_strings(
+    const ColumnFileEntry& _entry,
+    const std::shared_ptr<memmap::Pool>& _pool) const {
+  if (!_entry.dict_indptr() || !_entry.dict_chars()) {
+    throw std::runtime_error("'" + fname_ + "' is corrupted.");
+  }
+
+  auto codes = std::vector<std::uint32_t>(_entry.nrows());
+
+  read_segment(_entry.values(), reinterpret_cast<char*>(codes.data()),
+               codes.size() * sizeof(std::uint32_t));
+
+  fix_byte_order(codes.data(), codes.size());
+
+  const auto& indptr_segment = *_entry.dict_indptr();
+
+  auto indptr = std::vector<std::uint64_t>(raw_size(indptr_segment) /
+                                           sizeof(std::uint64_t));
+
+  read_segment(indptr_segment, reinterpret_cast<char*>(indptr.data()),
+               indptr.size() * sizeof(std::uint64_t));
+
+  fix_byte_order(indptr.data(), indptr.size());
+
+  const auto& chars_segment = *_entry.dict_chars();
+
+  auto chars = std::string(raw_size(chars_segment), '\0');
+
+  read_segment(chars_segment, chars.data(), chars.size());
+
+  // Every distinct string is only constructed once, copies of long strings
+  // share their memory.
+  auto dictionary = std::vector<strings::String>();
+
+  for (size_t i = 0; i + 1 < indptr.size(); ++i) {
+    if (indptr[i] > indptr[i + 1] || indptr[i + 1] > chars.size()) {
+      throw std::runtime_error("'" + fname_ + "' is corrupted.");
+    }
+    dictionary.emplace_back(chars.data() + indptr[i],
+                            indptr[i + 1] - indptr[i]);
+  }
+
+  auto col = Column<strings::String>(_pool);
+
+  for (const auto code : codes) {
+    if (code == ColumnFileWriter::NULL_CODE) {
+      col.push_back(strings::String(nullptr));
+      continue;
+    }
+
+    if (code >= dictionary.size()) {
+      throw std::runtime_error("'" + fname_ + "' is corrupted.");
+    }
+
+    col.push_back(dictionary[code]);
+  }
+
+  set_metadata(_entry, &col);
+
+  return col;
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace containers
@@ -0,0 +1,227 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "containers/ColumnFileWriter.hpp"
+
+#include "helpers/Endianness.hpp"
+#include "strings/StringHasher.hpp"
+
+#include <rfl/json/write.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace containers {
+
+ColumnFileWriter::ColumnFileWriter(const std::string& _fname,
+                                   const std::string& _compression)
+    : codec_(make_codec(_compression)),
+      compression_(_compression),
+      fname_(_fname),
+      offset_(0),
+      output_(_fname, std::ios::binary) {
+  if (!output_) {
+    throw std::runtime_error("'" + _fname +
+                             "' could not be opened for writing!");
+  }
+
+  write_bytes(MAGIC, std::strlen(MAGIC));
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnFileWriter::align() {
+  const auto padding = (ALIGNMENT - offset_ % ALIGNMENT) % ALIGNMENT;
+  const auto zeros = std::string(padding, '\0');
+  write_bytes(zeros.data(), zeros.size());
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnFileWriter::close() {
+  const auto index =
+      ColumnFileIndex{.columns = entries_,
+                      .compression = compression_,
+                      .little_endian = helpers::Endianness::is_little_endian()};
+
+  const auto json = rfl::json::write(index);
+
+  std::uint64_t index_offset = offset_;
+
+  std::uint64_t index_size = json.size();
+
+  write_bytes(json.data(), json.size());
+
+  // The trailer is always written in little endian, because we need it to
+  // find the index.
+  if (!helpers::Endianness::is_little_endian()) {
+    helpers::Endianness::reverse_byte_order(&index_offset);
+    helpers::Endianness::reverse_byte_order(&index_size);
+  }
+
+  write_bytes(reinterpret_cast<const char*>(&index_offset),
+              sizeof(index_offset));
+
+  write_bytes(reinterpret_cast<const char*>(&index_size), sizeof(index_size));
+
+  write_bytes(MAGIC, std::strlen(MAGIC));
+
+  output_.close();
+
+  if (!output_) {
+    throw std::runtime_error("'" + fname_ + "' could not be written!");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+std::unique_ptr<arrow::util::Codec> ColumnFileWriter::make_codec(
+    const std::string& _compression) {
+  if (_compression == "none") {
+    return nullptr;
+  }
+
+  if (_compression != "lz4" && _compression != "zstd") {
+    throw std::runtime_error("Unknown compression '" + _compression +
+                             "'. Supported are 'none', 'lz4' and 'zstd'.");
+  }
+
+  const auto type = _compression == "lz4" ? arrow::Compression::LZ4_FRAME
+                                          : arrow::Compression::ZSTD;
+
+  auto codec = arrow::util::Codec::Create(type);
+
+  if (!codec.ok()) {
+    throw std::runtime_error("Compression '" + _compression +
+                             "' is not available: " +
+                             codec.status().message());
+  }
+
+  return std::move(*codec);
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnFileWriter::write_bytes(const char* _data, const size_t _size) {
+  output_.write(_data, static_cast<std::streamsize>(_size));
+
+  if (!output_) {
+    throw std::runtime_error("'" + fname_ + "' could not be written!");
+  }
+
+  offset_ += _size;
+}
+
+// ----------------------------------------------------------------------------
+
+ColumnFileSegment ColumnFileWriter::write_segment(const char* _data,
+                                                  const size_t _size) {
+  align();
+
+  auto segment = ColumnFileSegment();
+
+  auto buffer = std::vector<std::uint8_t>();
+
+  for (size_t begin = 0; begin < _size; begin += BLOCK_SIZE) {
+    const auto raw_size = std::min(BLOCK_SIZE, _size - begin);
+
+    const auto offset = offset_;
+
+    if (codec_) {
+      const auto input = reinterpret_cast<const std::uint8_t*>(_data + begin);
+
+      const auto input_len = static_cast<std::int64_t>(raw_size);
+
+      buffer.resize(
+          static_cast<size_t>(codec_->MaxCompressedLen(input_len, input)));
+
+      const auto compressed_len =
+          codec_->Compress(input_len, input,
+                           static_cast<std::int64_t>(buffer.size()),
+                           buffer.data());
+
+      if (!compressed_len.ok()) {
+        throw std::runtime_error("Compressing '" + fname_ +
+                                 "' failed: " +
+                                 compressed_len.status().message());
+      }
+
+      write_bytes(reinterpret_cast<const char*>(buffer.data()),
+                  static_cast<size_t>(*compressed_len));
+    } else {
+      write_bytes(_data + begin, raw_size);
+    }
+
+    segment.push_back(ColumnFileBlock{
+        .offset = offset, .size = offset_ - offset, .raw_size = raw_size});
+  }
+
+  return segment;
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnFileWriter::write_strings(const std::string& _key,
+                                     const Column<strings::String>& _col) {
+  auto codes = std::vector<std::uint32_t>(_col.nrows());
+
+  auto dict_indptr = std::vector<std::uint64_t>({0});
+
+  auto dict_chars = std::string();
+
+  auto dictionary = std::unordered_map<strings::String, std::uint32_t,
+                                       strings::StringHasher>();
+
+  for (size_t i = 0; i < _col.nrows(); ++i) {
+    const auto str = _col[i];
+
+    if (!str) {
+      codes[i] = NULL_CODE;
+      continue;
+    }
+
+    const auto [it, inserted] = dictionary.try_emplace(
+        str, static_cast<std::uint32_t>(dictionary.size()));
+
+    if (inserted) {
+      if (dictionary.size() >= NULL_CODE) {
+        throw std::runtime_error("Column '" + _col.name() +
+                                 "' contains too many distinct strings.");
+      }
+      dict_chars.append(str.c_str(), str.size());
+      dict_indptr.push_back(dict_chars.size());
+    }
+
+    codes[i] = it->second;
+  }
+
+  const auto values =
+      write_segment(reinterpret_cast<const char*>(codes.data()),
+                    codes.size() * sizeof(std::uint32_t));
+
+  const auto indptr =
+      write_segment(reinterpret_cast<const char*>(dict_indptr.data()),
+                    dict_indptr.size() * sizeof(std::uint64_t));
+
+  const auto chars = write_segment(dict_chars.data(), dict_chars.size());
+
+  entries_.push_back(ColumnFileEntry{.key = _key,
+                                     .type = std::string("string"),
+                                     .name = _col.name(),
+                                     .nrows = _col.nrows(),
+                                     .subroles = _col.subroles(),
+                                     .unit = _col.unit(),
+                                     .values = values,
+                                     .dict_indptr = indptr,
+                                     .dict_chars = chars});
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace containers
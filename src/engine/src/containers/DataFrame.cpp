@@ -9,13 +9,19 @@
 
 #include "containers/DataFramePrinter.hpp"
 #include "database/Getter.hpp"
-#include "io/CSVReader.hpp"
+#include "io/ParallelCSVReader.hpp"
+#include "io/TimeStampParser.hpp"
+#include "multithreading/ThreadPool.hpp"
+#include "strings/StringHasher.hpp"
 
 #include <Poco/Path.h>
 #include <Poco/TemporaryFile.h>
 #include <rfl/Field.hpp>
 
+#include <iterator>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 
 namespace containers {
 
@@ -487,14 +493,25 @@ std::vector<std::string> DataFrame::concat_colnames(
 
 // ----------------------------------------------------------------------------
 
+void DataFrame::build_indices() const {
+  multithreading::ThreadPool::get().parallel_for(
+      indices_.size(), [this](const size_t _i) { indices_.at(_i).build(); });
+}
+
+// ----------------------------------------------------------------------------
+
 void DataFrame::create_indices() {
+  // Every index needs a map of its own, so we cannot just copy a single
+  // index.
   if (indices().size() != join_keys().size()) {
-    indices() =
-        std::vector<DataFrameIndex>(join_keys().size(), DataFrameIndex(pool_));
+    indices().clear();
+    for (size_t i = 0; i < join_keys().size(); ++i) {
+      indices().emplace_back(pool_);
+    }
   }
 
   for (size_t i = 0; i < join_keys().size(); ++i) {
-    index(i).calculate(join_key(i));
+    index(i).update(join_key(i));
   }
 }
 
@@ -563,10 +580,10 @@ void DataFrame::from_csv(
     auto local_df = containers::DataFrame(name(), categories_,
                                           join_keys_encoding_, make_pool());
 
-    const std::shared_ptr<io::Reader> reader = std::make_shared<io::CSVReader>(
-        _colnames, _fnames[i], limit, _quotechar[0], _sep[0]);
+    const auto reader = io::ParallelCSVReader(_colnames, _fnames[i], limit,
+                                              _quotechar[0], _sep[0]);
 
-    local_df.from_reader(reader, _fnames[i], _skip, _time_formats, _schema);
+    local_df.from_csv(reader, _fnames[i], _skip, _time_formats, _schema);
 
     if (i == 0) {
       df = std::move(local_df);
@@ -790,15 +807,17 @@ void DataFrame::from_json(const commands::DataFrameFromJSON &_obj,
 void DataFrame::from_json(const commands::DataFrameFromJSON &_obj,
                           const std::vector<std::string> &_names,
                           const std::vector<std::string> &_time_formats) {
-  const auto make_column = [this,
-                            &_time_formats](const auto &_vec) -> Column<Float> {
+  const auto time_stamp_parser = io::TimeStampParser(_time_formats);
+
+  const auto make_column = [this, &time_stamp_parser](
+                               const auto &_vec) -> Column<Float> {
     using Type = std::decay_t<decltype(_vec)>;
 
     auto column = Column<Float>(pool_);
 
     if constexpr (std::is_same<Type, std::vector<std::string>>()) {
       for (size_t j = 0; j < _vec.size(); ++j) {
-        const auto [val, _] = io::Parser::to_time_stamp(_vec[j], _time_formats);
+        const auto [val, _] = time_stamp_parser.parse(_vec[j]);
         column.push_back(val);
       }
     } else {
@@ -888,7 +907,8 @@ void DataFrame::from_query(const rfl::Ref<database::Connector> _connector,
 
   const auto unused_string_ix = make_column_indices(_schema.unused_strings());
 
-  const auto time_formats = _connector->time_formats();
+  const auto time_stamp_parser =
+      io::TimeStampParser(_connector->time_formats());
 
   while (!iterator->end()) {
     auto line = std::vector<std::string>(iter_colnames.size());
@@ -925,7 +945,7 @@ void DataFrame::from_query(const rfl::Ref<database::Connector> _connector,
     for (size_t i = 0; i < time_stamps.size(); ++i) {
       const auto &str = line[time_stamp_ix[i]];
       time_stamps[i]->push_back(
-          database::Getter::get_time_stamp(str, time_formats));
+          database::Getter::get_time_stamp(str, time_stamp_parser));
     }
 
     for (size_t i = 0; i < unused_floats.size(); ++i) {
@@ -966,30 +986,49 @@ void DataFrame::from_query(const rfl::Ref<database::Connector> _connector,
 
 // ----------------------------------------------------------------------------
 
-void DataFrame::from_reader(const std::shared_ptr<io::Reader> &_reader,
-                            const std::string &_fname, const size_t _skip,
-                            const std::vector<std::string> &_time_formats,
-                            const Schema &_schema) {
-  assert_true(_reader);
-
-  const auto csv_colnames = _reader->colnames();
-
-  auto categoricals = make_vectors<Int>(_schema.categoricals().size());
-
-  auto join_keys = make_vectors<Int>(_schema.join_keys().size());
-
-  auto numericals = make_vectors<Float>(_schema.numericals().size());
-
-  auto targets = make_vectors<Float>(_schema.targets().size());
-
-  auto text = make_vectors<strings::String>(_schema.text().size());
-
-  auto time_stamps = make_vectors<Float>(_schema.time_stamps().size());
+void DataFrame::from_csv(const io::ParallelCSVReader &_reader,
+                         const std::string &_fname, const size_t _skip,
+                         const std::vector<std::string> &_time_formats,
+                         const Schema &_schema) {
+  constexpr size_t min_chunk_size = 1 << 20;
+
+  /// The columns parsed from a single chunk. The categorical columns and join
+  /// keys contain chunk-local codes, which are translated to the global
+  /// encodings in the order of the chunks, so the resulting encodings are
+  /// exactly the same as if the file had been read line by line.
+  struct Chunk {
+    /// Maps strings to chunk-local codes.
+    struct LocalEncoding {
+      std::unordered_map<strings::String, Int, strings::StringHasher> map_;
+      std::vector<strings::String> strings_;
+    };
+
+    /// Returns the chunk-local code of _val.
+    static Int encode(const std::string_view _val, LocalEncoding *_enc) {
+      auto str = strings::String(_val.data(), _val.size());
+      const auto [it, inserted] = _enc->map_.try_emplace(
+          std::move(str), static_cast<Int>(_enc->strings_.size()));
+      if (inserted) {
+        _enc->strings_.push_back(it->first);
+      }
+      return it->second;
+    }
 
-  auto unused_floats = make_vectors<Float>(_schema.unused_floats().size());
+    LocalEncoding categories_;
+    std::vector<std::vector<Int>> categoricals_;
+    std::vector<std::pair<size_t, size_t>> corrupted_lines_;
+    std::vector<std::vector<Int>> join_keys_;
+    LocalEncoding join_keys_encoding_;
+    size_t num_lines_ = 0;
+    std::vector<std::vector<Float>> numericals_;
+    std::vector<std::vector<Float>> targets_;
+    std::vector<std::vector<strings::String>> text_;
+    std::vector<std::vector<Float>> time_stamps_;
+    std::vector<std::vector<Float>> unused_floats_;
+    std::vector<std::vector<strings::String>> unused_strings_;
+  };
 
-  auto unused_strings =
-      make_vectors<strings::String>(_schema.unused_strings().size());
+  const auto &csv_colnames = _reader.colnames();
 
   const auto df_colnames = concat_colnames(_schema);
 
@@ -1008,60 +1047,172 @@ void DataFrame::from_reader(const std::shared_ptr<io::Reader> &_reader,
         static_cast<size_t>(std::distance(csv_colnames.begin(), it)));
   }
 
+  auto &thread_pool = multithreading::ThreadPool::get();
+
+  const auto chunk_size = std::max(
+      min_chunk_size, _reader.size() / (4 * thread_pool.num_threads() + 1));
+
+  const auto chunks = _reader.make_chunks(_skip, chunk_size);
+
+  auto parsed = std::vector<Chunk>(chunks.size());
+
+  const auto time_stamp_parser = io::TimeStampParser(_time_formats);
+
+  const auto parse_chunk = [&](const size_t _i) {
+    auto &chunk = parsed[_i];
+
+    chunk.categoricals_.resize(_schema.categoricals().size());
+    chunk.join_keys_.resize(_schema.join_keys().size());
+    chunk.numericals_.resize(_schema.numericals().size());
+    chunk.targets_.resize(_schema.targets().size());
+    chunk.text_.resize(_schema.text().size());
+    chunk.time_stamps_.resize(_schema.time_stamps().size());
+    chunk.unused_floats_.resize(_schema.unused_floats().size());
+    chunk.unused_strings_.resize(_schema.unused_strings().size());
+
+    auto remaining = chunks[_i];
+
+    auto fields = std::vector<std::string_view>();
+
+    auto buffer = std::string();
+
+    while (remaining.size() > 0) {
+      _reader.split_line(io::ParallelCSVReader::pop_line(&remaining), &fields,
+                         &buffer);
+
+      ++chunk.num_lines_;
+
+      if (fields.size() == 0) {
+        continue;
+      } else if (fields.size() != csv_colnames.size()) {
+        chunk.corrupted_lines_.emplace_back(chunk.num_lines_, fields.size());
+        continue;
+      }
+
+      size_t col = 0;
+
+      const auto next_field = [&]() -> std::string_view {
+        return fields[colname_indices[col++]];
+      };
+
+      const auto next_string = [&]() -> std::string {
+        return std::string(next_field());
+      };
+
+      for (auto &vec : chunk.categoricals_)
+        vec.push_back(Chunk::encode(next_field(), &chunk.categories_));
+
+      for (auto &vec : chunk.join_keys_)
+        vec.push_back(Chunk::encode(next_field(), &chunk.join_keys_encoding_));
+
+      for (auto &vec : chunk.numericals_)
+        vec.push_back(database::Getter::get_double(next_string()));
+
+      for (auto &vec : chunk.targets_)
+        vec.push_back(database::Getter::get_double(next_string()));
+
+      for (auto &vec : chunk.text_)
+        vec.emplace_back(strings::String::parse_null(next_string()));
+
+      for (auto &vec : chunk.time_stamps_)
+        vec.push_back(
+            database::Getter::get_time_stamp(next_field(), time_stamp_parser));
+
+      for (auto &vec : chunk.unused_floats_)
+        vec.push_back(database::Getter::get_double(next_string()));
+
+      for (auto &vec : chunk.unused_strings_)
+        vec.emplace_back(strings::String::parse_null(next_string()));
+
+      assert_true(col == colname_indices.size());
+    }
+  };
+
+  thread_pool.parallel_for(parsed.size(), parse_chunk);
+
+  // The global encodings are updated in the order of the chunks, which only
+  // involves the distinct strings of every chunk.
+  auto category_codes = std::vector<std::vector<Int>>(parsed.size());
+
+  auto join_key_codes = std::vector<std::vector<Int>>(parsed.size());
+
   size_t line_count = 0;
 
-  for (size_t i = 0; i < _skip; ++i) {
-    _reader->next_line();
+  for (size_t i = 0; i < parsed.size(); ++i) {
+    for (const auto &str : parsed[i].categories_.strings_) {
+      category_codes[i].push_back((*categories_)[str]);
+    }
+
+    for (const auto &str : parsed[i].join_keys_encoding_.strings_) {
+      join_key_codes[i].push_back((*join_keys_encoding_)[str]);
+    }
+
+    for (const auto &[line, num_fields] : parsed[i].corrupted_lines_) {
+      std::cout << "Corrupted line: " << line_count + line << ". Expected "
+                << csv_colnames.size() << " fields, saw " << num_fields << "."
+                << std::endl;
+    }
+
+    line_count += parsed[i].num_lines_;
   }
 
-  while (!_reader->eof()) {
-    const auto line = _reader->next_line();
+  const auto translate_codes = [&](const size_t _i) {
+    for (auto &vec : parsed[_i].categoricals_) {
+      for (auto &val : vec) val = category_codes[_i][val];
+    }
+
+    for (auto &vec : parsed[_i].join_keys_) {
+      for (auto &val : vec) val = join_key_codes[_i][val];
+    }
+  };
 
-    ++line_count;
+  thread_pool.parallel_for(parsed.size(), translate_codes);
 
-    if (line.size() == 0) {
-      continue;
-    } else if (line.size() != csv_colnames.size()) {
-      std::cout << "Corrupted line: " << line_count << ". Expected "
-                << csv_colnames.size() << " fields, saw " << line.size() << "."
-                << std::endl;
-      continue;
+  const auto concat = [&parsed](const auto &_get, auto *_vectors) {
+    for (size_t j = 0; j < _vectors->size(); ++j) {
+      auto &vec = *_vectors->at(j);
+      for (auto &chunk : parsed) {
+        auto &part = _get(chunk).at(j);
+        vec.insert(vec.end(), std::make_move_iterator(part.begin()),
+                   std::make_move_iterator(part.end()));
+      }
     }
+  };
 
-    size_t col = 0;
+  auto categoricals = make_vectors<Int>(_schema.categoricals().size());
 
-    for (auto &vec : categoricals)
-      vec->push_back((*categories_)[line[colname_indices[col++]]]);
+  auto join_keys = make_vectors<Int>(_schema.join_keys().size());
 
-    for (auto &vec : join_keys)
-      vec->push_back((*join_keys_encoding_)[line[colname_indices[col++]]]);
+  auto numericals = make_vectors<Float>(_schema.numericals().size());
 
-    for (auto &vec : numericals)
-      vec->push_back(
-          database::Getter::get_double(line[colname_indices[col++]]));
+  auto targets = make_vectors<Float>(_schema.targets().size());
 
-    for (auto &vec : targets)
-      vec->push_back(
-          database::Getter::get_double(line[colname_indices[col++]]));
+  auto text = make_vectors<strings::String>(_schema.text().size());
 
-    for (auto &vec : text)
-      vec->emplace_back(
-          strings::String::parse_null(line[colname_indices[col++]]));
+  auto time_stamps = make_vectors<Float>(_schema.time_stamps().size());
 
-    for (auto &vec : time_stamps)
-      vec->push_back(database::Getter::get_time_stamp(
-          line[colname_indices[col++]], _time_formats));
+  auto unused_floats = make_vectors<Float>(_schema.unused_floats().size());
 
-    for (auto &vec : unused_floats)
-      vec->push_back(
-          database::Getter::get_double(line[colname_indices[col++]]));
+  auto unused_strings =
+      make_vectors<strings::String>(_schema.unused_strings().size());
 
-    for (auto &vec : unused_strings)
-      vec->emplace_back(
-          strings::String::parse_null(line[colname_indices[col++]]));
+  concat([](Chunk &_c) -> auto & { return _c.categoricals_; }, &categoricals);
 
-    assert_true(col == colname_indices.size());
-  }
+  concat([](Chunk &_c) -> auto & { return _c.join_keys_; }, &join_keys);
+
+  concat([](Chunk &_c) -> auto & { return _c.numericals_; }, &numericals);
+
+  concat([](Chunk &_c) -> auto & { return _c.targets_; }, &targets);
+
+  concat([](Chunk &_c) -> auto & { return _c.text_; }, &text);
+
+  concat([](Chunk &_c) -> auto & { return _c.time_stamps_; }, &time_stamps);
+
+  concat([](Chunk &_c) -> auto & { return _c.unused_floats_; },
+         &unused_floats);
+
+  concat([](Chunk &_c) -> auto & { return _c.unused_strings_; },
+         &unused_strings);
 
   auto df = DataFrame(name(), categories_, join_keys_encoding_, make_pool());
 
@@ -1342,21 +1493,12 @@ void DataFrame::load(const std::string &_path) {
     build_history_ = commands::Fingerprint::from_json(*build_history);
   }
 
-  categoricals_ = load_columns<Int>(_path, "categorical_");
-
-  join_keys_ = load_columns<Int>(_path, "join_key_");
-
-  numericals_ = load_columns<Float>(_path, "numerical_");
-
-  targets_ = load_columns<Float>(_path, "target_");
-
-  text_ = load_columns<strings::String>(_path, "text_");
-
-  time_stamps_ = load_columns<Float>(_path, "time_stamp_");
-
-  unused_floats_ = load_columns<Float>(_path, "unused_float_");
-
-  unused_strings_ = load_columns<strings::String>(_path, "unused_string_");
+  if (Poco::File(_path + COLUMN_FILE).exists()) {
+    const auto reader = ColumnFileReader(_path + COLUMN_FILE);
+    load_all_columns(reader);
+  } else {
+    load_all_columns(_path);
+  }
 
   check_plausibility();
 }
@@ -1560,28 +1702,33 @@ std::string DataFrame::role(const std::string &_name) const {
 // ----------------------------------------------------------------------------
 
 void DataFrame::save(const std::string &_temp_dir, const std::string &_path,
-                     const std::string &_name) const {
+                     const std::string &_name,
+                     const std::string &_compression) const {
   auto tfile = Poco::TemporaryFile(_temp_dir);
 
   tfile.createDirectories();
 
   const auto tpath = tfile.path() + "/";
 
-  save_matrices(categoricals_, tpath, "categorical_");
+  auto writer = ColumnFileWriter(tpath + COLUMN_FILE, _compression);
+
+  save_columns(categoricals_, "categorical_", &writer);
+
+  save_columns(join_keys_, "join_key_", &writer);
 
-  save_matrices(join_keys_, tpath, "join_key_");
+  save_columns(numericals_, "numerical_", &writer);
 
-  save_matrices(numericals_, tpath, "numerical_");
+  save_columns(targets_, "target_", &writer);
 
-  save_matrices(targets_, tpath, "target_");
+  save_columns(text_, "text_", &writer);
 
-  save_matrices(text_, tpath, "text_");
+  save_columns(time_stamps_, "time_stamp_", &writer);
 
-  save_matrices(time_stamps_, tpath, "time_stamp_");
+  save_columns(unused_floats_, "unused_float_", &writer);
 
-  save_matrices(unused_floats_, tpath, "unused_float_");
+  save_columns(unused_strings_, "unused_string_", &writer);
 
-  save_matrices(unused_strings_, tpath, "unused_string_");
+  writer.close();
 
   save_text(tpath, "frozen.txt", frozen_ ? "true" : "false");
 
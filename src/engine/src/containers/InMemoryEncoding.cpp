@@ -10,19 +10,45 @@
 #include "debug/assert_true.hpp"
 #include "helpers/NullChecker.hpp"
 
+#include <algorithm>
+#include <utility>
+
 namespace containers {
 
 InMemoryEncoding::InMemoryEncoding(
     const std::shared_ptr<const InMemoryEncoding> _subencoding)
     : null_value_("NULL"),
       subencoding_(_subencoding),
-      subsize_(_subencoding ? _subencoding->size() : 0),
-      vector_(std::make_shared<std::vector<strings::String>>(0)) {}
+      num_strings_(0),
+      subsize_(_subencoding ? _subencoding->size() : 0) {}
 
 void InMemoryEncoding::append(const InMemoryEncoding& _other,
                               bool _include_subencoding) {
-  for (auto& elem : *_other.vector_) {
-    (*this)[elem.str()];
+  // num_strings_ is incremented before the string is set, so we only read
+  // the strings that have been published through the slots. Their positions
+  // are sorted, so the strings are appended in the order they were inserted.
+  auto published = std::vector<size_t>();
+
+  for (const auto& shard : _other.shards_) {
+    const auto* table = shard.table_.load(std::memory_order_acquire);
+
+    if (!table) {
+      continue;
+    }
+
+    for (size_t s = 0; s < table->capacity_; ++s) {
+      const auto slot = table->slots_[s].load(std::memory_order_acquire);
+
+      if (slot != EMPTY_SLOT) {
+        published.push_back(slot - 1);
+      }
+    }
+  }
+
+  std::ranges::sort(published);
+
+  for (const auto ix : published) {
+    (*this)[_other.strings_[ix]];
   }
 
   if (_include_subencoding && _other.subencoding_) {
@@ -32,20 +58,116 @@ void InMemoryEncoding::append(const InMemoryEncoding& _other,
 
 // ----------------------------------------------------------------------------
 
-Int InMemoryEncoding::insert(const strings::String& _val) {
-  assert_true(map_.find(_val) == map_.end());
+void InMemoryEncoding::clear() {
+  for (auto& shard : shards_) {
+    shard.num_strings_ = 0;
+    shard.table_ = nullptr;
+    shard.tables_.clear();
+  }
+
+  strings_.clear();
+
+  num_strings_ = 0;
+}
+
+// ----------------------------------------------------------------------------
+
+Int InMemoryEncoding::find(const Shard& _shard,
+                           const strings::String& _val) const {
+  const auto* table = _shard.table_.load(std::memory_order_acquire);
+
+  if (!table) {
+    return -1;
+  }
+
+  const auto mask = table->capacity_ - 1;
+
+  for (auto s = _val.hash() & mask;; s = (s + 1) & mask) {
+    const auto slot = table->slots_[s].load(std::memory_order_acquire);
+
+    if (slot == EMPTY_SLOT) {
+      return -1;
+    }
+
+    if (strings_[slot - 1] == _val) {
+      return static_cast<Int>(slot - 1 + subsize_);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void InMemoryEncoding::grow(Shard* _shard) {
+  const auto* old_table = _shard->table_.load(std::memory_order_relaxed);
+
+  const auto old_capacity = old_table ? old_table->capacity_ : 0;
+
+  if (2 * (_shard->num_strings_ + 1) <= old_capacity) {
+    return;
+  }
+
+  auto new_table =
+      std::make_unique<Table>(std::max<size_t>(16, 2 * old_capacity));
+
+  const auto mask = new_table->capacity_ - 1;
 
-  const auto ix = static_cast<Int>(vector_->size() + subsize_);
+  for (size_t i = 0; i < old_capacity; ++i) {
+    const auto slot = old_table->slots_[i].load(std::memory_order_relaxed);
+
+    if (slot == EMPTY_SLOT) {
+      continue;
+    }
 
-  map_[_val] = ix;
+    auto s = strings_[slot - 1].hash() & mask;
+
+    while (new_table->slots_[s].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+      s = (s + 1) & mask;
+    }
+
+    new_table->slots_[s].store(slot, std::memory_order_relaxed);
+  }
 
-  vector_->push_back(_val);
+  _shard->table_.store(new_table.get(), std::memory_order_release);
 
-  return ix;
+  _shard->tables_.emplace_back(std::move(new_table));
 }
 
 // ----------------------------------------------------------------------------
 
+Int InMemoryEncoding::insert(Shard* _shard, const strings::String& _val) {
+  const auto lock = std::lock_guard<std::mutex>(_shard->mutex_);
+
+  // Another thread might have inserted _val while we were waiting.
+  const auto existing = find(*_shard, _val);
+
+  if (existing != -1) {
+    return existing;
+  }
+
+  grow(_shard);
+
+  const auto ix = num_strings_.fetch_add(1);
+
+  strings_.set(ix, _val);
+
+  auto* table = _shard->table_.load(std::memory_order_relaxed);
+
+  const auto mask = table->capacity_ - 1;
+
+  auto s = _val.hash() & mask;
+
+  while (table->slots_[s].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+    s = (s + 1) & mask;
+  }
+
+  // The release store publishes the string to the readers.
+  table->slots_[s].store(ix + 1, std::memory_order_release);
+
+  ++_shard->num_strings_;
+
+  return static_cast<Int>(ix + subsize_);
+}
+
 strings::String InMemoryEncoding::int_to_string(const Int _i) const {
   if (_i < 0 || static_cast<size_t>(_i) >= size()) {
     return null_value_;
@@ -59,10 +181,10 @@ strings::String InMemoryEncoding::int_to_string(const Int _i) const {
     if (_i < subsize_) {
       return (*subencoding_)[_i];
     } else {
-      return (*vector_)[_i - subsize_];
+      return strings_[_i - subsize_];
     }
   } else {
-    return (*vector_)[_i];
+    return strings_[_i];
   }
 }
 
@@ -105,15 +227,19 @@ Int InMemoryEncoding::string_to_int(const strings::String& _val) {
 
   // -----------------------------------
   // If it cannot be found in the subencoding,
-  // check/update your own values.
+  // check/update your own values. Most strings
+  // have been seen before, so we try without
+  // locking first.
 
-  const auto it = map_.find(_val);
+  auto& shard = shards_[shard_ix(_val)];
 
-  if (it == map_.end()) {
-    return insert(_val);
-  } else {
-    return it->second;
+  const auto ix = find(shard, _val);
+
+  if (ix != -1) {
+    return ix;
   }
+
+  return insert(&shard, _val);
 }
 
 // ----------------------------------------------------------------------------
@@ -142,15 +268,7 @@ Int InMemoryEncoding::string_to_int(const strings::String& _val) const {
   // If it cannot be found in the subencoding,
   // check your own values.
 
-  const auto str = strings::String(_val);
-
-  const auto it = map_.find(str);
-
-  if (it == map_.end()) {
-    return -1;
-  } else {
-    return it->second;
-  }
+  return find(shards_[shard_ix(_val)], _val);
 }
 
 // ----------------------------------------------------------------------------
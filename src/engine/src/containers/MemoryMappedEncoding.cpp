@@ -8,6 +8,12 @@
 #include "containers/MemoryMappedEncoding.hpp"
 
 #include "helpers/NullChecker.hpp"
+#include "multithreading/ThreadPool.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <vector>
 
 namespace containers {
 
@@ -34,10 +40,22 @@ void MemoryMappedEncoding::allocate() {
 
 void MemoryMappedEncoding::append(const MemoryMappedEncoding& _other,
                                   bool _include_subencoding) {
-  const auto& str_vec = _other.string_vector();
+  auto strings = std::vector<strings::String>();
+
+  {
+    const auto lock = std::shared_lock<std::shared_mutex>(_other.mutex_);
+
+    const auto& str_vec = _other.string_vector();
+
+    strings.reserve(str_vec.size());
 
-  for (size_t i = 0; i < str_vec.size(); ++i) {
-    (*this)[str_vec[i]];
+    for (size_t i = 0; i < str_vec.size(); ++i) {
+      strings.push_back(str_vec[i]);
+    }
+  }
+
+  for (const auto& str : strings) {
+    (*this)[str];
   }
 
   if (_include_subencoding && _other.subencoding_) {
@@ -61,6 +79,40 @@ void MemoryMappedEncoding::deallocate() {
 
 // ----------------------------------------------------------------------------
 
+Int MemoryMappedEncoding::find(const strings::String& _val) const {
+  const auto opt = btree()[_val.hash()];
+
+  if (!opt) {
+    return NOT_FOUND;
+  }
+
+  // -----------------------------------
+
+  const auto& p = rownums()[*opt];
+
+  // -----------------------------------
+
+  if (p.first != HASH_COLLISION) {
+    return string_vector()[p.first - subsize_] == _val ? p.first : NOT_FOUND;
+  }
+
+  // -----------------------------------
+
+  assert_true(p.second.is_allocated());
+
+  for (auto i : p.second) {
+    if (string_vector()[i - subsize_] == _val) {
+      return i;
+    }
+  }
+
+  // -----------------------------------
+
+  return NOT_FOUND;
+}
+
+// ----------------------------------------------------------------------------
+
 Int MemoryMappedEncoding::insert(const strings::String& _str,
                                  const std::optional<size_t>& _opt) {
   const auto ix = static_cast<Int>(string_vector().size() + subsize_);
@@ -103,15 +155,13 @@ strings::String MemoryMappedEncoding::int_to_string(const Int _i) const {
 
   assert_true(static_cast<size_t>(_i) < size());
 
-  if (subencoding_) {
-    if (_i < subsize_) {
-      return subencoding()[_i];
-    } else {
-      return string_vector()[_i - subsize_];
-    }
-  } else {
-    return string_vector()[_i];
+  if (subencoding_ && _i < subsize_) {
+    return subencoding()[_i];
   }
+
+  const auto lock = std::shared_lock<std::shared_mutex>(mutex_);
+
+  return string_vector()[_i - subsize_];
 }
 
 // ----------------------------------------------------------------------------
@@ -122,70 +172,113 @@ MemoryMappedEncoding& MemoryMappedEncoding::operator=(
 
   clear();
 
-  for (const auto& val : _vector) {
-    (*this)[val];
-  }
+  const auto lock = std::unique_lock<std::shared_mutex>(mutex_);
 
-  return *this;
-}
+  // Constructing the strings computes their hashes, which is the expensive
+  // part, so we do that in parallel.
+  auto strings = std::vector<strings::String>(_vector.size());
 
-// ----------------------------------------------------------------------------
+  auto& thread_pool = multithreading::ThreadPool::get();
 
-Int MemoryMappedEncoding::string_to_int(const strings::String& _val) {
-  if (helpers::NullChecker::is_null(_val)) {
-    return NOT_FOUND;
-  }
+  const auto num_chunks = std::min(_vector.size(), thread_pool.num_threads());
 
-  // -----------------------------------
-  // Note that the subencoding is const
-  // - it cannot be updated.
+  const auto make_strings = [&_vector, &strings,
+                             num_chunks](const size_t _chunk) {
+    const auto begin = _chunk * _vector.size() / num_chunks;
+    const auto end = (_chunk + 1) * _vector.size() / num_chunks;
+    for (size_t i = begin; i < end; ++i) {
+      strings[i] = strings::String(_vector[i]);
+    }
+  };
 
-  if (subencoding_) {
-    const auto result = subencoding()[_val];
+  thread_pool.parallel_for(num_chunks, make_strings);
 
-    if (result != NOT_FOUND) {
-      return result;
+  // The positions of all strings sorted by hash. Identical strings are
+  // sorted by position, so we keep the first one, just like operator[].
+  auto order = std::vector<size_t>(strings.size());
+
+  std::iota(order.begin(), order.end(), 0);
+
+  std::erase_if(order, [&strings](const size_t _i) {
+    return helpers::NullChecker::is_null(strings[_i]);
+  });
+
+  std::sort(order.begin(), order.end(),
+            [&strings](const size_t _i, const size_t _j) {
+              return std::make_pair(strings[_i].hash(), _i) <
+                     std::make_pair(strings[_j].hash(), _j);
+            });
+
+  // All strings with the same hash, but no duplicates.
+  auto groups = std::vector<std::vector<size_t>>();
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    const auto& str = strings[order[i]];
+
+    if (i == 0 || strings[order[i - 1]].hash() != str.hash()) {
+      groups.emplace_back();
     }
-  }
 
-  // -----------------------------------
+    auto& group = groups.back();
 
-  const auto opt = btree()[_val.hash()];
+    const bool is_duplicate =
+        std::any_of(group.begin(), group.end(),
+                    [&strings, &str](const size_t _j) {
+                      return strings[_j] == str;
+                    });
 
-  if (!opt) {
-    return insert(_val, opt);
+    if (!is_duplicate) {
+      group.push_back(order[i]);
+    }
   }
 
-  // -----------------------------------
+  // The strings are encoded in the order in which they appear in _vector.
+  auto is_kept = std::vector<bool>(strings.size(), false);
 
-  const auto& p = rownums()[*opt];
+  for (const auto& group : groups) {
+    for (const auto i : group) {
+      is_kept[i] = true;
+    }
+  }
 
-  // -----------------------------------
+  auto ix = std::vector<Int>(strings.size(), NOT_FOUND);
 
-  if (p.first != HASH_COLLISION &&
-      string_vector()[p.first - subsize_] == _val) {
-    return p.first;
+  for (size_t i = 0; i < strings.size(); ++i) {
+    if (is_kept[i]) {
+      ix[i] = static_cast<Int>(string_vector().size());
+      string_vector().push_back(strings[i]);
+    }
   }
 
-  // -----------------------------------
+  // The groups are already sorted by hash, so the BTree can be built
+  // bottom-up.
+  auto pairs = std::vector<std::pair<size_t, size_t>>();
+
+  pairs.reserve(groups.size());
 
-  if (p.first == HASH_COLLISION) {
-    assert_true(p.second.is_allocated());
-    for (auto i : p.second) {
-      if (string_vector()[i - subsize_] == _val) {
-        return i;
+  for (const auto& group : groups) {
+    if (group.size() == 1) {
+      rownums().push_back(
+          std::make_pair(ix[group[0]], memmap::VectorImpl<Int>()));
+    } else {
+      auto collisions = memmap::Vector<Int>(pool_);
+      for (const auto i : group) {
+        collisions.push_back(ix[i]);
       }
+      rownums().push_back(
+          std::make_pair(HASH_COLLISION, collisions.yield_impl()));
     }
+    pairs.emplace_back(strings[group[0]].hash(), rownums().size() - 1);
   }
 
-  // -----------------------------------
+  btree().bulk_load(pairs);
 
-  return insert(_val, opt);
+  return *this;
 }
 
 // ----------------------------------------------------------------------------
 
-Int MemoryMappedEncoding::string_to_int(const strings::String& _val) const {
+Int MemoryMappedEncoding::string_to_int(const strings::String& _val) {
   if (helpers::NullChecker::is_null(_val)) {
     return NOT_FOUND;
   }
@@ -195,7 +288,7 @@ Int MemoryMappedEncoding::string_to_int(const strings::String& _val) const {
   // - it cannot be updated.
 
   if (subencoding_) {
-    const auto result = (*subencoding_)[_val];
+    const auto result = subencoding()[_val];
 
     if (result != NOT_FOUND) {
       return result;
@@ -203,37 +296,60 @@ Int MemoryMappedEncoding::string_to_int(const strings::String& _val) const {
   }
 
   // -----------------------------------
+  // Most strings have been seen before, so
+  // we try with a shared lock first.
 
-  const auto opt = btree()[_val.hash()];
+  {
+    const auto lock = std::shared_lock<std::shared_mutex>(mutex_);
 
-  if (!opt) {
-    return NOT_FOUND;
+    const auto ix = find(_val);
+
+    if (ix != NOT_FOUND) {
+      return ix;
+    }
   }
 
   // -----------------------------------
+  // Another thread might have inserted _val
+  // while we were waiting for the lock.
 
-  const auto& p = rownums()[*opt];
+  const auto lock = std::unique_lock<std::shared_mutex>(mutex_);
 
-  // -----------------------------------
+  const auto ix = find(_val);
 
-  if (p.first != HASH_COLLISION) {
-    return string_vector()[p.first - subsize_] == _val ? p.first : NOT_FOUND;
+  if (ix != NOT_FOUND) {
+    return ix;
+  }
+
+  return insert(_val, btree()[_val.hash()]);
+}
+
+// ----------------------------------------------------------------------------
+
+Int MemoryMappedEncoding::string_to_int(const strings::String& _val) const {
+  if (helpers::NullChecker::is_null(_val)) {
+    return NOT_FOUND;
   }
 
   // -----------------------------------
+  // Note that the subencoding is const
+  // - it cannot be updated.
 
-  assert_true(p.second.is_allocated());
+  if (subencoding_) {
+    const auto result = (*subencoding_)[_val];
 
-  for (auto i : p.second) {
-    if (string_vector()[i - subsize_] == _val) {
-      return i;
+    if (result != NOT_FOUND) {
+      return result;
     }
   }
 
   // -----------------------------------
 
-  return NOT_FOUND;
+  const auto lock = std::shared_lock<std::shared_mutex>(mutex_);
+
+  return find(_val);
 }
 
 // ----------------------------------------------------------------------------
+
 }  // namespace containers
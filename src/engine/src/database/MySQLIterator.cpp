@@ -21,7 +21,7 @@ MySQLIterator::MySQLIterator(const std::shared_ptr<MYSQL>& _connection,
       connection_(_connection),
       num_cols_(0),
       row_(NULL),
-      time_formats_(_time_formats) {
+      time_stamp_parser_(_time_formats) {
   result_ = execute(_sql);
 
   if (!result_) {
@@ -152,7 +152,7 @@ Float MySQLIterator::get_time_stamp() {
     return static_cast<Float>(NAN);
   }
 
-  return Getter::get_time_stamp(str, time_formats_);
+  return Getter::get_time_stamp(str, time_stamp_parser_);
 }
 
 // ----------------------------------------------------------------------------
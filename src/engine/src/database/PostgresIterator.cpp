@@ -24,7 +24,7 @@ PostgresIterator::PostgresIterator(
       connection_(_connection),
       end_required_(false),
       rownum_(0),
-      time_formats_(_time_formats) {
+      time_stamp_parser_(_time_formats) {
   execute("BEGIN");
 
   end_required_ = true;
@@ -152,7 +152,7 @@ Float PostgresIterator::get_time_stamp() {
     return static_cast<Float>(NAN);
   }
 
-  return Getter::get_time_stamp(std::string(str), time_formats_);
+  return Getter::get_time_stamp(str, time_stamp_parser_);
 }
 
 // ----------------------------------------------------------------------------
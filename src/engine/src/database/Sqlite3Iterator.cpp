@@ -23,7 +23,7 @@ Sqlite3Iterator::Sqlite3Iterator(
                                           std::chrono::milliseconds(1000))),
       stmt_(std::unique_ptr<sqlite3_stmt, int (*)(sqlite3_stmt*)>(
           nullptr, sqlite3_finalize)),
-      time_formats_(_time_formats) {
+      time_stamp_parser_(_time_formats) {
   // We set this to nullptr, so it will not be deleted if doesn't point to
   // anything.
   // https://en.cppreference.com/w/cpp/memory/unique_ptr/operator_bool
@@ -162,9 +162,8 @@ Float Sqlite3Iterator::get_time_stamp() {
 
   // sqlite3_column_text(...) returns NULL when the value is NULL.
   if (ptr) {
-    const std::string str = reinterpret_cast<const char*>(ptr);
-
-    val = Getter::get_time_stamp(str, time_formats_);
+    val = Getter::get_time_stamp(reinterpret_cast<const char*>(ptr),
+                                 time_stamp_parser_);
   } else {
     val = NAN;
   }
@@ -10,8 +10,23 @@
 namespace engine::config {
 
 EngineOptions::EngineOptions(const ReflectionType& _obj)
-    : in_memory_(IN_MEMORY), port_(_obj.get<"port">()) {}
+    : compression_(_obj.get<"compression">().value_or("none")),
+      huge_pages_(_obj.get<"hugePages">().value_or(false)),
+      in_memory_(IN_MEMORY),
+      max_sessions_(_obj.get<"maxSessions">().value_or(16)),
+      memory_mapping_advice_(
+          _obj.get<"memoryMappingAdvice">().value_or("normal")),
+      num_threads_(_obj.get<"numThreads">().value_or(0)),
+      port_(_obj.get<"port">()),
+      session_timeout_(_obj.get<"sessionTimeout">().value_or(60)) {}
 
-EngineOptions::EngineOptions() : port_(1708) {}
+EngineOptions::EngineOptions()
+    : compression_("none"),
+      huge_pages_(false),
+      max_sessions_(16),
+      memory_mapping_advice_("normal"),
+      num_threads_(0),
+      port_(1708),
+      session_timeout_(60) {}
 
 }  // namespace engine::config
@@ -80,10 +80,28 @@ void Options::parse_flags(int _argc, char* argv[]) {
 
     bool success = parse_size_t(arg, "engine-port", &(engine_.port_));
 
+    success =
+        success || parse_string(arg, "compression", &(engine_.compression_));
+
+    success =
+        success || parse_boolean(arg, "huge-pages", &(engine_.huge_pages_));
+
     success = success || parse_boolean(arg, "in-memory", &(engine_.in_memory_));
 
+    success = success ||
+              parse_size_t(arg, "max-sessions", &(engine_.max_sessions_));
+
+    success = success || parse_string(arg, "memory-mapping-advice",
+                                      &(engine_.memory_mapping_advice_));
+
+    success =
+        success || parse_size_t(arg, "num-threads", &(engine_.num_threads_));
+
     success = success || parse_string(arg, "project", &(engine_.project_));
 
+    success = success || parse_size_t(arg, "session-timeout",
+                                      &(engine_.session_timeout_));
+
     success = success || parse_size_t(arg, "http-port", &(monitor_.http_port_));
 
     success = success || parse_size_t(arg, "tcp-port", &(monitor_.tcp_port_));
@@ -12,9 +12,21 @@
 #include "engine/handlers/ArrowSocketInputStream.hpp"
 #include "engine/handlers/ArrowSocketOutputStream.hpp"
 #include "io/Parser.hpp"
+#include "multithreading/ThreadPool.hpp"
 
+#include <Poco/Glob.h>
+#include <parquet/statistics.h>
 #include <range/v3/view/concat.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <ranges>
+#include <set>
+#include <type_traits>
+
 namespace engine {
 namespace handlers {
 
@@ -38,6 +50,33 @@ std::shared_ptr<arrow::Table> ArrowHandler::df_to_table(
 
 // ----------------------------------------------------------------------------
 
+std::vector<bool> ArrowHandler::apply_filters(
+    const std::shared_ptr<arrow::Table>& _table,
+    const std::vector<commands::ParquetFilter>& _filters) const {
+  auto condition = std::vector<bool>(_table->num_rows(), true);
+
+  for (const auto& filter : _filters) {
+    const auto col = to_column<Float>(nullptr, filter.column(),
+                                      _table->GetColumnByName(filter.column()));
+
+    for (size_t i = 0; i < col.nrows(); ++i) {
+      const auto val = col[i];
+
+      const bool passes = !std::isnan(val) &&
+                          (!filter.lower() || val >= *filter.lower()) &&
+                          (!filter.upper() || val <= *filter.upper());
+
+      if (!passes) {
+        condition[i] = false;
+      }
+    }
+  }
+
+  return condition;
+}
+
+// ----------------------------------------------------------------------------
+
 std::vector<std::shared_ptr<arrow::ChunkedArray>> ArrowHandler::extract_arrays(
     const containers::DataFrame& _df) const {
   using Array = std::shared_ptr<arrow::ChunkedArray>;
@@ -157,6 +196,115 @@ std::shared_ptr<arrow::Schema> ArrowHandler::df_to_schema(
 
 // ----------------------------------------------------------------------------
 
+std::vector<std::string> ArrowHandler::find_parquet_files(
+    const std::string& _fname) {
+  if (std::filesystem::is_directory(_fname)) {
+    auto files = std::vector<std::string>();
+
+    for (const auto& entry :
+         std::filesystem::recursive_directory_iterator(_fname)) {
+      if (entry.is_regular_file() && entry.path().extension() == ".parquet") {
+        files.push_back(entry.path().string());
+      }
+    }
+
+    if (files.empty()) {
+      throw std::runtime_error("No parquet files found in '" + _fname + "'.");
+    }
+
+    std::sort(files.begin(), files.end());
+
+    return files;
+  }
+
+  if (_fname.find_first_of("*?[") == std::string::npos) {
+    return {_fname};
+  }
+
+  auto matches = std::set<std::string>();
+
+  Poco::Glob::glob(_fname, matches);
+
+  if (matches.empty()) {
+    throw std::runtime_error("No files match '" + _fname + "'.");
+  }
+
+  return std::vector<std::string>(matches.begin(), matches.end());
+}
+
+// ----------------------------------------------------------------------------
+
+bool ArrowHandler::may_pass_filters(
+    const parquet::RowGroupMetaData& _row_group,
+    const std::vector<commands::ParquetFilter>& _filters) {
+  const auto schema = _row_group.schema();
+
+  for (const auto& filter : _filters) {
+    const auto ix = schema->ColumnIndex(filter.column());
+
+    if (ix < 0) {
+      continue;
+    }
+
+    const auto column = _row_group.ColumnChunk(ix);
+
+    const auto stats = column->statistics();
+
+    // The statistics of columns with a logical type, like time stamps, are
+    // not expressed in the same units as the filters.
+    if (!column->is_stats_set() || !stats || !stats->HasMinMax() ||
+        !schema->Column(ix)->logical_type()->is_none()) {
+      continue;
+    }
+
+    Float min = 0.0;
+
+    Float max = 0.0;
+
+    switch (stats->physical_type()) {
+      case parquet::Type::DOUBLE: {
+        const auto& s = static_cast<const parquet::DoubleStatistics&>(*stats);
+        min = s.min();
+        max = s.max();
+        break;
+      }
+
+      case parquet::Type::FLOAT: {
+        const auto& s = static_cast<const parquet::FloatStatistics&>(*stats);
+        min = static_cast<Float>(s.min());
+        max = static_cast<Float>(s.max());
+        break;
+      }
+
+      case parquet::Type::INT32: {
+        const auto& s = static_cast<const parquet::Int32Statistics&>(*stats);
+        min = static_cast<Float>(s.min());
+        max = static_cast<Float>(s.max());
+        break;
+      }
+
+      case parquet::Type::INT64: {
+        const auto& s = static_cast<const parquet::Int64Statistics&>(*stats);
+        min = static_cast<Float>(s.min());
+        max = static_cast<Float>(s.max());
+        break;
+      }
+
+      default:
+        continue;
+    }
+
+    if ((filter.lower() && max < *filter.lower()) ||
+        (filter.upper() && min > *filter.upper())) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// ----------------------------------------------------------------------------
+
 parquet::Compression::type ArrowHandler::parse_compression(
     const std::string& _compression) const {
   if (_compression == "brotli") {
@@ -185,37 +333,232 @@ parquet::Compression::type ArrowHandler::parse_compression(
 
 // ----------------------------------------------------------------------------
 
-std::shared_ptr<arrow::Table> ArrowHandler::read_parquet(
-    const std::string& _filename) const {
-  const auto pool = arrow::default_memory_pool();
+containers::DataFrame ArrowHandler::read_parquet(
+    const std::string& _fname, const std::string& _name,
+    const containers::Schema& _schema,
+    const std::vector<commands::ParquetFilter>& _filters) const {
+  const auto pool = options_.make_pool();
 
-  const auto result = arrow::io::ReadableFile::Open(_filename);
+  std::optional<containers::DataFrame> df;
 
-  if (!result.ok()) {
-    throw std::runtime_error("Could not find or open file '" + _filename +
-                             "': " + result.status().message());
+  for (const auto& fname : find_parquet_files(_fname)) {
+    read_parquet_file(fname, _name, _schema, _filters, pool, &df);
   }
 
-  const auto input = result.ValueOrDie();
+  assert_true(df);
+
+  return std::move(*df);
+}
+
+// ----------------------------------------------------------------------------
+
+void ArrowHandler::read_parquet_file(
+    const std::string& _fname, const std::string& _name,
+    const containers::Schema& _schema,
+    const std::vector<commands::ParquetFilter>& _filters,
+    const std::shared_ptr<memmap::Pool>& _pool,
+    std::optional<containers::DataFrame>* _df) const {
+  parquet::arrow::FileReaderBuilder builder;
+
+  auto status = builder.OpenFile(_fname);
+
+  if (!status.ok()) {
+    throw std::runtime_error("Could not open parquet file '" + _fname +
+                             "': " + status.message());
+  }
+
+  const auto metadata = builder.raw_reader()->metadata();
+
+  const auto parquet_schema = metadata->schema();
+
+  // The column chunks of a row group are decoded in parallel, while
+  // pre-buffering coalesces their reads and issues them ahead of time.
+  auto properties = parquet::ArrowReaderProperties(true);
+
+  properties.set_pre_buffer(true);
+
+  auto column_indices = std::vector<int>();
+
+  const auto add_columns = [&](const auto& _colnames, const bool _encoded) {
+    for (const auto& colname : _colnames) {
+      const auto ix = parquet_schema->ColumnIndex(colname);
+
+      if (ix < 0) {
+        throw std::runtime_error("Column '" + colname + "' not found in '" +
+                                 _fname + "'!");
+      }
+
+      // Strings that are encoded anyway are read as dictionaries, so every
+      // distinct value is only encoded once.
+      if (_encoded && parquet_schema->Column(ix)->logical_type()->is_string()) {
+        properties.set_read_dictionary(ix, true);
+      }
+
+      column_indices.push_back(ix);
+    }
+  };
+
+  add_columns(_schema.categoricals(), true);
+
+  add_columns(_schema.join_keys(), true);
+
+  add_columns(ranges::views::concat(_schema.numericals(), _schema.targets(),
+                                    _schema.text(), _schema.time_stamps(),
+                                    _schema.unused_floats(),
+                                    _schema.unused_strings()),
+              false);
+
+  add_columns(_filters | std::views::transform([](const auto& _filter) {
+                return _filter.column();
+              }),
+              false);
 
-  std::unique_ptr<parquet::arrow::FileReader> arrow_reader;
+  std::sort(column_indices.begin(), column_indices.end());
 
-  auto status = parquet::arrow::OpenFile(input, pool, &arrow_reader);
+  column_indices.erase(
+      std::unique(column_indices.begin(), column_indices.end()),
+      column_indices.end());
+
+  auto row_groups = std::vector<int>();
+
+  for (int i = 0; i < metadata->num_row_groups(); ++i) {
+    if (may_pass_filters(*metadata->RowGroup(i), _filters)) {
+      row_groups.push_back(i);
+    }
+  }
+
+  std::unique_ptr<parquet::arrow::FileReader> reader;
+
+  status = builder.memory_pool(arrow::default_memory_pool())
+               ->properties(properties)
+               ->Build(&reader);
 
   if (!status.ok()) {
-    throw std::runtime_error("Could not open parquet file '" + _filename +
+    throw std::runtime_error("Could not open parquet file '" + _fname +
                              "': " + status.message());
   }
 
-  std::shared_ptr<arrow::Table> table;
+  std::unique_ptr<arrow::RecordBatchReader> batch_reader;
 
-  status = arrow_reader->ReadTable(&table);
+  status = reader->GetRecordBatchReader(row_groups, column_indices,
+                                        &batch_reader);
 
   if (!status.ok()) {
-    throw std::runtime_error("Could not read table: " + status.message());
+    throw std::runtime_error("Could not read '" + _fname +
+                             "': " + status.message());
+  }
+
+  const auto add_table = [&](const std::shared_ptr<arrow::Table>& _table) {
+    auto df = table_to_df(_table, _name, _schema, _pool);
+
+    if (!_filters.empty()) {
+      df.where(apply_filters(_table, _filters));
+    }
+
+    if (*_df) {
+      (*_df)->append(df);
+    } else {
+      _df->emplace(std::move(df));
+    }
+  };
+
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+
+    status = batch_reader->ReadNext(&batch);
+
+    if (!status.ok()) {
+      throw std::runtime_error("Could not read '" + _fname +
+                               "': " + status.message());
+    }
+
+    if (!batch) {
+      break;
+    }
+
+    const auto table_result = arrow::Table::FromRecordBatches({batch});
+
+    if (!table_result.ok()) {
+      throw std::runtime_error(table_result.status().message());
+    }
+
+    add_table(table_result.ValueOrDie());
   }
 
-  return table;
+  // Even if all row groups have been skipped, we need a data frame with the
+  // expected columns.
+  if (!*_df) {
+    const auto empty_result = arrow::Table::MakeEmpty(batch_reader->schema());
+
+    if (!empty_result.ok()) {
+      throw std::runtime_error(empty_result.status().message());
+    }
+
+    add_table(empty_result.ValueOrDie());
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+containers::DataFrame ArrowHandler::recv_df(
+    Poco::Net::StreamSocket* _socket, const std::string& _name,
+    const containers::Schema& _schema) const {
+  const auto input_stream = std::make_shared<ArrowSocketInputStream>(_socket);
+
+  const auto stream_reader_result =
+      arrow::ipc::RecordBatchStreamReader::Open(input_stream);
+
+  if (!stream_reader_result.ok()) {
+    throw std::runtime_error(stream_reader_result.status().message());
+  }
+
+  const auto stream_reader = stream_reader_result.ValueOrDie();
+
+  const auto pool = options_.make_pool();
+
+  std::optional<containers::DataFrame> df;
+
+  while (true) {
+    std::shared_ptr<arrow::RecordBatch> batch;
+
+    const auto status = stream_reader->ReadNext(&batch);
+
+    if (!status.ok()) {
+      throw std::runtime_error(status.message());
+    }
+
+    if (!batch) {
+      break;
+    }
+
+    const auto table_result = arrow::Table::FromRecordBatches({batch});
+
+    if (!table_result.ok()) {
+      throw std::runtime_error(table_result.status().message());
+    }
+
+    auto batch_df =
+        table_to_df(table_result.ValueOrDie(), _name, _schema, pool);
+
+    if (df) {
+      df->append(batch_df);
+    } else {
+      df.emplace(std::move(batch_df));
+    }
+  }
+
+  if (df) {
+    return std::move(*df);
+  }
+
+  const auto empty_result =
+      arrow::Table::MakeEmpty(stream_reader->schema());
+
+  if (!empty_result.ok()) {
+    throw std::runtime_error(empty_result.status().message());
+  }
+
+  return table_to_df(empty_result.ValueOrDie(), _name, _schema, pool);
 }
 
 // ----------------------------------------------------------------------------
@@ -248,80 +591,130 @@ std::shared_ptr<arrow::Table> ArrowHandler::recv_table(
 containers::DataFrame ArrowHandler::table_to_df(
     const std::shared_ptr<arrow::Table>& _table, const std::string& _name,
     const containers::Schema& _schema) const {
+  return table_to_df(_table, _name, _schema, options_.make_pool());
+}
+
+// ----------------------------------------------------------------------------
+
+containers::DataFrame ArrowHandler::table_to_df(
+    const std::shared_ptr<arrow::Table>& _table, const std::string& _name,
+    const containers::Schema& _schema,
+    const std::shared_ptr<memmap::Pool>& _pool) const {
   throw_unless(_table, "No table passed");
 
   const auto schema = _table->schema();
 
   throw_unless(schema, "_table has no schema");
 
-  const auto to_int_column =
-      [](const containers::Column<strings::String>& _col,
-         const std::shared_ptr<containers::Encoding>& _encoding)
-      -> containers::Column<Int> {
-    assert_true(_encoding);
-    const auto data_ptr = std::make_shared<std::vector<Int>>(_col.nrows());
-    for (size_t i = 0; i < _col.nrows(); ++i) {
-      (*data_ptr)[i] = (*_encoding)[_col[i]];
+  const auto make_slots = [](const auto& _colnames, const auto _type) {
+    using T = std::remove_cvref_t<decltype(_type)>;
+    return std::vector<std::optional<containers::Column<T>>>(_colnames.size());
+  };
+
+  auto categoricals = make_slots(_schema.categoricals(), Int());
+
+  auto join_keys = make_slots(_schema.join_keys(), Int());
+
+  auto numericals = make_slots(_schema.numericals(), Float());
+
+  auto targets = make_slots(_schema.targets(), Float());
+
+  auto text = make_slots(_schema.text(), strings::String());
+
+  auto time_stamps = make_slots(_schema.time_stamps(), Float());
+
+  auto unused_floats = make_slots(_schema.unused_floats(), Float());
+
+  auto unused_strings = make_slots(_schema.unused_strings(), strings::String());
+
+  auto tasks = std::vector<std::function<void()>>();
+
+  // Every column is converted by a task of its own, the columns are added
+  // to the data frame in a fixed order afterwards.
+  const auto add_tasks = [&_table, &tasks](const auto& _colnames, auto* _slots,
+                                           const auto& _convert) {
+    for (size_t i = 0; i < _colnames.size(); ++i) {
+      tasks.emplace_back([&_table, &_colnames, _slots, &_convert, i]() {
+        const auto& colname = _colnames.at(i);
+        _slots->at(i) = _convert(colname, _table->GetColumnByName(colname));
+      });
     }
-    return containers::Column<Int>(data_ptr, _col.name());
   };
 
-  const auto pool = options_.make_pool();
+  const auto to_categorical = [this, &_pool](const auto& _colname,
+                                             const auto& _arr) {
+    return to_int_column(_pool, _colname, _arr, categories_.ptr());
+  };
+
+  const auto to_join_key = [this, &_pool](const auto& _colname,
+                                          const auto& _arr) {
+    return to_int_column(_pool, _colname, _arr, join_keys_encoding_.ptr());
+  };
+
+  const auto to_float = [this, &_pool](const auto& _colname,
+                                       const auto& _arr) {
+    return to_column<Float>(_pool, _colname, _arr);
+  };
+
+  const auto to_string = [this, &_pool](const auto& _colname,
+                                        const auto& _arr) {
+    return to_column<strings::String>(_pool, _colname, _arr);
+  };
+
+  add_tasks(_schema.categoricals(), &categoricals, to_categorical);
+  add_tasks(_schema.join_keys(), &join_keys, to_join_key);
+  add_tasks(_schema.numericals(), &numericals, to_float);
+  add_tasks(_schema.targets(), &targets, to_float);
+  add_tasks(_schema.text(), &text, to_string);
+  add_tasks(_schema.time_stamps(), &time_stamps, to_float);
+  add_tasks(_schema.unused_floats(), &unused_floats, to_float);
+  add_tasks(_schema.unused_strings(), &unused_strings, to_string);
+
+  // Memory-mapped pools must not be allocated from by more than one thread
+  // at a time, so the columns are only converted in parallel when they are
+  // kept in memory.
+  if (_pool) {
+    for (const auto& task : tasks) {
+      task();
+    }
+  } else {
+    multithreading::ThreadPool::get().parallel_for(
+        tasks.size(), [&tasks](const size_t _i) { tasks.at(_i)(); });
+  }
 
-  // TODO
   auto df = containers::DataFrame(_name, categories_.ptr(),
-                                  join_keys_encoding_.ptr(), pool);
+                                  join_keys_encoding_.ptr(), _pool);
 
-  for (const auto& colname : _schema.categoricals()) {
-    const auto arr = _table->GetColumnByName(colname);
-    const auto col =
-        to_int_column(to_column<strings::String>(pool, colname, arr),
-                      categories_.ptr());  // TODO
-    df.add_int_column(col, containers::DataFrame::ROLE_CATEGORICAL);
+  for (const auto& col : categoricals) {
+    df.add_int_column(*col, containers::DataFrame::ROLE_CATEGORICAL);
   }
 
-  for (const auto& colname : _schema.join_keys()) {
-    const auto arr = _table->GetColumnByName(colname);
-    const auto col =
-        to_int_column(to_column<strings::String>(pool, colname, arr),
-                      join_keys_encoding_.ptr());  // TODO
-    df.add_int_column(col, containers::DataFrame::ROLE_JOIN_KEY);
+  for (const auto& col : join_keys) {
+    df.add_int_column(*col, containers::DataFrame::ROLE_JOIN_KEY);
   }
 
-  for (const auto& colname : _schema.numericals()) {
-    const auto arr = _table->GetColumnByName(colname);
-    df.add_float_column(to_column<Float>(pool, colname, arr),
-                        containers::DataFrame::ROLE_NUMERICAL);
+  for (const auto& col : numericals) {
+    df.add_float_column(*col, containers::DataFrame::ROLE_NUMERICAL);
   }
 
-  for (const auto& colname : _schema.targets()) {
-    const auto arr = _table->GetColumnByName(colname);
-    df.add_float_column(to_column<Float>(pool, colname, arr),
-                        containers::DataFrame::ROLE_TARGET);
+  for (const auto& col : targets) {
+    df.add_float_column(*col, containers::DataFrame::ROLE_TARGET);
   }
 
-  for (const auto& colname : _schema.text()) {
-    const auto arr = _table->GetColumnByName(colname);
-    df.add_string_column(to_column<strings::String>(pool, colname, arr),
-                         containers::DataFrame::ROLE_TEXT);
+  for (const auto& col : text) {
+    df.add_string_column(*col, containers::DataFrame::ROLE_TEXT);
   }
 
-  for (const auto& colname : _schema.time_stamps()) {
-    const auto arr = _table->GetColumnByName(colname);
-    df.add_float_column(to_column<Float>(pool, colname, arr),
-                        containers::DataFrame::ROLE_TIME_STAMP);
+  for (const auto& col : time_stamps) {
+    df.add_float_column(*col, containers::DataFrame::ROLE_TIME_STAMP);
   }
 
-  for (const auto& colname : _schema.unused_floats()) {
-    const auto arr = _table->GetColumnByName(colname);
-    df.add_float_column(to_column<Float>(pool, colname, arr),
-                        containers::DataFrame::ROLE_UNUSED_FLOAT);
+  for (const auto& col : unused_floats) {
+    df.add_float_column(*col, containers::DataFrame::ROLE_UNUSED_FLOAT);
   }
 
-  for (const auto& colname : _schema.unused_strings()) {
-    const auto arr = _table->GetColumnByName(colname);
-    df.add_string_column(to_column<strings::String>(pool, colname, arr),
-                         containers::DataFrame::ROLE_UNUSED_STRING);
+  for (const auto& col : unused_strings) {
+    df.add_string_column(*col, containers::DataFrame::ROLE_UNUSED_STRING);
   }
 
   return df;
@@ -329,6 +722,77 @@ containers::DataFrame ArrowHandler::table_to_df(
 
 // ----------------------------------------------------------------------------
 
+containers::Column<Int> ArrowHandler::to_int_column(
+    const std::shared_ptr<memmap::Pool>& _pool, const std::string& _name,
+    const std::shared_ptr<arrow::ChunkedArray>& _arr,
+    const std::shared_ptr<containers::Encoding>& _encoding) const {
+  assert_true(_encoding);
+
+  if (!_arr) {
+    throw std::runtime_error("Column '" + _name + "' not found!");
+  }
+
+  const auto dict_name =
+      arrow::dictionary(arrow::int32(), arrow::utf8())->name();
+
+  const auto null_value = (*_encoding)[strings::String(nullptr)];
+
+  auto col = containers::Column<Int>(_pool, _arr->length());
+
+  for (std::int64_t nchunk = 0, begin = 0; nchunk < _arr->num_chunks();
+       ++nchunk) {
+    const auto chunk = _arr->chunk(nchunk);
+
+    throw_unless(chunk, "Could not extract chunk from field '" + _name + "'!");
+
+    throw_unless(chunk->type(),
+                 "Could not extract type from field '" + _name + "'!");
+
+    throw_unless(
+        begin + chunk->length() <= _arr->length(),
+        "Sum of chunks greater than the length of the chunked array in "
+        "field '" +
+            _name + "'!");
+
+    if (chunk->type()->name() == dict_name) {
+      const auto dict_chunk =
+          std::static_pointer_cast<arrow::DictionaryArray>(chunk);
+
+      assert_true(dict_chunk->indices());
+
+      const auto dictionary = dict_chunk->dictionary();
+
+      const auto func = write_to_string_column(dictionary, _name);
+
+      auto codes = std::vector<Int>(dictionary->length());
+
+      for (std::int64_t i = 0; i < dictionary->length(); ++i) {
+        codes[i] = (*_encoding)[func(i)];
+      }
+
+      for (std::int64_t i = 0; i < chunk->length(); ++i) {
+        col[begin + i] = dict_chunk->indices()->IsNull(i)
+                             ? null_value
+                             : codes.at(dict_chunk->GetValueIndex(i));
+      }
+    } else {
+      const auto func = write_to_string_column(chunk, _name);
+
+      for (std::int64_t i = 0; i < chunk->length(); ++i) {
+        col[begin + i] = (*_encoding)[func(i)];
+      }
+    }
+
+    begin += chunk->length();
+  }
+
+  col.set_name(_name);
+
+  return col;
+}
+
+// ----------------------------------------------------------------------------
+
 void ArrowHandler::send_array(
     const std::shared_ptr<arrow::ChunkedArray>& _array,
     const std::shared_ptr<arrow::Field>& _field,
@@ -370,6 +834,14 @@ void ArrowHandler::send_table(const std::shared_ptr<arrow::Table>& _table,
   if (!status.ok()) {
     throw std::runtime_error(status.message());
   }
+
+  // Closing the writer does not close the stream, but we need to send
+  // whatever the stream has staged.
+  status = stream->Close();
+
+  if (!status.ok()) {
+    throw std::runtime_error(status.message());
+  }
 }
 
 // ----------------------------------------------------------------------------
@@ -18,8 +18,10 @@ BoolOpParser::BoolOpParser(
     const rfl::Ref<const containers::Encoding>& _categories,
     const rfl::Ref<const containers::Encoding>& _join_keys_encoding,
     const rfl::Ref<const std::map<std::string, containers::DataFrame>>&
-        _data_frames)
-    : categories_(_categories),
+        _data_frames,
+    const std::shared_ptr<ColumnViewCache>& _cache)
+    : cache_(_cache ? _cache : std::make_shared<ColumnViewCache>()),
+      categories_(_categories),
       data_frames_(_data_frames),
       join_keys_encoding_(_join_keys_encoding) {}
 
@@ -97,6 +99,23 @@ containers::ColumnView<bool> BoolOpParser::numerical_comparison(
 
 containers::ColumnView<bool> BoolOpParser::parse(
     const commands::BooleanColumnView& _cmd) const {
+  const auto is_leaf = [](const auto& _op) -> bool {
+    using Type = std::decay_t<decltype(_op)>;
+    return std::is_same<Type, BooleanConstOp>();
+  };
+
+  if (rfl::visit(is_leaf, _cmd.val_)) {
+    return parse_uncached(_cmd);
+  }
+
+  return cache_->get<bool>(_cmd,
+                           [this, &_cmd]() { return parse_uncached(_cmd); });
+}
+
+// ----------------------------------------------------------------------------
+
+containers::ColumnView<bool> BoolOpParser::parse_uncached(
+    const commands::BooleanColumnView& _cmd) const {
   const auto handle = [this](const auto& _cmd) -> containers::ColumnView<bool> {
     using Type = std::decay_t<decltype(_cmd)>;
 
@@ -159,7 +178,7 @@ containers::ColumnView<bool> BoolOpParser::subselection(
                       Type,
                       rfl::Ref<commands::FloatColumnOrFloatColumnView>>()) {
       const auto indices =
-          FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+          FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(*_operand2);
       return containers::ColumnView<bool>::from_numerical_subselection(data,
                                                                        indices);
@@ -633,8 +633,7 @@ void DataFrameManager::from_arrow(
   const auto arrow_handler = handlers::ArrowHandler(
       local_categories, local_join_keys_encoding, params_.options_);
 
-  auto df = arrow_handler.table_to_df(arrow_handler.recv_table(_socket), name,
-                                      schema);
+  auto df = arrow_handler.recv_df(_socket, name, schema);
 
   // Now we upgrade the weak write lock to a strong write lock to commit
   // the changes.
@@ -805,8 +804,10 @@ void DataFrameManager::from_parquet(
   const auto arrow_handler = handlers::ArrowHandler(
       local_categories, local_join_keys_encoding, params_.options_);
 
-  auto df = arrow_handler.table_to_df(arrow_handler.read_parquet(fname), name,
-                                      schema);
+  const auto filters =
+      _cmd.filters().value_or(std::vector<commands::ParquetFilter>());
+
+  auto df = arrow_handler.read_parquet(fname, name, schema, filters);
 
   // Now we upgrade the weak write lock to a strong write lock to commit
   // the changes.
@@ -13,6 +13,7 @@
 #include "engine/utils/Aggregations.hpp"
 #include "engine/utils/Time.hpp"
 #include "io/Parser.hpp"
+#include "io/TimeStampParser.hpp"
 
 #include <rfl/visit.hpp>
 
@@ -23,8 +24,10 @@ FloatOpParser::FloatOpParser(
     const rfl::Ref<const containers::Encoding>& _categories,
     const rfl::Ref<const containers::Encoding>& _join_keys_encoding,
     const rfl::Ref<const std::map<std::string, containers::DataFrame>>&
-        _data_frames)
-    : categories_(_categories),
+        _data_frames,
+    const std::shared_ptr<ColumnViewCache>& _cache)
+    : cache_(_cache ? _cache : std::make_shared<ColumnViewCache>()),
+      categories_(_categories),
       data_frames_(_data_frames),
       join_keys_encoding_(_join_keys_encoding) {}
 
@@ -75,7 +78,7 @@ containers::ColumnView<Float> FloatOpParser::arange(
 containers::ColumnView<Float> FloatOpParser::as_num(
     const FloatFromStringOp& _cmd) const {
   const auto operand1 =
-      StringOpParser(categories_, join_keys_encoding_, data_frames_)
+      StringOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
           .parse(*_cmd.operand1());
 
   const auto to_double = [](const strings::String& _str) {
@@ -94,14 +97,14 @@ containers::ColumnView<Float> FloatOpParser::as_num(
 
 containers::ColumnView<Float> FloatOpParser::as_ts(
     const FloatAsTSOp& _cmd) const {
-  const auto time_formats = _cmd.time_formats();
+  const auto time_stamp_parser = io::TimeStampParser(_cmd.time_formats());
 
   const auto operand1 =
-      StringOpParser(categories_, join_keys_encoding_, data_frames_)
+      StringOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
           .parse(*_cmd.operand1());
 
-  const auto to_time_stamp = [time_formats](const strings::String& _str) {
-    auto [val, success] = io::Parser::to_time_stamp(_str.str(), time_formats);
+  const auto to_time_stamp = [time_stamp_parser](const strings::String& _str) {
+    auto [val, success] = time_stamp_parser.parse(_str.str());
 
     if (success) {
       return val;
@@ -204,7 +207,7 @@ containers::ColumnView<Float> FloatOpParser::binary_operation(
 containers::ColumnView<Float> FloatOpParser::boolean_as_num(
     const FloatFromBooleanOp& _cmd) const {
   const auto operand1 =
-      BoolOpParser(categories_, join_keys_encoding_, data_frames_)
+      BoolOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
           .parse(*_cmd.operand1());
 
   const auto as_num = [](const bool val) {
@@ -255,6 +258,27 @@ containers::ColumnView<Float> FloatOpParser::get_column(
 
 containers::ColumnView<Float> FloatOpParser::parse(
     const commands::FloatColumnOrFloatColumnView& _cmd) const {
+  const auto is_leaf = [](const auto& _op) -> bool {
+    using Type = std::decay_t<decltype(_op)>;
+    return std::is_same<Type, FloatArangeOp>() ||
+           std::is_same<Type, FloatColumnOp>() ||
+           std::is_same<Type, FloatConstOp>() ||
+           std::is_same<Type, FloatRandomOp>() ||
+           std::is_same<Type, FloatRowidOp>();
+  };
+
+  if (rfl::visit(is_leaf, _cmd.val_)) {
+    return parse_uncached(_cmd);
+  }
+
+  return cache_->get<Float>(_cmd,
+                            [this, &_cmd]() { return parse_uncached(_cmd); });
+}
+
+// ----------------------------------------------------------------------------
+
+containers::ColumnView<Float> FloatOpParser::parse_uncached(
+    const commands::FloatColumnOrFloatColumnView& _cmd) const {
   const auto handle =
       [this](const auto& _cmd) -> containers::ColumnView<Float> {
     using Type = std::decay_t<decltype(_cmd)>;
@@ -338,7 +362,7 @@ containers::ColumnView<Float> FloatOpParser::subselection(
           data, indices);
     } else {
       const auto indices =
-          BoolOpParser(categories_, join_keys_encoding_, data_frames_)
+          BoolOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(*_operand2);
       return containers::ColumnView<Float>::from_boolean_subselection(data,
                                                                       indices);
@@ -491,7 +515,7 @@ containers::ColumnView<Float> FloatOpParser::update(
   const auto operand2 = parse(*_cmd.operand2());
 
   const auto condition =
-      BoolOpParser(categories_, join_keys_encoding_, data_frames_)
+      BoolOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
           .parse(*_cmd.condition());
 
   const auto op = [](const auto& _val1, const auto& _val2,
@@ -620,14 +620,26 @@ void PipelineManager::store_df(
     const std::vector<containers::DataFrame>& _peripheral_dfs,
     const rfl::Ref<containers::Encoding>& _local_categories,
     const rfl::Ref<containers::Encoding>& _local_join_keys_encoding,
+    const size_t _num_categories, const size_t _num_join_keys,
     containers::DataFrame* _df,
     multithreading::WeakWriteLock* _weak_write_lock) {
   _weak_write_lock->upgrade();
 
+  // The transformation only holds a read lock, so a fit or an upload might
+  // have added new categories after the local encodings were created.
+  const bool encodings_changed =
+      params_.categories_->size() != _num_categories ||
+      params_.join_keys_encoding_->size() != _num_join_keys;
+
   params_.categories_->append(*_local_categories);
 
   params_.join_keys_encoding_->append(*_local_join_keys_encoding);
 
+  if (encodings_changed) {
+    recode(*_local_categories, *_local_join_keys_encoding, _num_categories,
+           _num_join_keys, _df);
+  }
+
   _df->set_categories(params_.categories_.ptr());  // TODO
 
   _df->set_join_keys_encoding(params_.join_keys_encoding_.ptr());  // TODO
@@ -643,6 +655,61 @@ void PipelineManager::store_df(
 
 // ------------------------------------------------------------------------
 
+void PipelineManager::recode(
+    const containers::Encoding& _local_categories,
+    const containers::Encoding& _local_join_keys_encoding,
+    const size_t _num_categories, const size_t _num_join_keys,
+    containers::DataFrame* _df) {
+  const auto recode_column = [_df](const containers::Column<Int>& _col,
+                                   const containers::Encoding& _local,
+                                   const size_t _begin,
+                                   containers::Encoding* _global) {
+    auto recoded = containers::Column<Int>(_df->pool(), _col.nrows());
+
+    for (size_t i = 0; i < _col.nrows(); ++i) {
+      const auto code = _col[i];
+      recoded[i] = (code < 0 || static_cast<size_t>(code) < _begin)
+                       ? code
+                       : (*_global)[_local[code]];
+    }
+
+    recoded.set_name(_col.name());
+    recoded.set_unit(_col.unit());
+    recoded.set_subroles(_col.subroles());
+
+    return recoded;
+  };
+
+  auto categoricals = std::vector<containers::Column<Int>>();
+
+  for (size_t i = 0; i < _df->num_categoricals(); ++i) {
+    categoricals.push_back(recode_column(_df->categorical(i),
+                                         _local_categories, _num_categories,
+                                         params_.categories_.get()));
+  }
+
+  auto join_keys = std::vector<containers::Column<Int>>();
+
+  for (size_t i = 0; i < _df->num_join_keys(); ++i) {
+    join_keys.push_back(recode_column(
+        _df->join_key(i), _local_join_keys_encoding, _num_join_keys,
+        params_.join_keys_encoding_.get()));
+  }
+
+  // add_int_column(...) replaces columns of the same name by appending the
+  // new column at the end, so adding all of them in order preserves the
+  // order.
+  for (const auto& col : categoricals) {
+    _df->add_int_column(col, containers::DataFrame::ROLE_CATEGORICAL);
+  }
+
+  for (const auto& col : join_keys) {
+    _df->add_int_column(col, containers::DataFrame::ROLE_JOIN_KEY);
+  }
+}
+
+// ------------------------------------------------------------------------
+
 void PipelineManager::to_db(
     const pipelines::FittedPipeline& _fitted, const FullTransformOp& _cmd,
     const containers::DataFrame& _population_table,
@@ -766,7 +833,11 @@ void PipelineManager::transform(const typename Command::TransformOp& _cmd,
 
   communication::Sender::send_string("Found!", _socket);
 
-  multithreading::WeakWriteLock weak_write_lock(params_.read_write_lock_);
+  // Transformations only read from the global state (any new categories go
+  // into the local encodings), so they can run alongside each other and
+  // alongside fits and uploads. The global encodings cannot change while
+  // the read lock is held.
+  multithreading::ReadLock read_lock(params_.read_write_lock_);
 
   const auto pool = params_.options_.make_pool();
 
@@ -776,6 +847,10 @@ void PipelineManager::transform(const typename Command::TransformOp& _cmd,
   const auto local_join_keys_encoding = rfl::Ref<containers::Encoding>::make(
       pool, params_.join_keys_encoding_.ptr());
 
+  const auto num_categories = params_.categories_->size();
+
+  const auto num_join_keys = params_.join_keys_encoding_->size();
+
   auto local_data_frames =
       rfl::Ref<std::map<std::string, containers::DataFrame>>::make(
           data_frames());
@@ -837,11 +912,18 @@ void PipelineManager::transform(const typename Command::TransformOp& _cmd,
         to_df(*fitted, cmd, population_df, numerical_features,
               categorical_features, local_categories, local_join_keys_encoding);
 
+    // The read lock cannot be upgraded, so we release it first and account
+    // for any categories added in the meantime in store_df(...).
+    read_lock.unlock();
+
+    multithreading::WeakWriteLock weak_write_lock(params_.read_write_lock_);
+
     store_df(*fitted, cmd, population_df, peripheral_dfs, local_categories,
-             local_join_keys_encoding, &df, &weak_write_lock);
+             local_join_keys_encoding, num_categories, num_join_keys, &df,
+             &weak_write_lock);
   }
 
-  weak_write_lock.unlock();
+  read_lock.unlock();
 
   communication::Sender::send_string("Success!", _socket);
 
@@ -376,7 +376,8 @@ void ProjectManager::save_data_frame(const typename Command::SaveDfOp& _cmd,
 
   auto& df = utils::Getter::get(name, &data_frames());
 
-  df.save(params_.options_.temp_dir(), project_directory() + "data/", name);
+  df.save(params_.options_.temp_dir(), project_directory() + "data/", name,
+          params_.options_.engine().compression());
 
   FileHandler::save_encodings(project_directory(), params_.categories_.ptr(),
                               params_.join_keys_encoding_.ptr());
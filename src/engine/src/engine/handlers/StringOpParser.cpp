@@ -22,8 +22,10 @@ StringOpParser::StringOpParser(
     const rfl::Ref<const containers::Encoding>& _categories,
     const rfl::Ref<const containers::Encoding>& _join_keys_encoding,
     const rfl::Ref<const std::map<std::string, containers::DataFrame>>&
-        _data_frames)
-    : categories_(_categories),
+        _data_frames,
+    const std::shared_ptr<ColumnViewCache>& _cache)
+    : cache_(_cache ? _cache : std::make_shared<ColumnViewCache>()),
+      categories_(_categories),
       data_frames_(_data_frames),
       join_keys_encoding_(_join_keys_encoding) {}
 
@@ -47,7 +49,8 @@ containers::ColumnView<strings::String> StringOpParser::binary_operation(
 containers::ColumnView<strings::String> StringOpParser::boolean_as_string(
     const commands::BooleanColumnView& _col) const {
   const auto operand1 =
-      BoolOpParser(categories_, join_keys_encoding_, data_frames_).parse(_col);
+      BoolOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
+          .parse(_col);
 
   const auto to_str = [](const bool val) -> strings::String {
     if (val) {
@@ -170,7 +173,8 @@ containers::ColumnView<strings::String> StringOpParser::numerical_as_string(
   };
 
   const auto operand1 =
-      FloatOpParser(categories_, join_keys_encoding_, data_frames_).parse(_col);
+      FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
+          .parse(_col);
 
   if (role() == containers::DataFrame::ROLE_TIME_STAMP ||
       operand1.unit().find("time stamp") != std::string::npos) {
@@ -186,6 +190,24 @@ containers::ColumnView<strings::String> StringOpParser::numerical_as_string(
 
 containers::ColumnView<strings::String> StringOpParser::parse(
     const commands::StringColumnOrStringColumnView& _cmd) const {
+  const auto is_leaf = [](const auto& _op) -> bool {
+    using Type = std::decay_t<decltype(_op)>;
+    return std::is_same<Type, StringColumnOp>() ||
+           std::is_same<Type, StringConstOp>();
+  };
+
+  if (rfl::visit(is_leaf, _cmd.val_)) {
+    return parse_uncached(_cmd);
+  }
+
+  return cache_->get<strings::String>(
+      _cmd, [this, &_cmd]() { return parse_uncached(_cmd); });
+}
+
+// ----------------------------------------------------------------------------
+
+containers::ColumnView<strings::String> StringOpParser::parse_uncached(
+    const commands::StringColumnOrStringColumnView& _cmd) const {
   const auto handle =
       [this](const auto& _cmd) -> containers::ColumnView<strings::String> {
     using Type = std::decay_t<decltype(_cmd)>;
@@ -246,13 +268,13 @@ containers::ColumnView<strings::String> StringOpParser::subselection(
                       Type,
                       rfl::Ref<commands::FloatColumnOrFloatColumnView>>()) {
       const auto indices =
-          FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+          FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(*_operand2);
       return containers::ColumnView<
           strings::String>::from_numerical_subselection(data, indices);
     } else {
       const auto indices =
-          BoolOpParser(categories_, join_keys_encoding_, data_frames_)
+          BoolOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(*_operand2);
       return containers::ColumnView<strings::String>::from_boolean_subselection(
           data, indices);
@@ -341,7 +363,7 @@ containers::ColumnView<strings::String> StringOpParser::update(
   const auto operand2 = parse(*_cmd.operand2());
 
   const auto condition =
-      BoolOpParser(categories_, join_keys_encoding_, data_frames_)
+      BoolOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
           .parse(*_cmd.condition());
 
   const auto op = [](const auto& _val1, const auto& _val2,
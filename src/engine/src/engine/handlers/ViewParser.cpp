@@ -28,7 +28,8 @@ ViewParser::ViewParser(
     const rfl::Ref<const std::map<std::string, containers::DataFrame>>&
         _data_frames,
     const config::Options& _options)
-    : categories_(_categories),
+    : cache_(std::make_shared<ColumnViewCache>()),
+      categories_(_categories),
       data_frames_(_data_frames),
       join_keys_encoding_(_join_keys_encoding),
       options_(_options) {}
@@ -55,7 +56,7 @@ void ViewParser::add_column(const ViewOp& _cmd,
     if constexpr (std::is_same<Type,
                                commands::FloatColumnOrFloatColumnView>()) {
       const auto column_view =
-          FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+          FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(_json_col);
 
       auto col = column_view.to_column(0, _df->nrows(), true);
@@ -69,7 +70,7 @@ void ViewParser::add_column(const ViewOp& _cmd,
       _df->add_float_column(col, role);
     } else {
       const auto column_view =
-          StringOpParser(categories_, join_keys_encoding_, data_frames_)
+          StringOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(_json_col);
 
       const auto vec = column_view.to_vector(0, _df->nrows(), true);
@@ -171,7 +172,8 @@ typename ViewParser::ColumnViewVariant ViewParser::make_column_view(
                       Type, typename commands::StringColumnOrStringColumnView::
                                 ReflectionType>()) {
       const auto col = commands::StringColumnOrStringColumnView{_col};
-      return StringOpParser(categories_, join_keys_encoding_, data_frames_)
+      return StringOpParser(categories_, join_keys_encoding_, data_frames_,
+                            cache_)
           .parse(col);
     }
 
@@ -179,7 +181,8 @@ typename ViewParser::ColumnViewVariant ViewParser::make_column_view(
                                typename commands::FloatColumnOrFloatColumnView::
                                    ReflectionType>()) {
       const auto col = commands::FloatColumnOrFloatColumnView{_col};
-      return FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+      return FloatOpParser(categories_, join_keys_encoding_, data_frames_,
+                           cache_)
           .parse(col);
     }
   };
@@ -413,7 +416,7 @@ void ViewParser::subselection(const ViewOp& _cmd,
 
     if constexpr (std::is_same<Type, commands::BooleanColumnView>()) {
       const auto column_view =
-          BoolOpParser(categories_, join_keys_encoding_, data_frames_)
+          BoolOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(_json_col);
 
       const auto data_ptr = column_view.to_vector(0, _df->nrows(), true);
@@ -423,7 +426,7 @@ void ViewParser::subselection(const ViewOp& _cmd,
       _df->where(*data_ptr);
     } else {
       const auto data_ptr =
-          FloatOpParser(categories_, join_keys_encoding_, data_frames_)
+          FloatOpParser(categories_, join_keys_encoding_, data_frames_, cache_)
               .parse(_json_col)
               .to_vector(0, std::nullopt, false);
 
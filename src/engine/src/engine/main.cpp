@@ -8,6 +8,8 @@
 #include "engine/handlers/DataFrameManagerParams.hpp"
 
 #include <Poco/Net/TCPServer.h>
+#include <Poco/Net/TCPServerParams.h>
+#include <Poco/ThreadPool.h>
 
 #include <chrono>
 #include <csignal>
@@ -64,6 +66,8 @@ int main(int argc, char* argv[]) {
 
   const auto pool = options.make_pool();
 
+  multithreading::ThreadPool::init(options.make_thread_pool());
+
   const auto categories = rfl::Ref<containers::Encoding>::make(pool);
 
   const auto join_keys_encoding = rfl::Ref<containers::Encoding>::make(pool);
@@ -158,11 +162,26 @@ int main(int argc, char* argv[]) {
 
   server_socket.setSendTimeout(Poco::Timespan(10, 0));
 
+  // Sessions keep their thread for as long as they are open, so we need more
+  // threads than Poco's default thread pool provides. Because the number of
+  // sessions is capped, there are always threads left for single commands.
+  constexpr int num_single_command_threads = 16;
+
+  const auto max_connections =
+      static_cast<int>(options.engine().max_sessions()) +
+      num_single_command_threads;
+
+  Poco::ThreadPool thread_pool(2, max_connections);
+
+  auto server_params = new Poco::Net::TCPServerParams();
+
+  server_params->setMaxThreads(max_connections);
+
   Poco::Net::TCPServer srv(
       new engine::srv::ServerConnectionFactoryImpl(
           database_manager, data_params, logger, options, pipeline_manager,
           project_manager, shutdown_flag),
-      server_socket);
+      thread_pool, server_socket, server_params);
 
   srv.start();
 
@@ -20,6 +20,7 @@
 #include "engine/preprocessors/PreprocessorParser.hpp"
 #include "featurelearners/AbstractFeatureLearner.hpp"
 #include "helpers/StringReplacer.hpp"
+#include "multithreading/ThreadPool.hpp"
 #include "predictors/Predictor.hpp"
 #include "predictors/PredictorParser.hpp"
 
@@ -29,6 +30,8 @@
 #include <rfl/replace.hpp>
 #include <rfl/to_named_tuple.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <utility>
 
 namespace engine {
@@ -81,6 +84,14 @@ fit_transform_preprocessors(
 std::vector<std::string> get_targets(
     const containers::DataFrame& _population_df);
 
+/// Logs the work the engine-wide thread pool has done between _before and
+/// _after into the monitor log.
+void log_thread_pool_stats(
+    const std::string& _name,
+    const multithreading::ThreadPool::Stats& _before,
+    const multithreading::ThreadPool::Stats& _after,
+    const std::shared_ptr<const communication::Logger>& _logger);
+
 /// Generates the impl for the feature selectors.
 rfl::Ref<const predictors::PredictorImpl> make_feature_selector_impl(
     const Pipeline& _pipeline,
@@ -445,8 +456,14 @@ fit_feature_learners(
         rfl::make_field<"socket_logger_">(socket_logger),
         rfl::make_field<"temp_dir_">(_params.categories()->temp_dir())};
 
+    const auto stats_before = multithreading::ThreadPool::get().stats();
+
     fe->fit(params);
 
+    log_thread_pool_stats(fe->type(), stats_before,
+                          multithreading::ThreadPool::get().stats(),
+                          _params.logger());
+
     _params.fe_tracker()->add(fe);
   }
 
@@ -802,6 +819,41 @@ std::vector<rfl::Ref<preprocessors::Preprocessor>> init_preprocessors(
 
 // ------------------------------------------------------------------------
 
+void log_thread_pool_stats(
+    const std::string& _name,
+    const multithreading::ThreadPool::Stats& _before,
+    const multithreading::ThreadPool::Stats& _after,
+    const std::shared_ptr<const communication::Logger>& _logger) {
+  if (!_logger) {
+    return;
+  }
+
+  const auto to_ms = [](const std::chrono::nanoseconds _t) -> std::string {
+    return std::to_string(
+               std::chrono::duration_cast<std::chrono::milliseconds>(_t)
+                   .count()) +
+           "ms";
+  };
+
+  const auto num_tasks = _after.num_tasks_ - _before.num_tasks_;
+
+  const auto busy_time = _after.busy_time_ - _before.busy_time_;
+
+  const auto wait_time = _after.wait_time_ - _before.wait_time_;
+
+  const auto avg_wait_time =
+      num_tasks > 0 ? wait_time / static_cast<std::int64_t>(num_tasks)
+                    : std::chrono::nanoseconds(0);
+
+  _logger->log(_name + ": The thread pool (" +
+               std::to_string(_after.num_threads_) + " threads) executed " +
+               std::to_string(num_tasks) + " tasks, busy for " +
+               to_ms(busy_time) + ", average wait " + to_ms(avg_wait_time) +
+               ", longest task so far " + to_ms(_after.max_task_time_) + ".");
+}
+
+// ------------------------------------------------------------------------
+
 rfl::Ref<const predictors::PredictorImpl> make_feature_selector_impl(
     const Pipeline& _pipeline,
     const std::vector<rfl::Ref<const featurelearners::AbstractFeatureLearner>>&
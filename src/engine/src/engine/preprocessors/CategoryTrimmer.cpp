@@ -253,7 +253,8 @@ CategoryTrimmer::transform(const Params& _params) const {
 
   const auto pool = _params.population_df().pool()
                         ? std::make_shared<memmap::Pool>(
-                              _params.population_df().pool()->temp_dir())
+                              _params.population_df().pool()->temp_dir(),
+                              _params.population_df().pool()->options())
                         : std::shared_ptr<memmap::Pool>();
 
   const auto population_df = transform_df(
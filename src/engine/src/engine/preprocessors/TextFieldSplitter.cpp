@@ -213,7 +213,8 @@ void TextFieldSplitter::transform_df(
   };
 
   const auto pool = _df.pool()
-                        ? std::make_shared<memmap::Pool>(_df.pool()->temp_dir())
+                        ? std::make_shared<memmap::Pool>(_df.pool()->temp_dir(),
+                                                         _df.pool()->options())
                         : std::shared_ptr<memmap::Pool>();
 
   const auto make_df = [this, pool,
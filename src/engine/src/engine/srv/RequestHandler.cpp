@@ -17,12 +17,15 @@
 
 #include <Poco/JSON/Object.h>
 #include <Poco/JSON/Parser.h>
+#include <Poco/Timespan.h>
 #include <rfl/always_false.hpp>
 #include <rfl/extract_discriminators.hpp>
 #include <rfl/get.hpp>
 #include <rfl/json/read.hpp>
 
 #include <stdexcept>
+#include <string>
+#include <variant>
 
 namespace engine {
 namespace srv {
@@ -35,6 +38,7 @@ RequestHandler::RequestHandler(
     const rfl::Ref<handlers::PipelineManager>& _pipeline_manager,
     const config::Options& _options,
     const rfl::Ref<handlers::ProjectManager>& _project_manager,
+    const rfl::Ref<std::atomic<size_t>>& _num_sessions,
     const rfl::Ref<std::atomic<bool>>& _shutdown)
     : Poco::Net::TCPServerConnection(_socket),
       database_manager_(_database_manager),
@@ -43,8 +47,60 @@ RequestHandler::RequestHandler(
       pipeline_manager_(_pipeline_manager),
       options_(_options),
       project_manager_(_project_manager),
+      num_sessions_(_num_sessions),
       shutdown_(_shutdown) {}
 
+// -----------------------------------------------------------------
+
+void RequestHandler::handle(const commands::Command& _cmd) {
+  const auto execute = [this](const auto& _op) {
+    using Type = std::decay_t<decltype(_op)>;
+    if constexpr (std::is_same<Type, commands::ColumnCommand>()) {
+      return column_manager().execute_command(_op, &socket());
+    } else if constexpr (std::is_same<Type, commands::DatabaseCommand>()) {
+      return database_manager().execute_command(_op, &socket());
+    } else if constexpr (std::is_same<Type, commands::DataFrameCommand>()) {
+      return data_frame_manager().execute_command(_op, &socket());
+    } else if constexpr (std::is_same<Type, commands::PipelineCommand>()) {
+      return pipeline_manager().execute_command(_op, &socket());
+    } else if constexpr (std::is_same<Type, commands::ProjectCommand>()) {
+      return project_manager().execute_command(_op, &socket());
+    } else if constexpr (std::is_same<Type, commands::ViewCommand>()) {
+      return view_manager().execute_command(_op, &socket());
+    } else if constexpr (std::is_same<
+                             Type, typename commands::Command::IsAliveOp>()) {
+      return;
+    } else if constexpr (std::is_same<
+                             Type,
+                             typename commands::Command::MonitorURLOp>()) {
+      // the community edition does not have a monitor.
+      communication::Sender::send_string("", &socket());
+    } else if constexpr (std::is_same<
+                             Type, typename commands::Command::SessionOp>()) {
+      throw std::runtime_error(
+          "A session can only be opened by the first command sent over a "
+          "connection.");
+    } else if constexpr (std::is_same<
+                             Type,
+                             typename commands::Command::ShutdownOp>()) {
+      *shutdown_ = true;
+    } else {
+      static_assert(rfl::always_false_v<Type>, "Not all cases were covered.");
+    }
+  };
+
+  std::visit(execute, _cmd.val_);
+}
+
+// -----------------------------------------------------------------
+
+commands::Command RequestHandler::recv_command() {
+  const auto cmd_str = communication::Receiver::recv_cmd(logger_, &socket());
+  return rfl::json::read<commands::Command>(cmd_str).value();
+}
+
+// -----------------------------------------------------------------
+
 void RequestHandler::run() {
   try {
     if (socket().peerAddress().host().toString() != "127.0.0.1") {
@@ -54,42 +110,15 @@ void RequestHandler::run() {
                                "(127.0.0.1) are allowed!");
     }
 
-    const auto cmd_str = communication::Receiver::recv_cmd(logger_, &socket());
-
-    const auto cmd = rfl::json::read<commands::Command>(cmd_str).value();
-
-    const auto handle = [this](const auto& _cmd) {
-      using Type = std::decay_t<decltype(_cmd)>;
-      if constexpr (std::is_same<Type, commands::ColumnCommand>()) {
-        return column_manager().execute_command(_cmd, &socket());
-      } else if constexpr (std::is_same<Type, commands::DatabaseCommand>()) {
-        return database_manager().execute_command(_cmd, &socket());
-      } else if constexpr (std::is_same<Type, commands::DataFrameCommand>()) {
-        return data_frame_manager().execute_command(_cmd, &socket());
-      } else if constexpr (std::is_same<Type, commands::PipelineCommand>()) {
-        return pipeline_manager().execute_command(_cmd, &socket());
-      } else if constexpr (std::is_same<Type, commands::ProjectCommand>()) {
-        return project_manager().execute_command(_cmd, &socket());
-      } else if constexpr (std::is_same<Type, commands::ViewCommand>()) {
-        return view_manager().execute_command(_cmd, &socket());
-      } else if constexpr (std::is_same<
-                               Type, typename commands::Command::IsAliveOp>()) {
-        return;
-      } else if constexpr (std::is_same<
-                               Type,
-                               typename commands::Command::MonitorURLOp>()) {
-        // the community edition does not have a monitor.
-        communication::Sender::send_string("", &socket());
-      } else if constexpr (std::is_same<
-                               Type,
-                               typename commands::Command::ShutdownOp>()) {
-        *shutdown_ = true;
-      } else {
-        static_assert(rfl::always_false_v<Type>, "Not all cases were covered.");
-      }
-    };
-
-    std::visit(handle, cmd.val_);
+    const auto cmd = recv_command();
+
+    if (std::holds_alternative<typename commands::Command::SessionOp>(
+            cmd.val_)) {
+      run_session();
+      return;
+    }
+
+    handle(cmd);
 
   } catch (std::exception& e) {
     logger_->log(std::string("Error: ") + e.what());
@@ -97,5 +126,62 @@ void RequestHandler::run() {
     communication::Sender::send_string(e.what(), &socket());
   }
 }
+
+// -----------------------------------------------------------------
+
+void RequestHandler::run_session() {
+  const auto max_sessions = options_.engine().max_sessions();
+
+  if (++(*num_sessions_) > max_sessions) {
+    --(*num_sessions_);
+    throw std::runtime_error(
+        "Could not open a session, because " + std::to_string(max_sessions) +
+        " sessions are open already. Please close one of them or send the "
+        "command without a session.");
+  }
+
+  communication::Sender::send_string("Success!", &socket());
+
+  // If a command fails, we cannot know how much of its input the client has
+  // already sent, so the exception ends the session and the client has to
+  // open a new one.
+  try {
+    while (wait_for_command()) {
+      handle(recv_command());
+    }
+  } catch (...) {
+    --(*num_sessions_);
+    throw;
+  }
+
+  --(*num_sessions_);
+}
+
+// -----------------------------------------------------------------
+
+bool RequestHandler::wait_for_command() {
+  // We wake up once per second, so that idle sessions do not keep the
+  // engine from shutting down.
+  const auto timeslice = Poco::Timespan(1, 0);
+
+  const auto session_timeout = options_.engine().session_timeout();
+
+  for (size_t i = 0; i < session_timeout; ++i) {
+    if (*shutdown_) {
+      return false;
+    }
+
+    if (socket().poll(timeslice, Poco::Net::Socket::SELECT_READ |
+                                     Poco::Net::Socket::SELECT_ERROR)) {
+      // A readable socket without any data means that the client has closed
+      // the connection.
+      return socket().available() > 0;
+    }
+  }
+
+  return false;
+}
+
+// -----------------------------------------------------------------
 }  // namespace srv
 }  // namespace engine
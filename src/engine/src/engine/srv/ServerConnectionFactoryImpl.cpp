@@ -27,12 +27,13 @@ ServerConnectionFactoryImpl::ServerConnectionFactoryImpl(
       options_(_options),
       pipeline_manager_(_pipeline_manager),
       project_manager_(_project_manager),
+      num_sessions_(rfl::Ref<std::atomic<size_t>>::make(0)),
       shutdown_(_shutdown) {}
 
 Poco::Net::TCPServerConnection* ServerConnectionFactoryImpl::createConnection(
     const Poco::Net::StreamSocket& _socket) {
   return new RequestHandler(_socket, database_manager_, data_params_, logger_,
                             pipeline_manager_, options_, project_manager_,
-                            shutdown_);
+                            num_sessions_, shutdown_);
 }
 }  // namespace engine::srv
@@ -7,62 +7,215 @@
 
 #include "fastprop/algorithm/Aggregator.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace fastprop {
 namespace algorithm {
+namespace {
+
+/// Counts the distinct values in a sorted vector.
+Float count_distinct_sorted(const std::vector<Float> &_sorted) {
+  if (_sorted.size() == 0) {
+    return 0.0;
+  }
+
+  Float n = 1.0;
+
+  for (size_t i = 1; i < _sorted.size(); ++i) {
+    n += (_sorted[i] != _sorted[i - 1]) ? 1.0 : 0.0;
+  }
+
+  return n;
+}
+
+/// Returns the quantile designated by _q of a sorted vector, just like
+/// helpers::Aggregations::quantile(...) would.
+Float quantile_sorted(const Float _q, const std::vector<Float> &_sorted) {
+  if (_sorted.size() == 0) [[unlikely]] {
+    return NAN;
+  }
+
+  const auto ix_float = static_cast<Float>(_sorted.size() - 1) * _q;
+
+  const auto ix = static_cast<size_t>(ix_float);
+
+  if (ix == _sorted.size() - 1) [[unlikely]] {
+    return _sorted[ix];
+  }
+
+  const auto share = ix_float - static_cast<Float>(ix);
+
+  return _sorted[ix + 1] * share + _sorted[ix] * (1.0 - share);
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+Float Aggregator::aggregate_memoized(
+    const enums::Aggregation _aggregation,
+    const rfl::Ref<Memoization> &_memoization) {
+  switch (_aggregation.value()) {
+    case enums::Aggregation::value_of<"AVG">(): {
+      const auto stats = _memoization->stats_numerical();
+      return stats.count_ > 0.0 ? stats.sum_ / stats.count_ : NAN;
+    }
+
+    case enums::Aggregation::value_of<"COUNT">():
+      return _memoization->stats_numerical().count_;
+
+    case enums::Aggregation::value_of<"COUNT DISTINCT">():
+      return count_distinct_sorted(_memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"COUNT DISTINCT OVER COUNT">(): {
+      const auto &sorted = _memoization->sorted_numerical();
+      if (sorted.size() == 0) {
+        return NAN;
+      }
+      return count_distinct_sorted(sorted) / static_cast<Float>(sorted.size());
+    }
+
+    case enums::Aggregation::value_of<"COUNT MINUS COUNT DISTINCT">(): {
+      const auto &sorted = _memoization->sorted_numerical();
+      return static_cast<Float>(sorted.size()) - count_distinct_sorted(sorted);
+    }
+
+    case enums::Aggregation::value_of<"MAX">(): {
+      const auto &sorted = _memoization->sorted_numerical();
+      return sorted.size() > 0 ? sorted.back() : NAN;
+    }
+
+    case enums::Aggregation::value_of<"MEDIAN">(): {
+      const auto &sorted = _memoization->sorted_numerical();
+      const auto n = sorted.size();
+      if (n == 0) {
+        return NAN;
+      }
+      if (n % 2 == 0) {
+        return (sorted[(n / 2) - 1] + sorted[n / 2]) / 2.0;
+      }
+      return sorted[n / 2];
+    }
+
+    case enums::Aggregation::value_of<"MIN">(): {
+      const auto &sorted = _memoization->sorted_numerical();
+      return sorted.size() > 0 ? sorted.front() : NAN;
+    }
+
+    case enums::Aggregation::value_of<"NUM MAX">(): {
+      const auto &sorted = _memoization->sorted_numerical();
+      if (sorted.size() == 0) {
+        return 0.0;
+      }
+      const auto it = std::ranges::lower_bound(sorted, sorted.back());
+      return static_cast<Float>(sorted.end() - it);
+    }
+
+    case enums::Aggregation::value_of<"NUM MIN">(): {
+      const auto &sorted = _memoization->sorted_numerical();
+      if (sorted.size() == 0) {
+        return 0.0;
+      }
+      const auto it = std::ranges::upper_bound(sorted, sorted.front());
+      return static_cast<Float>(it - sorted.begin());
+    }
+
+    case enums::Aggregation::value_of<"Q1">():
+      return quantile_sorted(0.01, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"Q5">():
+      return quantile_sorted(0.05, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"Q10">():
+      return quantile_sorted(0.1, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"Q25">():
+      return quantile_sorted(0.25, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"Q75">():
+      return quantile_sorted(0.75, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"Q90">():
+      return quantile_sorted(0.90, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"Q95">():
+      return quantile_sorted(0.95, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"Q99">():
+      return quantile_sorted(0.99, _memoization->sorted_numerical());
+
+    case enums::Aggregation::value_of<"STDDEV">():
+      return std::sqrt(_memoization->var_numerical());
+
+    case enums::Aggregation::value_of<"SUM">():
+      return _memoization->stats_numerical().sum_;
+
+    case enums::Aggregation::value_of<"VAR">():
+      return _memoization->var_numerical();
+
+    default:
+      return aggregate_numerical_range(_memoization->numerical_begin(),
+                                       _memoization->numerical_end(),
+                                       _aggregation);
+  }
+}
+
+// ----------------------------------------------------------------------------
 
 Float Aggregator::apply_aggregation(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
     const std::optional<containers::Features> &_subfeatures,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   switch (_abstract_feature.data_used_.value()) {
     case enums::DataUsed::value_of<"categorical">():
       return apply_categorical(_population, _peripheral, _matches,
-                               _condition_function, _abstract_feature,
+                               _conditions, _abstract_feature,
                                _memoization);
 
     case enums::DataUsed::value_of<"discrete">():
       return apply_discrete(_population, _peripheral, _matches,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
 
     case enums::DataUsed::value_of<"na">():
-      return apply_not_applicable(_peripheral, _matches, _condition_function,
+      return apply_not_applicable(_peripheral, _matches, _conditions,
                                   _abstract_feature, _memoization);
 
     case enums::DataUsed::value_of<"numerical">():
       return apply_numerical(_population, _peripheral, _matches,
-                             _condition_function, _abstract_feature,
+                             _conditions, _abstract_feature,
                              _memoization);
 
     case enums::DataUsed::value_of<"same_units_categorical">():
       return apply_same_units_categorical(_population, _peripheral, _matches,
-                                          _condition_function,
+                                          _conditions,
                                           _abstract_feature, _memoization);
 
     case enums::DataUsed::value_of<"same_units_discrete">():
     case enums::DataUsed::value_of<"same_units_discrete_ts">():
       return apply_same_units_discrete(_population, _peripheral, _matches,
-                                       _condition_function, _abstract_feature,
+                                       _conditions, _abstract_feature,
                                        _memoization);
 
     case enums::DataUsed::value_of<"same_units_numerical">():
     case enums::DataUsed::value_of<"same_units_numerical_ts">():
       return apply_same_units_numerical(_population, _peripheral, _matches,
-                                        _condition_function, _abstract_feature,
+                                        _conditions, _abstract_feature,
                                         _memoization);
 
     case enums::DataUsed::value_of<"subfeatures">():
       assert_true(_subfeatures);
       return apply_subfeatures(_population, _peripheral, *_subfeatures,
-                               _matches, _condition_function, _abstract_feature,
+                               _matches, _conditions, _abstract_feature,
                                _memoization);
 
     case enums::DataUsed::value_of<"text">():
-      return apply_text(_population, _peripheral, _matches, _condition_function,
+      return apply_text(_population, _peripheral, _matches, _conditions,
                         _abstract_feature, _memoization);
 
     default:
@@ -77,8 +230,8 @@ Float Aggregator::apply_aggregation(
 Float Aggregator::apply_categorical(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.input_col_ < _peripheral.num_categoricals());
@@ -92,7 +245,7 @@ Float Aggregator::apply_categorical(
     };
 
     return aggregate_matches_categorical(
-        _matches, extract_value, _condition_function, _abstract_feature);
+        _matches, extract_value, _conditions, _abstract_feature);
   }
 
   const auto extract_value =
@@ -105,16 +258,14 @@ Float Aggregator::apply_categorical(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -122,8 +273,8 @@ Float Aggregator::apply_categorical(
 Float Aggregator::apply_discrete(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.input_col_ < _peripheral.num_discretes());
@@ -136,24 +287,22 @@ Float Aggregator::apply_discrete(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
 
 Float Aggregator::apply_not_applicable(
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.aggregation_.value() ==
@@ -167,12 +316,10 @@ Float Aggregator::apply_not_applicable(
       return 0.0;
     };
 
-    memorize_numerical_range(_matches, extract_value, _condition_function,
+    memorize_numerical_range(_matches, extract_value, _conditions,
                              _abstract_feature, _memoization);
 
-    return aggregate_numerical_range(_memoization->numerical_begin(),
-                                     _memoization->numerical_end(),
-                                     _abstract_feature.aggregation_);
+    return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
   }
 
   assert_true(_peripheral.num_time_stamps() > 0);
@@ -183,12 +330,10 @@ Float Aggregator::apply_not_applicable(
     return col[match.ix_input];
   };
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -196,8 +341,8 @@ Float Aggregator::apply_not_applicable(
 Float Aggregator::apply_numerical(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.input_col_ < _peripheral.num_numericals());
@@ -210,16 +355,14 @@ Float Aggregator::apply_numerical(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -227,8 +370,8 @@ Float Aggregator::apply_numerical(
 Float Aggregator::apply_same_units_categorical(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.input_col_ < _peripheral.num_categoricals());
@@ -250,16 +393,14 @@ Float Aggregator::apply_same_units_categorical(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -267,8 +408,8 @@ Float Aggregator::apply_same_units_categorical(
 Float Aggregator::apply_same_units_discrete(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.input_col_ < _peripheral.num_discretes());
@@ -286,16 +427,14 @@ Float Aggregator::apply_same_units_discrete(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -303,8 +442,8 @@ Float Aggregator::apply_same_units_discrete(
 Float Aggregator::apply_same_units_numerical(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.input_col_ < _peripheral.num_numericals());
@@ -322,16 +461,14 @@ Float Aggregator::apply_same_units_numerical(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -340,8 +477,8 @@ Float Aggregator::apply_subfeatures(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
     const containers::Features &_subfeatures,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_abstract_feature.input_col_ < _subfeatures.size());
@@ -354,16 +491,14 @@ Float Aggregator::apply_subfeatures(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -371,8 +506,8 @@ Float Aggregator::apply_subfeatures(
 Float Aggregator::apply_text(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
-    const std::vector<containers::Match> &_matches,
-    const std::function<bool(const containers::Match &)> &_condition_function,
+    const std::span<const containers::Match> _matches,
+    const CompiledConditions &_conditions,
     const containers::AbstractFeature &_abstract_feature,
     const rfl::Ref<Memoization> &_memoization) {
   assert_true(_peripheral.text_.size() == _peripheral.word_indices_.size());
@@ -401,16 +536,14 @@ Float Aggregator::apply_text(
 
   if (is_first_last(_abstract_feature.aggregation_)) {
     return apply_first_last(_population, _peripheral, _matches, extract_value,
-                            _condition_function, _abstract_feature,
+                            _conditions, _abstract_feature,
                             _memoization);
   }
 
-  memorize_numerical_range(_matches, extract_value, _condition_function,
+  memorize_numerical_range(_matches, extract_value, _conditions,
                            _abstract_feature, _memoization);
 
-  return aggregate_numerical_range(_memoization->numerical_begin(),
-                                   _memoization->numerical_end(),
-                                   _abstract_feature.aggregation_);
+  return aggregate_memoized(_abstract_feature.aggregation_, _memoization);
 }
 
 // ----------------------------------------------------------------------------
@@ -0,0 +1,378 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "fastprop/algorithm/ColumnAggregator.hpp"
+
+#include "debug/assert_true.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fastprop {
+namespace algorithm {
+namespace {
+
+// The floating point sums are accumulated in order and in the same way as
+// helpers::Aggregations does, so the results are identical to the ones of the
+// Aggregator. The counts are integers, so the compiler is free to vectorize
+// them. Just like the Aggregator, all kernels ignore NaN and infinite values.
+
+/// Whether _val is neither NaN nor infinite.
+inline bool is_finite(const Float _val) { return _val - _val == 0.0; }
+
+/// Counts the finite values.
+size_t count_finite(const Float* _begin, const size_t _n) {
+  size_t count = 0;
+  for (size_t i = 0; i < _n; ++i) {
+    count += is_finite(_begin[i]) ? 1 : 0;
+  }
+  return count;
+}
+
+/// Counts the finite values.
+Float count_kernel(const Float* _begin, const size_t _n) {
+  return static_cast<Float>(count_finite(_begin, _n));
+}
+
+/// Finds the maximum of the finite values.
+Float max_kernel(const Float* _begin, const size_t _n) {
+  constexpr Float lowest = -std::numeric_limits<Float>::infinity();
+  Float max = lowest;
+  size_t count = 0;
+  for (size_t i = 0; i < _n; ++i) {
+    const bool finite = is_finite(_begin[i]);
+    max = std::max(max, finite ? _begin[i] : lowest);
+    count += finite ? 1 : 0;
+  }
+  return count > 0 ? max : NAN;
+}
+
+/// Finds the minimum of the finite values.
+Float min_kernel(const Float* _begin, const size_t _n) {
+  constexpr Float highest = std::numeric_limits<Float>::infinity();
+  Float min = highest;
+  size_t count = 0;
+  for (size_t i = 0; i < _n; ++i) {
+    const bool finite = is_finite(_begin[i]);
+    min = std::min(min, finite ? _begin[i] : highest);
+    count += finite ? 1 : 0;
+  }
+  return count > 0 ? min : NAN;
+}
+
+/// Sums up the finite values.
+Float sum_kernel(const Float* _begin, const size_t _n) {
+  Float sum = 0.0;
+  for (size_t i = 0; i < _n; ++i) {
+    sum += is_finite(_begin[i]) ? _begin[i] : 0.0;
+  }
+  return sum;
+}
+
+/// Takes the average of the finite values.
+Float avg_kernel(const Float* _begin, const size_t _n) {
+  Float sum = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < _n; ++i) {
+    const bool finite = is_finite(_begin[i]);
+    sum += finite ? _begin[i] : 0.0;
+    count += finite ? 1 : 0;
+  }
+  return count > 0 ? sum / static_cast<Float>(count) : NAN;
+}
+
+/// Takes the (population) variance of the finite values.
+Float var_kernel(const Float* _begin, const size_t _n) {
+  const auto count = count_kernel(_begin, _n);
+
+  if (count == 0.0) {
+    return NAN;
+  }
+
+  const auto mean = sum_kernel(_begin, _n) / count;
+
+  Float sum_squares = 0.0;
+  for (size_t i = 0; i < _n; ++i) {
+    const auto diff = is_finite(_begin[i]) ? _begin[i] - mean : 0.0;
+    sum_squares += diff * diff / count;
+  }
+
+  return sum_squares;
+}
+
+/// Takes the standard deviation of the finite values.
+Float stddev_kernel(const Float* _begin, const size_t _n) {
+  return std::sqrt(var_kernel(_begin, _n));
+}
+
+/// Applies _kernel to every segment.
+template <class KernelType>
+void reduce_segments(const KernelType& _kernel,
+                     const std::vector<size_t>& _offsets,
+                     const std::vector<Float>& _values, Float* _out,
+                     const size_t _stride) {
+  assert_true(_offsets.size() > 0);
+  assert_true(_offsets.back() == _values.size());
+
+  for (size_t k = 0; k + 1 < _offsets.size(); ++k) {
+    _out[k * _stride] = _kernel(_values.data() + _offsets[k],
+                                _offsets[k + 1] - _offsets[k]);
+  }
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+void ColumnAggregator::apply_aggregation(
+    const MatchCache& _match_cache,
+    const containers::AbstractFeature& _abstract_feature,
+    const CompiledConditions& _conditions, const size_t _begin,
+    const size_t _end, Workspace* _workspace, Float* _out,
+    const size_t _stride) {
+  assert_true(is_supported(_abstract_feature));
+
+  assert_true(_abstract_feature.peripheral_ < _match_cache.num_peripheral());
+
+  gather_matches(_match_cache, _begin, _end, _workspace);
+
+  gather_values(_match_cache, _abstract_feature, _workspace);
+
+  const auto& offsets = _workspace->offsets_.at(_abstract_feature.peripheral_);
+
+  if (_conditions.empty()) {
+    reduce(_abstract_feature.aggregation_, offsets, _workspace->values_, _out,
+           _stride);
+    return;
+  }
+
+  mask_values(_abstract_feature.peripheral_, _conditions, _workspace);
+
+  reduce(_abstract_feature.aggregation_, offsets, _workspace->masked_, _out,
+         _stride);
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnAggregator::gather_matches(const MatchCache& _match_cache,
+                                      const size_t _begin, const size_t _end,
+                                      Workspace* _workspace) {
+  assert_true(_begin <= _end);
+
+  if (_workspace->match_cache_ == &_match_cache &&
+      _workspace->begin_ == _begin && _workspace->end_ == _end) {
+    return;
+  }
+
+  const auto num_peripheral = _match_cache.num_peripheral();
+
+  _workspace->matches_.resize(num_peripheral);
+
+  _workspace->offsets_.resize(num_peripheral);
+
+  for (size_t i = 0; i < num_peripheral; ++i) {
+    _match_cache.gather_matches(i, _begin, _end, &_workspace->offsets_[i],
+                                &_workspace->matches_[i]);
+  }
+
+  _workspace->match_cache_ = &_match_cache;
+
+  _workspace->begin_ = _begin;
+
+  _workspace->end_ = _end;
+
+  _workspace->values_key_ = std::nullopt;
+
+  _workspace->selection_conditions_ = std::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnAggregator::gather_values(
+    const MatchCache& _match_cache,
+    const containers::AbstractFeature& _abstract_feature,
+    Workspace* _workspace) {
+  const auto key = ValuesKey(
+      _abstract_feature.peripheral_,
+      static_cast<size_t>(_abstract_feature.data_used_.value()),
+      _abstract_feature.input_col_, _abstract_feature.output_col_);
+
+  if (_workspace->values_key_ == key) {
+    return;
+  }
+
+  const auto& population =
+      _match_cache.table_holder()
+          .main_tables()
+          .at(_abstract_feature.peripheral_)
+          .df();
+
+  const auto& peripheral =
+      _match_cache.table_holder().peripheral_tables().at(
+          _abstract_feature.peripheral_);
+
+  const auto& matches = _workspace->matches_.at(_abstract_feature.peripheral_);
+
+  auto& values = _workspace->values_;
+
+  values.resize(matches.size());
+
+  const auto gather = [&matches, &values](const Float* _input) {
+    for (size_t k = 0; k < matches.size(); ++k) {
+      values[k] = _input[matches[k].ix_input];
+    }
+  };
+
+  const auto gather_diff = [&matches, &values](const Float* _output,
+                                               const Float* _input) {
+    for (size_t k = 0; k < matches.size(); ++k) {
+      values[k] = _output[matches[k].ix_output] - _input[matches[k].ix_input];
+    }
+  };
+
+  switch (_abstract_feature.data_used_.value()) {
+    case enums::DataUsed::value_of<"discrete">(): {
+      const auto col = peripheral.discrete_col(_abstract_feature.input_col_);
+      gather(col.begin());
+      break;
+    }
+
+    case enums::DataUsed::value_of<"na">():
+      std::fill(values.begin(), values.end(), 0.0);
+      break;
+
+    case enums::DataUsed::value_of<"numerical">(): {
+      const auto col = peripheral.numerical_col(_abstract_feature.input_col_);
+      gather(col.begin());
+      break;
+    }
+
+    case enums::DataUsed::value_of<"same_units_discrete">():
+    case enums::DataUsed::value_of<"same_units_discrete_ts">(): {
+      const auto col1 = population.discrete_col(_abstract_feature.output_col_);
+      const auto col2 = peripheral.discrete_col(_abstract_feature.input_col_);
+      gather_diff(col1.begin(), col2.begin());
+      break;
+    }
+
+    case enums::DataUsed::value_of<"same_units_numerical">():
+    case enums::DataUsed::value_of<"same_units_numerical_ts">(): {
+      const auto col1 = population.numerical_col(_abstract_feature.output_col_);
+      const auto col2 = peripheral.numerical_col(_abstract_feature.input_col_);
+      gather_diff(col1.begin(), col2.begin());
+      break;
+    }
+
+    default:
+      assert_msg(false, "Unsupported data_used: '" +
+                            _abstract_feature.data_used_.name() + "'.");
+  }
+
+  _workspace->values_key_ = key;
+}
+
+// ----------------------------------------------------------------------------
+
+bool ColumnAggregator::is_supported(
+    const containers::AbstractFeature& _abstract_feature) {
+  switch (_abstract_feature.aggregation_.value()) {
+    case enums::Aggregation::value_of<"AVG">():
+    case enums::Aggregation::value_of<"COUNT">():
+    case enums::Aggregation::value_of<"MAX">():
+    case enums::Aggregation::value_of<"MIN">():
+    case enums::Aggregation::value_of<"STDDEV">():
+    case enums::Aggregation::value_of<"SUM">():
+    case enums::Aggregation::value_of<"VAR">():
+      break;
+
+    default:
+      return false;
+  }
+
+  switch (_abstract_feature.data_used_.value()) {
+    case enums::DataUsed::value_of<"na">():
+      return _abstract_feature.aggregation_.value() ==
+             enums::Aggregation::value_of<"COUNT">();
+
+    case enums::DataUsed::value_of<"discrete">():
+    case enums::DataUsed::value_of<"numerical">():
+    case enums::DataUsed::value_of<"same_units_discrete">():
+    case enums::DataUsed::value_of<"same_units_discrete_ts">():
+    case enums::DataUsed::value_of<"same_units_numerical">():
+    case enums::DataUsed::value_of<"same_units_numerical_ts">():
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnAggregator::mask_values(const size_t _peripheral_ix,
+                                   const CompiledConditions& _conditions,
+                                   Workspace* _workspace) {
+  const auto& matches = _workspace->matches_.at(_peripheral_ix);
+
+  if (_workspace->selection_conditions_ != _conditions.conditions()) {
+    _conditions.select(matches, &_workspace->selection_);
+    _workspace->selection_conditions_.emplace(_conditions.conditions());
+  }
+
+  const auto& selection = _workspace->selection_;
+
+  const auto& values = _workspace->values_;
+
+  auto& masked = _workspace->masked_;
+
+  assert_true(selection.size() == values.size());
+
+  masked.resize(values.size());
+
+  for (size_t k = 0; k < values.size(); ++k) {
+    masked[k] = selection[k] ? values[k] : NAN;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void ColumnAggregator::reduce(const enums::Aggregation _aggregation,
+                              const std::vector<size_t>& _offsets,
+                              const std::vector<Float>& _values, Float* _out,
+                              const size_t _stride) {
+  switch (_aggregation.value()) {
+    case enums::Aggregation::value_of<"AVG">():
+      return reduce_segments(avg_kernel, _offsets, _values, _out, _stride);
+
+    case enums::Aggregation::value_of<"COUNT">():
+      return reduce_segments(count_kernel, _offsets, _values, _out, _stride);
+
+    case enums::Aggregation::value_of<"MAX">():
+      return reduce_segments(max_kernel, _offsets, _values, _out, _stride);
+
+    case enums::Aggregation::value_of<"MIN">():
+      return reduce_segments(min_kernel, _offsets, _values, _out, _stride);
+
+    case enums::Aggregation::value_of<"STDDEV">():
+      return reduce_segments(stddev_kernel, _offsets, _values, _out, _stride);
+
+    case enums::Aggregation::value_of<"SUM">():
+      return reduce_segments(sum_kernel, _offsets, _values, _out, _stride);
+
+    case enums::Aggregation::value_of<"VAR">():
+      return reduce_segments(var_kernel, _offsets, _values, _out, _stride);
+
+    default:
+      assert_msg(false, "Unsupported aggregation: '" + _aggregation.name() +
+                            "'.");
+  }
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
@@ -0,0 +1,89 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "fastprop/algorithm/CompiledConditions.hpp"
+
+#include <algorithm>
+
+namespace fastprop {
+namespace algorithm {
+// ----------------------------------------------------------------------------
+
+CompiledConditions::CompiledConditions(
+    const std::vector<containers::Condition>& _conditions,
+    const std::vector<Predicate>& _predicates)
+    : conditions_(_conditions), predicates_(_predicates) {}
+
+// ----------------------------------------------------------------------------
+
+bool CompiledConditions::depends_on_output() const {
+  const auto on_output = [](const Predicate& _p) -> bool {
+    return _p.op_ != Predicate::Op::categorical;
+  };
+  return std::ranges::any_of(predicates_, on_output);
+}
+
+// ----------------------------------------------------------------------------
+
+void CompiledConditions::select(
+    const std::span<const containers::Match> _matches,
+    std::vector<std::uint8_t>* _selection) const {
+  _selection->resize(_matches.size());
+
+  std::fill(_selection->begin(), _selection->end(), 1);
+
+  for (const auto& p : predicates_) {
+    select_one(p, _matches, _selection->data());
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void CompiledConditions::select_one(
+    const Predicate& _p, const std::span<const containers::Match> _matches,
+    std::uint8_t* _selection) {
+  const auto n = _matches.size();
+
+  const auto m = _matches.data();
+
+  switch (_p.op_) {
+    case Predicate::Op::categorical: {
+      const auto col = _p.input_int_;
+      const auto category_used = _p.category_used_;
+      for (size_t k = 0; k < n; ++k) {
+        _selection[k] &= (col[m[k].ix_input] == category_used);
+      }
+      return;
+    }
+
+    case Predicate::Op::lag: {
+      const auto ts_input = _p.input_ts_;
+      const auto ts_output = _p.output_ts_;
+      const auto lower = _p.bound_lower_;
+      const auto upper = _p.bound_upper_;
+      for (size_t k = 0; k < n; ++k) {
+        const auto t_in = ts_input[m[k].ix_input];
+        const auto t_out = ts_output[m[k].ix_output];
+        _selection[k] &= (t_in + upper > t_out) & (t_in + lower <= t_out);
+      }
+      return;
+    }
+
+    case Predicate::Op::same_units_categorical: {
+      const auto col1 = _p.output_int_;
+      const auto col2 = _p.input_int_;
+      for (size_t k = 0; k < n; ++k) {
+        _selection[k] &= (col1[m[k].ix_output] == col2[m[k].ix_input]);
+      }
+      return;
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
@@ -11,59 +11,68 @@ namespace fastprop {
 namespace algorithm {
 // ----------------------------------------------------------------------------
 
-std::vector<std::function<bool(const containers::Match &)>>
-ConditionParser::make_condition_functions(
+std::vector<CompiledConditions> ConditionParser::make_compiled_conditions(
     const TableHolder &_table_holder, const std::vector<size_t> &_index,
     const std::vector<containers::AbstractFeature> &_abstract_features) {
-  const auto make_function = [&_table_holder,
-                              &_abstract_features](const size_t ix) {
+  const auto compile = [&_table_holder, &_abstract_features](const size_t ix) {
     assert_true(ix < _abstract_features.size());
-    return ConditionParser::make_apply_conditions(_table_holder,
-                                                  _abstract_features.at(ix));
+    return ConditionParser::make_compiled_conditions(_table_holder,
+                                                     _abstract_features.at(ix));
   };
 
-  return _index | std::views::transform(make_function) |
+  return _index | std::views::transform(compile) |
          std::ranges::to<std::vector>();
 }
 
 // ----------------------------------------------------------------------------
 
-std::function<bool(const containers::Match &)>
-ConditionParser::make_apply_conditions(
+CompiledConditions ConditionParser::make_compiled_conditions(
     const TableHolder &_table_holder,
     const containers::AbstractFeature &_abstract_feature) {
-  const auto conditions = parse_conditions(_table_holder, _abstract_feature);
+  assert_true(_table_holder.main_tables().size() ==
+              _table_holder.peripheral_tables().size());
+
+  assert_true(_abstract_feature.peripheral_ <
+              _table_holder.main_tables().size());
+
+  const auto &population =
+      _table_holder.main_tables().at(_abstract_feature.peripheral_).df();
 
-  return [conditions](const containers::Match &match) -> bool {
-    for (const auto &cond : conditions) {
-      if (!cond(match)) {
-        return false;
-      }
-    }
+  const auto &peripheral =
+      _table_holder.peripheral_tables().at(_abstract_feature.peripheral_);
 
-    return true;
+  const auto parse = [&_abstract_feature, &population,
+                      &peripheral](const containers::Condition &cond) {
+    assert_true(cond.peripheral_ == _abstract_feature.peripheral_);
+    return ConditionParser::parse_single_condition(population, peripheral,
+                                                   cond);
   };
+
+  const auto predicates = _abstract_feature.conditions_ |
+                          std::views::transform(parse) |
+                          std::ranges::to<std::vector>();
+
+  return CompiledConditions(_abstract_feature.conditions_, predicates);
 }
 
 // ----------------------------------------------------------------------------
 
-std::function<bool(const containers::Match &)>
-ConditionParser::make_categorical(const containers::DataFrame &_peripheral,
-                                  const containers::Condition &_condition) {
+CompiledConditions::Predicate ConditionParser::make_categorical(
+    const containers::DataFrame &_peripheral,
+    const containers::Condition &_condition) {
   assert_true(_condition.input_col_ < _peripheral.num_categoricals());
 
   const auto col = _peripheral.categorical_col(_condition.input_col_);
 
-  const auto category_used = _condition.category_used_;
-
-  return [col, category_used](const containers::Match &match) -> bool {
-    return (col[match.ix_input] == category_used);
-  };
+  return CompiledConditions::Predicate{
+      .op_ = CompiledConditions::Predicate::Op::categorical,
+      .input_int_ = col.begin(),
+      .category_used_ = _condition.category_used_};
 }
 
 // ----------------------------------------------------------------------------
 
-std::function<bool(const containers::Match &)> ConditionParser::make_lag(
+CompiledConditions::Predicate ConditionParser::make_lag(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
     const containers::Condition &_condition) {
@@ -75,20 +84,17 @@ std::function<bool(const containers::Match &)> ConditionParser::make_lag(
 
   const auto col2 = _peripheral.time_stamp_col();
 
-  const auto lower = _condition.bound_lower_;
-
-  const auto upper = _condition.bound_upper_;
-
-  return [col1, col2, lower, upper](const containers::Match &match) -> bool {
-    return (col2[match.ix_input] + upper > col1[match.ix_output]) &&
-           (col2[match.ix_input] + lower <= col1[match.ix_output]);
-  };
+  return CompiledConditions::Predicate{
+      .op_ = CompiledConditions::Predicate::Op::lag,
+      .input_ts_ = col2.begin(),
+      .output_ts_ = col1.begin(),
+      .bound_lower_ = _condition.bound_lower_,
+      .bound_upper_ = _condition.bound_upper_};
 }
 
 // ----------------------------------------------------------------------------
 
-std::function<bool(const containers::Match &)>
-ConditionParser::make_same_units_categorical(
+CompiledConditions::Predicate ConditionParser::make_same_units_categorical(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
     const containers::Condition &_condition) {
@@ -100,45 +106,15 @@ ConditionParser::make_same_units_categorical(
 
   const auto col2 = _peripheral.categorical_col(_condition.input_col_);
 
-  return [col1, col2](const containers::Match &match) -> bool {
-    return (col1[match.ix_output] == col2[match.ix_input]);
-  };
-}
-
-// ----------------------------------------------------------------------------
-
-std::vector<std::function<bool(const containers::Match &)>>
-ConditionParser::parse_conditions(
-    const TableHolder &_table_holder,
-    const containers::AbstractFeature &_abstract_feature) {
-  assert_true(_table_holder.main_tables().size() ==
-              _table_holder.peripheral_tables().size());
-
-  assert_true(_abstract_feature.peripheral_ <
-              _table_holder.main_tables().size());
-
-  const auto &population =
-      _table_holder.main_tables().at(_abstract_feature.peripheral_).df();
-
-  const auto &peripheral =
-      _table_holder.peripheral_tables().at(_abstract_feature.peripheral_);
-
-  const auto parse = [_abstract_feature, &population,
-                      &peripheral](const containers::Condition &cond)
-      -> std::function<bool(const containers::Match &)> {
-    assert_true(cond.peripheral_ == _abstract_feature.peripheral_);
-    return ConditionParser::parse_single_condition(population, peripheral,
-                                                   cond);
-  };
-
-  return _abstract_feature.conditions_ | std::views::transform(parse) |
-         std::ranges::to<std::vector>();
+  return CompiledConditions::Predicate{
+      .op_ = CompiledConditions::Predicate::Op::same_units_categorical,
+      .input_int_ = col2.begin(),
+      .output_int_ = col1.begin()};
 }
 
 // ----------------------------------------------------------------------------
 
-std::function<bool(const containers::Match &)>
-ConditionParser::parse_single_condition(
+CompiledConditions::Predicate ConditionParser::parse_single_condition(
     const containers::DataFrame &_population,
     const containers::DataFrame &_peripheral,
     const containers::Condition &_condition) {
@@ -155,7 +131,7 @@ ConditionParser::parse_single_condition(
     default:
       throw_unless(false,
                    "Unknown condition: '" + _condition.data_used_.name() + "'");
-      return [](const containers::Match &) { return true; };
+      return CompiledConditions::Predicate{};
   }
 }
 
@@ -8,14 +8,18 @@
 #include "fastprop/algorithm/FastProp.hpp"
 
 #include "fastprop/algorithm/Aggregator.hpp"
+#include "fastprop/algorithm/ColumnAggregator.hpp"
 #include "fastprop/algorithm/ConditionParser.hpp"
 #include "fastprop/algorithm/RSquared.hpp"
 #include "fastprop/algorithm/TableHolderParams.hpp"
+#include "fastprop/algorithm/WindowAggregator.hpp"
 #include "helpers/Matchmaker.hpp"
+#include "multithreading/ThreadPool.hpp"
 #include "transpilation/HumanReadableSQLGenerator.hpp"
 
 #include <memory>
 #include <random>
+#include <span>
 
 namespace fastprop {
 namespace algorithm {
@@ -51,25 +55,37 @@ FastProp::FastProp(const ReflectionType &_val)
 // ---------------------------------------------------------------------------
 
 void FastProp::build_row(
-    const TableHolder &_table_holder,
+    const MatchCache &_match_cache,
     const std::vector<containers::Features> &_subfeatures,
-    const std::vector<size_t> &_index,
-    const std::vector<std::function<bool(const containers::Match &)>>
-        &_condition_functions,
-    const size_t _rownum, const rfl::Ref<Memoization> &_memoization,
-    Float *_row) const {
-  assert_true(_condition_functions.size() == _index.size());
+    const std::vector<size_t> &_index, const std::vector<bool> &_is_columnar,
+    const std::vector<CompiledConditions> &_conditions,
+    const size_t _pos, const rfl::Ref<Memoization> &_memoization,
+    std::vector<std::vector<containers::Match>> *_buffers, Float *_row) const {
+  assert_true(_conditions.size() == _index.size());
 
-  const auto all_matches = make_matches(_table_holder, _rownum);
+  assert_true(_is_columnar.size() == _index.size());
 
-  assert_true(all_matches.size() == _table_holder.peripheral_tables().size());
+  const auto &table_holder = _match_cache.table_holder();
 
-  assert_true(_table_holder.main_tables().size() ==
-              _table_holder.peripheral_tables().size());
+  assert_true(table_holder.main_tables().size() ==
+              table_holder.peripheral_tables().size());
+
+  assert_true(_buffers->size() == table_holder.peripheral_tables().size());
 
-  assert_true(_subfeatures.size() <= _table_holder.peripheral_tables().size());
+  auto all_matches =
+      std::vector<std::span<const containers::Match>>(_buffers->size());
+
+  for (size_t i = 0; i < all_matches.size(); ++i) {
+    all_matches[i] = _match_cache.matches(i, _pos, &_buffers->at(i));
+  }
+
+  assert_true(_subfeatures.size() <= table_holder.peripheral_tables().size());
 
   for (size_t i = 0; i < _index.size(); ++i) {
+    if (_is_columnar[i]) {
+      continue;
+    }
+
     const auto ix = _index.at(i);
 
     assert_true(ix < abstract_features().size());
@@ -77,24 +93,22 @@ void FastProp::build_row(
     const auto &abstract_feature = abstract_features().at(ix);
 
     assert_true(abstract_feature.peripheral_ <
-                _table_holder.peripheral_tables().size());
+                table_holder.peripheral_tables().size());
 
     const auto &population =
-        _table_holder.main_tables().at(abstract_feature.peripheral_).df();
+        table_holder.main_tables().at(abstract_feature.peripheral_).df();
 
     const auto &peripheral =
-        _table_holder.peripheral_tables().at(abstract_feature.peripheral_);
+        table_holder.peripheral_tables().at(abstract_feature.peripheral_);
 
     const auto subf = abstract_feature.peripheral_ < _subfeatures.size()
                           ? _subfeatures.at(abstract_feature.peripheral_)
                           : std::optional<containers::Features>();
 
-    const auto &matches = all_matches.at(abstract_feature.peripheral_);
-
-    const auto &condition_function = _condition_functions.at(i);
+    const auto matches = all_matches.at(abstract_feature.peripheral_);
 
     const auto value = Aggregator::apply_aggregation(
-        population, peripheral, subf, matches, condition_function,
+        population, peripheral, subf, matches, _conditions.at(i),
         abstract_feature, _memoization);
 
     _row[i] = (std::isnan(value) || std::isinf(value)) ? 0.0 : value;
@@ -103,93 +117,115 @@ void FastProp::build_row(
 
 // ----------------------------------------------------------------------------
 
-void FastProp::build_rows(const TransformParams &_params,
-                          const std::vector<containers::Features> &_subfeatures,
-                          const std::shared_ptr<std::vector<size_t>> &_rownums,
-                          const size_t _thread_num,
-                          std::atomic<size_t> *_num_completed,
-                          containers::Features *_features) const {
+void FastProp::build_rows(
+    const TransformParams &_params,
+    const std::vector<containers::Features> &_subfeatures,
+    const MatchCache &_match_cache, const size_t _thread_num,
+    multithreading::WorkStealingScheduler *_scheduler,
+    std::atomic<size_t> *_num_completed,
+    containers::Features *_features) const {
   if (_features->size() == 0) {
     return;
   }
 
-  const auto rownums =
-      make_rownums(_thread_num, _params.population_.nrows(), _rownums);
+  const auto memoization = rfl::Ref<Memoization>::make();
 
-  const auto population_view =
-      containers::DataFrameView(_params.population_, rownums);
+  const auto conditions = ConditionParser::make_compiled_conditions(
+      _match_cache.table_holder(), _params.index_, abstract_features());
 
-  const auto make_staging_table_colname =
-      [](const std::string &_colname) -> std::string {
-    return transpilation::HumanReadableSQLGenerator()
-        .make_staging_table_colname(_colname);
-  };
+  const auto &rownums = _match_cache.rownums();
 
-  const auto params = TableHolderParams{
-      .feature_container_ = std::nullopt,
-      .make_staging_table_colname_ = make_staging_table_colname,
-      .peripheral_ = _params.peripheral_,
-      .peripheral_names_ = peripheral(),
-      .placeholder_ = placeholder(),
-      .population_ = population_view,
-      .row_index_container_ = std::nullopt,
-      .word_index_container_ = _params.word_indices_};
+  auto buffers = std::vector<std::vector<containers::Match>>(
+      _match_cache.num_peripheral());
 
-  const auto table_holder = TableHolder(params);
+  const auto is_columnar_feature = [this](const size_t _ix) -> bool {
+    return ColumnAggregator::is_supported(abstract_features().at(_ix));
+  };
 
-  const auto memoization = rfl::Ref<Memoization>::make();
+  const auto is_columnar = _params.index_ |
+                           std::views::transform(is_columnar_feature) |
+                           std::ranges::to<std::vector<bool>>();
 
-  constexpr size_t log_iter = 5000;
+  const auto is_windowed_feature = [this, &_params, &_match_cache,
+                                    &conditions](const size_t _j) -> bool {
+    return WindowAggregator::is_supported(
+        _match_cache, abstract_features().at(_params.index_[_j]),
+        conditions.at(_j));
+  };
+
+  const auto is_windowed = std::views::iota(0uz, _params.index_.size()) |
+                           std::views::transform(is_windowed_feature) |
+                           std::ranges::to<std::vector<bool>>();
 
-  const auto condition_functions = ConditionParser::make_condition_functions(
-      table_holder, _params.index_, abstract_features());
+  auto workspace = ColumnAggregator::Workspace();
 
-  const auto nrows = _rownums ? _rownums->size() : _params.population_.nrows();
+  auto window_workspace = WindowAggregator::Workspace();
 
   assert_true(_features->size() == _params.index_.size());
 
   const auto ncols = _features->size();
 
-  const auto cache_size = std::min(log_iter, rownums->size());
+  constexpr size_t log_iter = 5000;
 
-  auto cache = std::vector<Float>(cache_size * ncols);
+  size_t next_log = log_iter;
 
-  for (size_t i = 0; i < rownums->size(); ++i) {
-    if (i % log_iter == 0 && i != 0) {
-      cache_to_features(*rownums, i - log_iter, cache, _features);
+  auto cache = std::vector<Float>();
 
-      _num_completed->fetch_add(log_iter);
+  while (const auto chunk = _scheduler->next(_thread_num)) {
+    const auto [begin, end] = *chunk;
 
-      if (_thread_num == 0) {
-        log_progress(_params.logger_, nrows, _num_completed->load());
-      }
+    assert_true(begin <= end);
+    assert_true(end <= rownums.size());
+
+    cache.resize((end - begin) * ncols);
+
+    for (size_t i = begin; i < end; ++i) {
+      memoization->reset();
+
+      build_row(_match_cache, _subfeatures, _params.index_, is_columnar,
+                conditions, i, memoization, &buffers,
+                &cache[ncols * (i - begin)]);
     }
 
-    memoization->reset();
+    for (size_t j = 0; j < ncols; ++j) {
+      if (!is_columnar[j]) {
+        continue;
+      }
 
-    assert_msg(ncols * (i % log_iter) < cache.size(),
-               "ncols: " + std::to_string(ncols) + ", i: " + std::to_string(i) +
-                   ", log_iter: " + std::to_string(log_iter) +
-                   ", cache.size(): " + std::to_string(cache.size()));
+      if (is_windowed[j]) {
+        WindowAggregator::apply_aggregation(
+            _match_cache, abstract_features().at(_params.index_[j]),
+            conditions.at(j), begin, end, &window_workspace, &cache[j], ncols);
+      } else {
+        ColumnAggregator::apply_aggregation(
+            _match_cache, abstract_features().at(_params.index_[j]),
+            conditions.at(j), begin, end, &workspace, &cache[j], ncols);
+      }
 
-    build_row(table_holder, _subfeatures, _params.index_, condition_functions,
-              (*rownums)[i], memoization, &cache[ncols * (i % log_iter)]);
-  }
+      for (size_t i = 0; i < end - begin; ++i) {
+        auto &value = cache[ncols * i + j];
+        value = (std::isnan(value) || std::isinf(value)) ? 0.0 : value;
+      }
+    }
 
-  const size_t begin = rownums->size() > log_iter
-                           ? rownums->size() - (rownums->size() % log_iter)
-                           : static_cast<size_t>(0);
+    cache_to_features(rownums, begin, end, cache, _features);
 
-  cache_to_features(*rownums, begin, cache, _features);
+    const auto num_completed =
+        _num_completed->fetch_add(end - begin) + end - begin;
 
-  _num_completed->fetch_add(nrows % log_iter);
+    if (_thread_num == 0 && num_completed >= next_log) {
+      log_progress(_params.logger_, rownums.size(), num_completed);
+      next_log = num_completed + log_iter;
+    }
+  }
 }
 
 // ----------------------------------------------------------------------------
 
 std::vector<containers::Features> FastProp::build_subfeatures(
     const TransformParams &_params,
-    const std::shared_ptr<std::vector<size_t>> &_rownums) const {
+    const std::shared_ptr<std::vector<size_t>> &_rownums,
+    const MatchCache &_match_cache) const {
   assert_true(placeholder().joined_tables().size() <= subfeatures().size());
 
   std::vector<containers::Features> features;
@@ -209,8 +245,11 @@ std::vector<containers::Features> FastProp::build_subfeatures(
 
     const auto subfeature_index = make_subfeature_index(i, _params.index_);
 
-    const auto subfeature_rownums = make_subfeature_rownums(
-        _rownums, _params.population_, new_population, i);
+    const auto subfeature_rownums =
+        _match_cache.is_cached()
+            ? _match_cache.unique_inputs(i)
+            : make_subfeature_rownums(_rownums, _params.population_,
+                                      new_population, i);
 
     const auto ix = find_peripheral_ix(joined_table.name());
 
@@ -243,24 +282,22 @@ std::vector<containers::Features> FastProp::build_subfeatures(
 // ----------------------------------------------------------------------------
 
 void FastProp::cache_to_features(const std::vector<size_t> &_rownums,
-                                 const size_t _begin,
+                                 const size_t _begin, const size_t _end,
                                  const std::vector<Float> &_cache,
                                  containers::Features *_features) const {
   const size_t ncols = _features->size();
 
-  const size_t nrows =
-      std::min(_cache.size() / ncols, _rownums.size() - _begin);
+  assert_true(_begin <= _end);
+  assert_true(_end <= _rownums.size());
+  assert_true((_end - _begin) * ncols <= _cache.size());
 
   for (size_t j = 0; j < ncols; ++j) {
-    for (size_t i = 0; i < nrows; ++i) {
-      assert_true(_begin + i < _rownums.size());
-      assert_true(i * ncols + j < _cache.size());
-
-      const auto rownum = _rownums[_begin + i];
+    for (size_t i = _begin; i < _end; ++i) {
+      const auto rownum = _rownums[i];
 
       assert_true(rownum < _features->at(j).size());
 
-      _features->at(rownum, j) = _cache[i * ncols + j];
+      _features->at(rownum, j) = _cache[(i - _begin) * ncols + j];
     }
   }
 }
@@ -276,6 +313,15 @@ std::vector<Float> FastProp::calc_r_squared(
 
   constexpr size_t batch_size = 100;
 
+  const auto match_cache = make_match_cache(
+      _params.population_, _params.peripheral_, _params.word_indices_,
+      _rownums, true, MatchCache::default_memory_budget(_params.temp_dir_),
+      _params.temp_dir_);
+
+  // The chunks only depend on the matches, so they are the same for every
+  // batch.
+  const auto chunks = make_chunks(*match_cache);
+
   for (size_t begin = 0; begin < abstract_features().size();
        begin += batch_size) {
     const auto end = std::min(abstract_features().size(), begin + batch_size);
@@ -291,7 +337,8 @@ std::vector<Float> FastProp::calc_r_squared(
                                         .temp_dir_ = _params.temp_dir_,
                                         .word_indices_ = _params.word_indices_};
 
-    const auto features = transform(params, _rownums, false);
+    const auto features =
+        transform_with_cache(params, _rownums, false, match_cache, chunks);
 
     const auto r =
         RSquared::calculate(_params.population_.targets_, features, *_rownums);
@@ -511,6 +558,7 @@ void FastProp::fit(const FitParams &_params, const bool _as_subfeatures) {
       .placeholder_ = placeholder(),
       .population_ = population_view,
       .row_index_container_ = std::nullopt,
+      .temp_dir_ = _params.temp_dir_,
       .word_index_container_ = _params.word_indices_};
 
   const auto table_holder = TableHolder(params);
@@ -1149,38 +1197,6 @@ bool FastProp::is_numerical(const enums::Aggregation _agg) const {
 
 // ----------------------------------------------------------------------------
 
-std::vector<std::vector<containers::Match>> FastProp::make_matches(
-    const TableHolder &_table_holder, const size_t _rownum) const {
-  const auto make_match = [](const size_t ix_input, const size_t ix_output) {
-    return containers::Match{ix_input, ix_output};
-  };
-
-  assert_true(_table_holder.main_tables().size() ==
-              _table_holder.peripheral_tables().size());
-
-  auto all_matches = std::vector<std::vector<containers::Match>>();
-
-  for (size_t i = 0; i < _table_holder.main_tables().size(); ++i) {
-    const auto population = _table_holder.main_tables().at(i).df();
-
-    const auto peripheral = _table_holder.peripheral_tables().at(i);
-
-    auto matches = std::vector<containers::Match>();
-
-    helpers::Matchmaker<containers::DataFrame, containers::Match,
-                        decltype(make_match)>::make_matches(population,
-                                                            peripheral, _rownum,
-                                                            make_match,
-                                                            &matches);
-
-    all_matches.push_back(matches);
-  }
-
-  return all_matches;
-}
-
-// ----------------------------------------------------------------------------
-
 void FastProp::log_progress(
     const std::shared_ptr<const logging::AbstractLogger> _logger,
     const size_t _nrows, const size_t _num_completed) const {
@@ -1377,69 +1393,116 @@ std::shared_ptr<std::vector<size_t>> FastProp::make_subfeature_rownums(
     return _ix_input;
   };
 
-  std::set<size_t> unique_indices;
+  constexpr size_t block_size = 10000;
 
-  std::vector<size_t> peripheral_indices;
+  auto is_included = std::vector<bool>(peripheral.nrows());
 
-  for (const auto ix_output : *_rownums) {
-    peripheral_indices.clear();
+  auto offsets = std::vector<size_t>();
 
-    helpers::Matchmaker<containers::DataFrame, size_t, decltype(get_ix_input)>::
-        make_matches(population, peripheral, ix_output, get_ix_input,
-                     &peripheral_indices);
+  auto peripheral_indices = std::vector<size_t>();
 
-    unique_indices.insert(peripheral_indices.begin(), peripheral_indices.end());
-  }
+  const auto rownums = std::span<const size_t>(*_rownums);
 
-  return std::make_shared<std::vector<size_t>>(unique_indices.begin(),
-                                               unique_indices.end());
-}
+  for (size_t begin = 0; begin < rownums.size(); begin += block_size) {
+    const auto end = std::min(begin + block_size, rownums.size());
 
-// ----------------------------------------------------------------------------
+    helpers::Matchmaker<containers::DataFrame, size_t, decltype(get_ix_input)>::
+        make_matches(population, peripheral,
+                     rownums.subspan(begin, end - begin), get_ix_input,
+                     &offsets, &peripheral_indices);
 
-std::shared_ptr<std::vector<size_t>> FastProp::make_rownums(
-    const size_t _thread_num, const size_t _nrows,
-    const std::shared_ptr<std::vector<size_t>> &_rownums) const {
-  const size_t num_threads = get_num_threads();
+    for (const auto ix : peripheral_indices) {
+      is_included[ix] = true;
+    }
+  }
 
-  assert_true(_thread_num < num_threads);
+  auto unique_indices = std::make_shared<std::vector<size_t>>();
 
-  const auto nrows = _rownums ? _rownums->size() : _nrows;
+  for (size_t ix = 0; ix < is_included.size(); ++ix) {
+    if (is_included[ix]) {
+      unique_indices->push_back(ix);
+    }
+  }
 
-  const auto calc_rows_per_thread = [nrows, num_threads]() -> size_t {
-    size_t rows_per_thread = 0;
+  return unique_indices;
+}
 
-    while (true) {
-      const auto remaining = nrows - rows_per_thread * num_threads;
+// ----------------------------------------------------------------------------
 
-      rows_per_thread += remaining / num_threads;
+std::shared_ptr<const std::vector<size_t>> FastProp::make_chunks(
+    const MatchCache &_match_cache) const {
+  constexpr size_t chunks_per_thread = 16;
 
-      if (remaining < num_threads) {
-        break;
-      }
-    }
+  constexpr size_t max_chunk_size = 1000;
 
-    return rows_per_thread;
+  const auto calc_weight = [&_match_cache](const size_t _pos) -> size_t {
+    return 1 + _match_cache.num_matches(_pos);
   };
 
-  const size_t rows_per_thread = calc_rows_per_thread();
+  const auto weights =
+      std::views::iota(0uz, _match_cache.rownums().size()) |
+      std::views::transform(calc_weight) | std::ranges::to<std::vector>();
 
-  const size_t begin = _thread_num * rows_per_thread;
+  return multithreading::WorkStealingScheduler::make_boundaries(
+      weights, get_num_threads() * chunks_per_thread, max_chunk_size);
+}
 
-  const size_t end = (_thread_num < num_threads - 1)
-                         ? (_thread_num + 1) * rows_per_thread
-                         : nrows;
+// ----------------------------------------------------------------------------
 
-  if (_rownums) {
-    return std::make_shared<std::vector<size_t>>(_rownums->begin() + begin,
-                                                 _rownums->begin() + end);
+std::shared_ptr<const MatchCache> FastProp::make_match_cache(
+    const containers::DataFrame &_population,
+    const std::vector<containers::DataFrame> &_peripheral,
+    const helpers::WordIndexContainer &_word_indices,
+    const std::shared_ptr<std::vector<size_t>> &_rownums,
+    const bool _cache_matches, const size_t _memory_budget,
+    const std::optional<std::string> &_temp_dir) const {
+  const auto rownums =
+      _rownums ? std::shared_ptr<const std::vector<size_t>>(_rownums)
+               : std::make_shared<const std::vector<size_t>>(
+                     std::views::iota(0uz, _population.nrows()) |
+                     std::ranges::to<std::vector>());
+
+  const auto table_holder = std::make_shared<const TableHolder>(
+      make_table_holder(_population, _peripheral, _word_indices, rownums,
+                        _temp_dir));
+
+  if (!_cache_matches) {
+    return std::make_shared<const MatchCache>(table_holder, rownums, 0,
+                                              std::nullopt);
   }
 
-  const auto rownums = std::make_shared<std::vector<size_t>>(end - begin);
+  return std::make_shared<const MatchCache>(table_holder, rownums,
+                                            _memory_budget, _temp_dir);
+}
+
+// ----------------------------------------------------------------------------
+
+TableHolder FastProp::make_table_holder(
+    const containers::DataFrame &_population,
+    const std::vector<containers::DataFrame> &_peripheral,
+    const helpers::WordIndexContainer &_word_indices,
+    const std::shared_ptr<const std::vector<size_t>> &_rownums,
+    const std::optional<std::string> &_temp_dir) const {
+  const auto population_view = containers::DataFrameView(_population, _rownums);
+
+  const auto make_staging_table_colname =
+      [](const std::string &_colname) -> std::string {
+    return transpilation::HumanReadableSQLGenerator()
+        .make_staging_table_colname(_colname);
+  };
 
-  std::iota(rownums->begin(), rownums->end(), begin);
+  const auto params = TableHolderParams{
+      .feature_container_ = std::nullopt,
+      .make_staging_table_colname_ = make_staging_table_colname,
+      .peripheral_ = _peripheral,
+      .peripheral_names_ = peripheral(),
+      .placeholder_ = placeholder(),
+      .population_ = population_view,
+      .row_index_container_ = std::nullopt,
+      .temp_dir_ = _temp_dir,
+      .word_index_container_ = _word_indices};
 
-  return rownums;
+  return TableHolder(params);
 }
 
 // ---------------------------------------------------------------------------
@@ -1527,44 +1590,27 @@ bool FastProp::skip_first_last(const enums::Aggregation _agg,
 void FastProp::spawn_threads(
     const TransformParams &_params,
     const std::vector<containers::Features> &_subfeatures,
-    const std::shared_ptr<std::vector<size_t>> &_rownums,
+    const MatchCache &_match_cache,
+    const std::shared_ptr<const std::vector<size_t>> &_chunks,
     containers::Features *_features) const {
-  auto num_completed = std::atomic<size_t>(0);
-
-  const auto execute_task = [this, &_params, _subfeatures, _rownums,
-                             &num_completed,
-                             _features](const size_t _thread_num) {
-    try {
-      build_rows(_params, _subfeatures, _rownums, _thread_num, &num_completed,
-                 _features);
-    } catch (std::exception &e) {
-      if (_thread_num == 0) {
-        throw std::runtime_error(e.what());
-      }
-    }
-  };
-
-  const size_t num_threads = get_num_threads();
+  assert_true(_chunks);
 
-  std::vector<std::thread> threads;
+  assert_true(_chunks->back() == _match_cache.rownums().size());
 
-  for (size_t thread_num = 1; thread_num < num_threads; ++thread_num) {
-    threads.push_back(std::thread(execute_task, thread_num));
-  }
+  auto scheduler =
+      multithreading::WorkStealingScheduler(_chunks, get_num_threads());
 
-  try {
-    execute_task(0);
-  } catch (std::exception &e) {
-    for (auto &thr : threads) {
-      thr.join();
-    }
+  auto num_completed = std::atomic<size_t>(0);
 
-    throw std::runtime_error(e.what());
-  }
+  const auto execute_task = [this, &_params, &_subfeatures, &_match_cache,
+                             &scheduler, &num_completed,
+                             _features](const size_t _thread_num) {
+    build_rows(_params, _subfeatures, _match_cache, _thread_num, &scheduler,
+               &num_completed, _features);
+  };
 
-  for (auto &thr : threads) {
-    thr.join();
-  }
+  multithreading::ThreadPool::get().parallel_for(scheduler.num_threads(),
+                                                 execute_task);
 
   log_progress(_params.logger_, 100, 100);
 }
@@ -1595,12 +1641,32 @@ containers::Features FastProp::transform(
     const TransformParams &_params,
     const std::shared_ptr<std::vector<size_t>> &_rownums,
     const bool _as_subfeatures) const {
+  return transform_with_cache(_params, _rownums, _as_subfeatures, nullptr,
+                              nullptr);
+}
+
+// ----------------------------------------------------------------------------
+
+containers::Features FastProp::transform_with_cache(
+    const TransformParams &_params,
+    const std::shared_ptr<std::vector<size_t>> &_rownums,
+    const bool _as_subfeatures,
+    const std::shared_ptr<const MatchCache> &_match_cache,
+    const std::shared_ptr<const std::vector<size_t>> &_chunks) const {
   if (_params.population_.nrows() == 0) {
     throw std::runtime_error(
         "Population table needs to contain at least some data!");
   }
 
-  const auto subfeatures = build_subfeatures(_params, _rownums);
+  // Without a cache passed in, every match is only read once, so there is no
+  // point in caching them.
+  const auto match_cache =
+      _match_cache ? _match_cache
+                   : make_match_cache(_params.population_, _params.peripheral_,
+                                      _params.word_indices_, _rownums, false,
+                                      0, _params.temp_dir_);
+
+  const auto subfeatures = build_subfeatures(_params, _rownums, *match_cache);
 
   if (_params.logger_) {
     const auto msg = _as_subfeatures ? "FastProp: Building subfeatures..."
@@ -1612,7 +1678,9 @@ containers::Features FastProp::transform(
   auto features = containers::Features(
       _params.population_.nrows(), _params.index_.size(), _params.temp_dir_);
 
-  spawn_threads(_params, subfeatures, _rownums, &features);
+  const auto chunks = _chunks ? _chunks : make_chunks(*match_cache);
+
+  spawn_threads(_params, subfeatures, *match_cache, chunks, &features);
 
   return features;
 }
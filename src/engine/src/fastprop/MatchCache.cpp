@@ -0,0 +1,366 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "fastprop/algorithm/MatchCache.hpp"
+
+#include "debug/assert_true.hpp"
+#include "helpers/Matchmaker.hpp"
+#include "multithreading/ThreadPool.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <type_traits>
+
+namespace fastprop {
+namespace algorithm {
+namespace {
+
+/// The number of rows processed by a single task when building the cache.
+constexpr size_t block_size = 10000;
+
+/// The matches of a block of rows with every peripheral table.
+struct BlockMatches {
+  /// The offsets for every peripheral table.
+  std::vector<std::vector<size_t>> offsets_;
+
+  /// The matches with every peripheral table.
+  std::vector<std::vector<containers::Match>> matches_;
+};
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+MatchCache::MatchCache(
+    const std::shared_ptr<const TableHolder>& _table_holder,
+    const std::shared_ptr<const std::vector<size_t>>& _rownums,
+    const size_t _memory_budget, const std::optional<std::string>& _temp_dir)
+    : rownums_(_rownums),
+      table_holder_(_table_holder),
+      csr_(make_csr(_memory_budget, _temp_dir)) {
+  assert_true(rownums_);
+  assert_true(table_holder_);
+}
+
+// ----------------------------------------------------------------------------
+
+const containers::Match* MatchCache::data(const MatchesVariant& _matches) {
+  return std::visit([](const auto& _m) { return _m.data(); }, _matches);
+}
+
+// ----------------------------------------------------------------------------
+
+containers::Match* MatchCache::data(MatchesVariant* _matches) {
+  return std::visit([](auto& _m) { return _m.data(); }, *_matches);
+}
+
+// ----------------------------------------------------------------------------
+
+void MatchCache::append(const std::vector<size_t>& _offsets,
+                        const std::vector<containers::Match>& _matches,
+                        CSR* _csr) {
+  assert_true(_offsets.size() > 0);
+  assert_true(_offsets.back() == _matches.size());
+
+  const auto first = _csr->offsets_.back();
+
+  for (size_t k = 1; k < _offsets.size(); ++k) {
+    _csr->offsets_.push_back(first + _offsets[k]);
+  }
+
+  const auto append_matches = [&_matches](auto& _m) {
+    using Type = std::decay_t<decltype(_m)>;
+    if constexpr (std::is_same<Type, std::vector<containers::Match>>()) {
+      _m.insert(_m.end(), _matches.begin(), _matches.end());
+    } else {
+      const auto size = _m.size() + _matches.size();
+      if (size > _m.capacity()) {
+        _m.reserve(std::max(size, 2 * _m.capacity()));
+      }
+      for (const auto& m : _matches) {
+        _m.push_back(m);
+      }
+    }
+  };
+
+  std::visit(append_matches, _csr->matches_);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t MatchCache::default_memory_budget(
+    const std::optional<std::string>& _temp_dir) {
+  // If the engine is memory-mapped, so are the matches.
+  if (_temp_dir) {
+    return 0;
+  }
+
+  const auto num_pages = sysconf(_SC_PHYS_PAGES);
+
+  const auto page_size = sysconf(_SC_PAGE_SIZE);
+
+  if (num_pages <= 0 || page_size <= 0) {
+    return 0;
+  }
+
+  return static_cast<size_t>(num_pages) * static_cast<size_t>(page_size) / 8;
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<typename MatchCache::CSR> MatchCache::make_csr(
+    const size_t _memory_budget, const std::optional<std::string>& _temp_dir) {
+  if (_memory_budget == 0 && !_temp_dir) {
+    return std::vector<CSR>();
+  }
+
+  const auto nrows = rownums().size();
+
+  const auto num_blocks = (nrows + block_size - 1) / block_size;
+
+  // The blocks are joined in parallel, a few at a time, and then appended to
+  // the CSR structures in order. This way, every join is only done once and
+  // only a few blocks are ever held in the buffers.
+  const auto wave_size =
+      2 * std::max(multithreading::ThreadPool::get().num_threads(), 1uz);
+
+  auto buffers = std::vector<BlockMatches>(wave_size);
+
+  auto csr = std::vector<CSR>(num_peripheral());
+
+  for (auto& c : csr) {
+    c.offsets_.reserve(nrows + 1);
+    c.offsets_.push_back(0);
+    c.matches_ = std::vector<containers::Match>();
+  }
+
+  size_t num_bytes = 0;
+
+  for (size_t wave = 0; wave < num_blocks; wave += wave_size) {
+    const auto wave_end = std::min(wave + wave_size, num_blocks);
+
+    const auto join_block = [this, nrows, wave, &buffers](const size_t _i) {
+      auto& buffer = buffers[_i];
+      const auto begin = (wave + _i) * block_size;
+      const auto end = std::min(begin + block_size, nrows);
+      buffer.offsets_.resize(num_peripheral());
+      buffer.matches_.resize(num_peripheral());
+      for (size_t i = 0; i < num_peripheral(); ++i) {
+        make_matches(i, begin, end, &buffer.offsets_[i],
+                     &buffer.matches_[i]);
+      }
+    };
+
+    multithreading::ThreadPool::get().parallel_for(wave_end - wave,
+                                                   join_block);
+
+    for (size_t k = 0; k < wave_end - wave; ++k) {
+      for (size_t i = 0; i < csr.size(); ++i) {
+        const auto& matches = buffers[k].matches_[i];
+
+        num_bytes += matches.size() * sizeof(containers::Match);
+
+        if (num_bytes > _memory_budget && !pool_) {
+          if (!_temp_dir) {
+            return std::vector<CSR>();
+          }
+          spill(*_temp_dir, &csr);
+        }
+
+        append(buffers[k].offsets_[i], matches, &csr[i]);
+      }
+    }
+  }
+
+  return csr;
+}
+
+// ----------------------------------------------------------------------------
+
+void MatchCache::make_matches(const size_t _peripheral_ix, const size_t _pos,
+                              std::vector<containers::Match>* _matches) const {
+  const auto make_match = [](const size_t ix_input, const size_t ix_output) {
+    return containers::Match{ix_input, ix_output};
+  };
+
+  assert_true(_peripheral_ix < table_holder().main_tables().size());
+  assert_true(_pos < rownums().size());
+
+  const auto& population =
+      table_holder().main_tables().at(_peripheral_ix).df();
+
+  const auto& peripheral =
+      table_holder().peripheral_tables().at(_peripheral_ix);
+
+  _matches->clear();
+
+  helpers::Matchmaker<containers::DataFrame, containers::Match,
+                      decltype(make_match)>::make_matches(population,
+                                                          peripheral,
+                                                          rownums()[_pos],
+                                                          make_match,
+                                                          _matches);
+}
+
+// ----------------------------------------------------------------------------
+
+void MatchCache::make_matches(const size_t _peripheral_ix, const size_t _begin,
+                              const size_t _end, std::vector<size_t>* _offsets,
+                              std::vector<containers::Match>* _matches) const {
+  const auto make_match = [](const size_t ix_input, const size_t ix_output) {
+    return containers::Match{ix_input, ix_output};
+  };
+
+  assert_true(_peripheral_ix < table_holder().main_tables().size());
+  assert_true(_begin <= _end);
+  assert_true(_end <= rownums().size());
+
+  const auto& population =
+      table_holder().main_tables().at(_peripheral_ix).df();
+
+  const auto& peripheral =
+      table_holder().peripheral_tables().at(_peripheral_ix);
+
+  const auto ix_outputs =
+      std::span<const size_t>(rownums()).subspan(_begin, _end - _begin);
+
+  helpers::Matchmaker<containers::DataFrame, containers::Match,
+                      decltype(make_match)>::make_matches(population,
+                                                          peripheral,
+                                                          ix_outputs,
+                                                          make_match, _offsets,
+                                                          _matches);
+}
+
+// ----------------------------------------------------------------------------
+
+void MatchCache::spill(const std::string& _temp_dir, std::vector<CSR>* _csr) {
+  pool_ = std::make_shared<memmap::Pool>(_temp_dir);
+
+  for (auto& csr : *_csr) {
+    const auto& matches =
+        std::get<std::vector<containers::Match>>(csr.matches_);
+    csr.matches_ = memmap::Vector<containers::Match>(pool_, matches.begin(),
+                                                     matches.end());
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void MatchCache::gather_matches(
+    const size_t _peripheral_ix, const size_t _begin, const size_t _end,
+    std::vector<size_t>* _offsets,
+    std::vector<containers::Match>* _matches) const {
+  if (!is_cached()) {
+    make_matches(_peripheral_ix, _begin, _end, _offsets, _matches);
+    return;
+  }
+
+  assert_true(_peripheral_ix < csr_.size());
+  assert_true(_begin <= _end);
+
+  const auto& csr = csr_[_peripheral_ix];
+
+  assert_true(_end < csr.offsets_.size());
+
+  const auto first = csr.offsets_[_begin];
+
+  _offsets->resize(_end - _begin + 1);
+
+  for (size_t pos = _begin; pos <= _end; ++pos) {
+    (*_offsets)[pos - _begin] = csr.offsets_[pos] - first;
+  }
+
+  _matches->assign(data(csr.matches_) + first,
+                   data(csr.matches_) + csr.offsets_[_end]);
+}
+
+// ----------------------------------------------------------------------------
+
+std::span<const containers::Match> MatchCache::matches(
+    const size_t _peripheral_ix, const size_t _pos,
+    std::vector<containers::Match>* _buffer) const {
+  if (!is_cached()) {
+    make_matches(_peripheral_ix, _pos, _buffer);
+    return std::span<const containers::Match>(*_buffer);
+  }
+
+  assert_true(_peripheral_ix < csr_.size());
+
+  const auto& csr = csr_[_peripheral_ix];
+
+  assert_true(_pos + 1 < csr.offsets_.size());
+
+  const auto begin = data(csr.matches_) + csr.offsets_[_pos];
+
+  const auto end = data(csr.matches_) + csr.offsets_[_pos + 1];
+
+  return std::span<const containers::Match>(begin, end);
+}
+
+// ----------------------------------------------------------------------------
+
+size_t MatchCache::num_matches(const size_t _pos) const {
+  assert_true(_pos < rownums().size());
+
+  if (is_cached()) {
+    size_t n = 0;
+    for (const auto& csr : csr_) {
+      n += csr.offsets_[_pos + 1] - csr.offsets_[_pos];
+    }
+    return n;
+  }
+
+  size_t n = 0;
+
+  for (size_t i = 0; i < num_peripheral(); ++i) {
+    const auto& population = table_holder().main_tables().at(i).df();
+
+    const auto& peripheral = table_holder().peripheral_tables().at(i);
+
+    const auto [begin, end] =
+        peripheral.find(population.join_key(rownums()[_pos]));
+
+    n += static_cast<size_t>(end - begin);
+  }
+
+  return n;
+}
+
+// ----------------------------------------------------------------------------
+
+std::shared_ptr<std::vector<size_t>> MatchCache::unique_inputs(
+    const size_t _peripheral_ix) const {
+  const auto& peripheral =
+      table_holder().peripheral_tables().at(_peripheral_ix);
+
+  auto is_included = std::vector<bool>(peripheral.nrows());
+
+  auto buffer = std::vector<containers::Match>();
+
+  for (size_t pos = 0; pos < rownums().size(); ++pos) {
+    for (const auto& m : matches(_peripheral_ix, pos, &buffer)) {
+      assert_true(m.ix_input < is_included.size());
+      is_included[m.ix_input] = true;
+    }
+  }
+
+  auto result = std::make_shared<std::vector<size_t>>();
+
+  for (size_t ix = 0; ix < is_included.size(); ++ix) {
+    if (is_included[ix]) {
+      result->push_back(ix);
+    }
+  }
+
+  return result;
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
@@ -0,0 +1,87 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "fastprop/algorithm/Memoization.hpp"
+
+#include <cmath>
+
+namespace fastprop {
+namespace algorithm {
+// ----------------------------------------------------------------------------
+
+void Memoization::reset() {
+  for (auto& slot : numerical_) {
+    slot.abstract_feature_.reset();
+  }
+
+  for (auto& slot : pairs_) {
+    slot.abstract_feature_.reset();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+const std::vector<Float>& Memoization::sorted_numerical() {
+  auto& slot = numerical_.at(numerical_ix_);
+
+  if (!slot.is_sorted_) {
+    slot.sorted_.assign(slot.values_.begin(), slot.values_.end());
+    std::ranges::sort(slot.sorted_);
+    slot.is_sorted_ = true;
+  }
+
+  return slot.sorted_;
+}
+
+// ----------------------------------------------------------------------------
+
+typename Memoization::Stats Memoization::stats_numerical() {
+  auto& slot = numerical_.at(numerical_ix_);
+
+  if (!slot.stats_) {
+    auto stats = Stats();
+    for (const auto val : slot.values_) {
+      stats.sum_ += val;
+    }
+    stats.count_ = static_cast<Float>(slot.values_.size());
+    slot.stats_ = stats;
+  }
+
+  return *slot.stats_;
+}
+
+// ----------------------------------------------------------------------------
+
+Float Memoization::var_numerical() {
+  auto& slot = numerical_.at(numerical_ix_);
+
+  if (!slot.var_) {
+    const auto stats = stats_numerical();
+
+    if (stats.count_ == 0.0) {
+      slot.var_ = NAN;
+      return *slot.var_;
+    }
+
+    const auto mean = stats.sum_ / stats.count_;
+
+    Float var = 0.0;
+
+    for (const auto val : slot.values_) {
+      const auto diff = val - mean;
+      var += diff * diff / stats.count_;
+    }
+
+    slot.var_ = var;
+  }
+
+  return *slot.var_;
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
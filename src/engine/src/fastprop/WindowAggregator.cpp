@@ -0,0 +1,414 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "fastprop/algorithm/WindowAggregator.hpp"
+
+#include "debug/assert_true.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+namespace fastprop {
+namespace algorithm {
+namespace {
+
+// Just like the Aggregator, the sliding windows ignore NaN and infinite
+// values. Values that do not fulfill the conditions are treated as NaN.
+
+/// Whether _val is neither NaN nor infinite.
+inline bool is_finite(const Float _val) { return _val - _val == 0.0; }
+
+/// When a value is removed from the window, its contribution to m2_ is
+/// subtracted. If that contribution exceeds the remaining m2_ by more than
+/// this factor, too many digits have cancelled, so the moments must be
+/// recalculated from the values that are still in the window.
+constexpr Float max_cancellation = 1048576.0;
+
+/// The running moments of a window, updated using Welford's algorithm. The
+/// sum is compensated (Neumaier), so that large values leaving the window do
+/// not wipe out the small values remaining in it.
+struct Moments {
+  /// Adds a value to the window.
+  void add(const Float _val) {
+    count_ += 1.0;
+    add_to_sum(_val);
+    const auto delta = _val - mean_;
+    mean_ += delta / count_;
+    m2_ += delta * (_val - mean_);
+  }
+
+  /// Removes a value that has been added before from the window. Returns
+  /// false, if the remaining moments are no longer accurate, because the
+  /// removed value dominated them.
+  bool remove(const Float _val) {
+    if (count_ <= 1.0) {
+      *this = Moments();
+      return true;
+    }
+    count_ -= 1.0;
+    add_to_sum(-_val);
+    const auto delta = _val - mean_;
+    mean_ -= delta / count_;
+    const auto contribution = delta * (_val - mean_);
+    m2_ -= contribution;
+    return contribution <= max_cancellation * m2_;
+  }
+
+  /// The result of the aggregation for the current window.
+  Float get(const enums::Aggregation _aggregation) const {
+    switch (_aggregation.value()) {
+      case enums::Aggregation::value_of<"AVG">():
+        return count_ > 0.0 ? sum() / count_ : NAN;
+
+      case enums::Aggregation::value_of<"COUNT">():
+        return count_;
+
+      case enums::Aggregation::value_of<"STDDEV">():
+        return count_ > 0.0 ? std::sqrt(std::max(m2_, 0.0) / count_) : NAN;
+
+      case enums::Aggregation::value_of<"SUM">():
+        return count_ > 0.0 ? sum() : 0.0;
+
+      case enums::Aggregation::value_of<"VAR">():
+        return count_ > 0.0 ? std::max(m2_, 0.0) / count_ : NAN;
+
+      default:
+        assert_msg(false,
+                   "Unsupported aggregation: '" + _aggregation.name() + "'.");
+        return NAN;
+    }
+  }
+
+  /// Adds _val to the sum and keeps track of the rounding error.
+  void add_to_sum(const Float _val) {
+    const auto t = sum_ + _val;
+    compensation_ += (std::abs(sum_) >= std::abs(_val)) ? (sum_ - t) + _val
+                                                        : (_val - t) + sum_;
+    sum_ = t;
+  }
+
+  /// The compensated sum of all values in the window.
+  Float sum() const { return sum_ + compensation_; }
+
+  Float compensation_ = 0.0;
+  Float count_ = 0.0;
+  Float mean_ = 0.0;
+  Float m2_ = 0.0;
+  Float sum_ = 0.0;
+};
+
+/// Slides the window over the values and writes the moments of every window
+/// into _out - COUNT, SUM, AVG, VAR or STDDEV.
+template <class GetValueType>
+void slide_moments(const enums::Aggregation _aggregation,
+                   const GetValueType& _get_value,
+                   const std::vector<std::pair<size_t, size_t>>& _windows,
+                   const std::vector<size_t>& _order, Float* _out,
+                   const size_t _stride) {
+  const auto add_finite = [&_get_value](const size_t _i, Moments* _moments) {
+    const auto val = _get_value(_i);
+    if (is_finite(val)) {
+      _moments->add(val);
+    }
+  };
+
+  auto moments = Moments();
+
+  size_t lo = 0;
+
+  size_t hi = 0;
+
+  bool is_accurate = true;
+
+  for (const auto k : _order) {
+    const auto [begin, end] = _windows[k];
+
+    if (begin >= hi || begin < lo || end < hi) {
+      moments = Moments();
+      lo = hi = begin;
+    }
+
+    for (; hi < end; ++hi) {
+      add_finite(hi, &moments);
+    }
+
+    for (; lo < begin; ++lo) {
+      const auto val = _get_value(lo);
+      if (is_finite(val)) {
+        is_accurate = moments.remove(val) && is_accurate;
+      }
+    }
+
+    if (!is_accurate) {
+      moments = Moments();
+      for (size_t i = lo; i < hi; ++i) {
+        add_finite(i, &moments);
+      }
+      is_accurate = true;
+    }
+
+    _out[k * _stride] = moments.get(_aggregation);
+  }
+}
+
+/// Slides the window over the values and writes the extremum of every window
+/// into _out. _queue contains the positions of all values that can still
+/// become the extremum, in such a way that their values are monotonic and
+/// the front is the extremum of the current window.
+template <class CompareType, class GetValueType>
+void slide_extremum(const GetValueType& _get_value,
+                    const std::vector<std::pair<size_t, size_t>>& _windows,
+                    const std::vector<size_t>& _order,
+                    std::vector<size_t>* _queue, Float* _out,
+                    const size_t _stride) {
+  const auto compare = CompareType();
+
+  auto& queue = *_queue;
+
+  queue.clear();
+
+  size_t front = 0;
+
+  size_t lo = 0;
+
+  size_t hi = 0;
+
+  for (const auto k : _order) {
+    const auto [begin, end] = _windows[k];
+
+    if (begin >= hi || begin < lo || end < hi) {
+      queue.clear();
+      front = 0;
+      lo = hi = begin;
+    }
+
+    for (; hi < end; ++hi) {
+      const auto val = _get_value(hi);
+      if (!is_finite(val)) {
+        continue;
+      }
+      while (queue.size() > front && !compare(_get_value(queue.back()), val)) {
+        queue.pop_back();
+      }
+      queue.push_back(hi);
+    }
+
+    lo = begin;
+
+    while (front < queue.size() && queue[front] < lo) {
+      ++front;
+    }
+
+    if (front == queue.size()) {
+      queue.clear();
+      front = 0;
+    }
+
+    _out[k * _stride] =
+        (front < queue.size()) ? _get_value(queue[front]) : NAN;
+  }
+}
+
+/// Dispatches over the aggregation.
+template <class GetValueType>
+void slide(const enums::Aggregation _aggregation,
+           const GetValueType& _get_value,
+           const std::vector<std::pair<size_t, size_t>>& _windows,
+           const std::vector<size_t>& _order, std::vector<size_t>* _queue,
+           Float* _out, const size_t _stride) {
+  switch (_aggregation.value()) {
+    case enums::Aggregation::value_of<"MAX">():
+      return slide_extremum<std::greater<Float>>(_get_value, _windows, _order,
+                                                 _queue, _out, _stride);
+
+    case enums::Aggregation::value_of<"MIN">():
+      return slide_extremum<std::less<Float>>(_get_value, _windows, _order,
+                                              _queue, _out, _stride);
+
+    default:
+      return slide_moments(_aggregation, _get_value, _windows, _order, _out,
+                           _stride);
+  }
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+void WindowAggregator::apply_aggregation(
+    const MatchCache& _match_cache,
+    const containers::AbstractFeature& _abstract_feature,
+    const CompiledConditions& _conditions, const size_t _begin,
+    const size_t _end, Workspace* _workspace, Float* _out,
+    const size_t _stride) {
+  assert_true(is_supported(_match_cache, _abstract_feature, _conditions));
+
+  const auto peripheral_ix = _abstract_feature.peripheral_;
+
+  make_windows(_match_cache, peripheral_ix, _begin, _end, _workspace);
+
+  const auto& windows = _workspace->windows_.at(peripheral_ix);
+
+  const auto& order = _workspace->order_.at(peripheral_ix);
+
+  const auto& peripheral =
+      _match_cache.table_holder().peripheral_tables().at(peripheral_ix);
+
+  const auto row_indices = peripheral.ts_index_->row_indices().begin();
+
+  const auto make_get_value = [row_indices, &_conditions](const Float* _col) {
+    return [row_indices, &_conditions, _col](const size_t _k) -> Float {
+      const auto ix_input = row_indices[_k];
+      if (!_conditions.empty() &&
+          !_conditions(containers::Match{ix_input, 0})) {
+        return NAN;
+      }
+      return _col ? _col[ix_input] : 0.0;
+    };
+  };
+
+  const auto aggregation = _abstract_feature.aggregation_;
+
+  auto* queue = &_workspace->queue_;
+
+  switch (_abstract_feature.data_used_.value()) {
+    case enums::DataUsed::value_of<"discrete">(): {
+      const auto col = peripheral.discrete_col(_abstract_feature.input_col_);
+      return slide(aggregation, make_get_value(col.begin()), windows, order,
+                   queue, _out, _stride);
+    }
+
+    case enums::DataUsed::value_of<"na">():
+      return slide(aggregation, make_get_value(nullptr), windows, order,
+                   queue, _out, _stride);
+
+    case enums::DataUsed::value_of<"numerical">(): {
+      const auto col = peripheral.numerical_col(_abstract_feature.input_col_);
+      return slide(aggregation, make_get_value(col.begin()), windows, order,
+                   queue, _out, _stride);
+    }
+
+    default:
+      assert_msg(false, "Unsupported data_used: '" +
+                            _abstract_feature.data_used_.name() + "'.");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+bool WindowAggregator::is_supported(
+    const MatchCache& _match_cache,
+    const containers::AbstractFeature& _abstract_feature,
+    const CompiledConditions& _conditions) {
+  if (_abstract_feature.peripheral_ >= _match_cache.num_peripheral()) {
+    return false;
+  }
+
+  const auto& peripheral = _match_cache.table_holder().peripheral_tables().at(
+      _abstract_feature.peripheral_);
+
+  if (!peripheral.ts_index_ || _conditions.depends_on_output()) {
+    return false;
+  }
+
+  switch (_abstract_feature.aggregation_.value()) {
+    case enums::Aggregation::value_of<"AVG">():
+    case enums::Aggregation::value_of<"COUNT">():
+    case enums::Aggregation::value_of<"MAX">():
+    case enums::Aggregation::value_of<"MIN">():
+    case enums::Aggregation::value_of<"STDDEV">():
+    case enums::Aggregation::value_of<"SUM">():
+    case enums::Aggregation::value_of<"VAR">():
+      break;
+
+    default:
+      return false;
+  }
+
+  switch (_abstract_feature.data_used_.value()) {
+    case enums::DataUsed::value_of<"na">():
+      return _abstract_feature.aggregation_.value() ==
+             enums::Aggregation::value_of<"COUNT">();
+
+    case enums::DataUsed::value_of<"discrete">():
+    case enums::DataUsed::value_of<"numerical">():
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void WindowAggregator::make_windows(const MatchCache& _match_cache,
+                                    const size_t _peripheral_ix,
+                                    const size_t _begin, const size_t _end,
+                                    Workspace* _workspace) {
+  assert_true(_begin <= _end);
+
+  const auto num_peripheral = _match_cache.num_peripheral();
+
+  if (_workspace->match_cache_ != &_match_cache ||
+      _workspace->begin_ != _begin || _workspace->end_ != _end) {
+    _workspace->match_cache_ = &_match_cache;
+    _workspace->begin_ = _begin;
+    _workspace->end_ = _end;
+    _workspace->is_valid_.assign(num_peripheral, false);
+    _workspace->windows_.resize(num_peripheral);
+    _workspace->order_.resize(num_peripheral);
+  }
+
+  if (_workspace->is_valid_.at(_peripheral_ix)) {
+    return;
+  }
+
+  const auto& population =
+      _match_cache.table_holder().main_tables().at(_peripheral_ix).df();
+
+  const auto& peripheral =
+      _match_cache.table_holder().peripheral_tables().at(_peripheral_ix);
+
+  assert_true(peripheral.ts_index_);
+
+  const auto& rownums = _match_cache.rownums();
+
+  auto& windows = _workspace->windows_[_peripheral_ix];
+
+  windows.resize(_end - _begin);
+
+  for (size_t pos = _begin; pos < _end; ++pos) {
+    const auto join_key = population.join_key(rownums[pos]);
+
+    const auto time_stamp = population.time_stamp(rownums[pos]);
+
+    windows[pos - _begin] =
+        peripheral.has(join_key)
+            ? peripheral.ts_index_->find_ix_range(join_key, time_stamp)
+            : std::pair<size_t, size_t>(0, 0);
+  }
+
+  auto& order = _workspace->order_[_peripheral_ix];
+
+  order.resize(_end - _begin);
+
+  std::iota(order.begin(), order.end(), 0);
+
+  const auto by_window = [&windows](const size_t _i, const size_t _j) {
+    return windows[_i] < windows[_j];
+  };
+
+  std::ranges::sort(order, by_window);
+
+  _workspace->is_valid_[_peripheral_ix] = true;
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace algorithm
+}  // namespace fastprop
@@ -134,31 +134,14 @@ std::pair<const size_t*, const size_t*> DataFrame::find(
 
   assert_true(indices_[_ix_join_key]);
 
-  if (std::holds_alternative<InMemoryIndex>(*indices_[_ix_join_key])) {
-    const auto& idx = std::get<InMemoryIndex>(*indices_[_ix_join_key]);
+  const auto& index = *indices_[_ix_join_key];
 
-    const auto it = idx.find(_join_key);
-
-    if (it == idx.end()) {
-      return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
-    }
-
-    return std::make_pair(it->second.data(),
-                          it->second.data() + it->second.size());
+  if (std::holds_alternative<InMemoryIndex>(index)) {
+    return std::get<InMemoryIndex>(index).find(_join_key);
   }
 
-  if (std::holds_alternative<MemoryMappedIndex>(*indices_[_ix_join_key])) {
-    const auto& idx = std::get<MemoryMappedIndex>(*indices_[_ix_join_key]);
-
-    const auto opt = idx[_join_key];
-
-    if (!opt) {
-      return std::make_pair<const size_t*, const size_t*>(nullptr, nullptr);
-    }
-
-    const auto begin = opt->data();
-
-    return std::make_pair(begin, begin + opt->size());
+  if (std::holds_alternative<MemoryMappedIndex>(index)) {
+    return std::get<MemoryMappedIndex>(index).find(_join_key);
   }
 
   assert_true(false);
@@ -319,9 +302,14 @@ std::shared_ptr<tsindex::Index> DataFrame::make_ts_index(
       unique_join_keys | std::views::transform(find_rownums) |
       std::views::join | std::ranges::to<std::vector>());
 
+  const auto pool = _params.temp_dir_
+                        ? std::make_shared<memmap::Pool>(*_params.temp_dir_)
+                        : std::shared_ptr<memmap::Pool>();
+
   const auto params = tsindex::IndexParams{.join_keys_ = join_keys,
                                            .lower_ts_ = lower_ts,
                                            .memory_ = memory,
+                                           .pool_ = pool,
                                            .rownums_ = rownums};
 
   return std::make_shared<tsindex::Index>(params);
@@ -244,6 +244,7 @@ std::vector<DataFrame> TableHolder::parse_peripheral_tables(
         .make_staging_table_colname_ = _params.make_staging_table_colname_,
         .population_join_keys_ = population_join_keys,
         .row_indices_ = row_indices,
+        .temp_dir_ = _params.temp_dir_,
         .time_stamp_ = _params.placeholder_.other_time_stamps_used().at(i),
         .upper_time_stamp_ =
             _params.placeholder_.upper_time_stamps_used().at(i),
@@ -390,6 +391,7 @@ std::vector<std::optional<TableHolder>> TableHolder::parse_subtables(
         .placeholder_ = joined,
         .population_ = output,
         .row_index_container_ = row_index_container,
+        .temp_dir_ = _params.temp_dir_,
         .word_index_container_ = word_index_container};
 
     result.push_back(std::make_optional<TableHolder>(params));
@@ -0,0 +1,82 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "io/MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace io {
+
+MappedFile::MappedFile(const std::string& _fname)
+    : data_(nullptr), size_(0) {
+  const auto fd = open(_fname.c_str(), O_RDONLY);
+
+  if (fd == -1) {
+    throw std::runtime_error("'" + _fname + "' could not be opened!");
+  }
+
+  struct stat st = {};
+
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    throw std::runtime_error("'" + _fname + "' could not be opened!");
+  }
+
+  size_ = static_cast<size_t>(st.st_size);
+
+  if (size_ == 0) {
+    close(fd);
+    return;
+  }
+
+  auto* addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+
+  close(fd);
+
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("'" + _fname + "' could not be mapped!");
+  }
+
+  madvise(addr, size_, MADV_SEQUENTIAL);
+
+  data_ = static_cast<const char*>(addr);
+}
+
+// ----------------------------------------------------------------------------
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void MappedFile::release(const size_t _begin, const size_t _size) const {
+  const auto page_size = static_cast<size_t>(getpagesize());
+
+  // Only pages that are entirely contained in the range can be released.
+  const auto begin = (_begin + page_size - 1) / page_size * page_size;
+
+  const auto end = std::min(_begin + _size, size_) / page_size * page_size;
+
+  if (!data_ || begin >= end) {
+    return;
+  }
+
+  madvise(const_cast<char*>(data_) + begin, end - begin, MADV_DONTNEED);
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace io
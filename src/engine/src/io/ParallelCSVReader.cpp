@@ -0,0 +1,184 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "io/ParallelCSVReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace io {
+
+ParallelCSVReader::ParallelCSVReader(
+    const std::optional<std::vector<std::string>>& _colnames,
+    const std::string& _fname, const size_t _limit, const char _quotechar,
+    const char _sep)
+    : file_(_fname), quotechar_(_quotechar), sep_(_sep) {
+  data_ = file_.content();
+
+  size_t num_header_lines = 0;
+
+  if (_colnames) {
+    colnames_ = *_colnames;
+  } else {
+    auto fields = std::vector<std::string_view>();
+    auto buffer = std::string();
+    split_line(pop_line(&data_), &fields, &buffer);
+    colnames_ = std::vector<std::string>(fields.begin(), fields.end());
+    num_header_lines = 1;
+  }
+
+  // Just like in the CSVReader, the limit includes the header and 0
+  // signifies that there is no limit.
+  if (_limit > 0) {
+    max_lines_ = _limit - std::min(_limit, num_header_lines);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+std::vector<std::string_view> ParallelCSVReader::make_chunks(
+    const size_t _skip, const size_t _chunk_size) const {
+  auto remaining = data_;
+
+  for (size_t i = 0; i < _skip && remaining.size() > 0; ++i) {
+    pop_line(&remaining);
+  }
+
+  if (max_lines_) {
+    auto end = remaining;
+    for (size_t i = _skip; i < *max_lines_ && end.size() > 0; ++i) {
+      pop_line(&end);
+    }
+    remaining = remaining.substr(0, remaining.size() - end.size());
+  }
+
+  auto chunks = std::vector<std::string_view>();
+
+  while (remaining.size() > 0) {
+    if (remaining.size() <= _chunk_size) {
+      chunks.push_back(remaining);
+      break;
+    }
+
+    const auto* newline = static_cast<const char*>(
+        std::memchr(remaining.data() + _chunk_size, '\n',
+                    remaining.size() - _chunk_size));
+
+    const auto len = newline
+                         ? static_cast<size_t>(newline - remaining.data()) + 1
+                         : remaining.size();
+
+    chunks.push_back(remaining.substr(0, len));
+
+    remaining.remove_prefix(len);
+  }
+
+  return chunks;
+}
+
+// ----------------------------------------------------------------------------
+
+std::string_view ParallelCSVReader::pop_line(std::string_view* _chunk) {
+  const auto* newline = static_cast<const char*>(
+      std::memchr(_chunk->data(), '\n', _chunk->size()));
+
+  if (!newline) {
+    const auto line = *_chunk;
+    _chunk->remove_prefix(_chunk->size());
+    return line;
+  }
+
+  const auto len = static_cast<size_t>(newline - _chunk->data());
+
+  const auto line = _chunk->substr(0, len);
+
+  _chunk->remove_prefix(len + 1);
+
+  return line;
+}
+
+// ----------------------------------------------------------------------------
+
+void ParallelCSVReader::split_line(const std::string_view _line,
+                                   std::vector<std::string_view>* _fields,
+                                   std::string* _buffer) const {
+  _fields->clear();
+
+  if (_line.size() == 0) {
+    return;
+  }
+
+  // Most lines contain no quotes at all, so the fields can be found by
+  // searching for the separator using memchr(...), which is vectorized.
+  if (!std::memchr(_line.data(), quotechar_, _line.size())) {
+    auto remaining = _line;
+    while (true) {
+      const auto* sep = static_cast<const char*>(
+          std::memchr(remaining.data(), sep_, remaining.size()));
+      if (!sep) {
+        _fields->push_back(trim(remaining));
+        return;
+      }
+      const auto len = static_cast<size_t>(sep - remaining.data());
+      _fields->push_back(remaining.substr(0, len));
+      remaining.remove_prefix(len + 1);
+    }
+  }
+
+  // Otherwise, the quotes are removed and separators within quotes are
+  // retained, just like in the CSVReader. The buffer is reserved up front,
+  // so that it is never reallocated.
+  _buffer->clear();
+
+  _buffer->reserve(_line.size());
+
+  auto bounds = std::vector<std::pair<size_t, size_t>>();
+
+  size_t begin = 0;
+
+  bool is_quoted = false;
+
+  for (const char c : _line) {
+    if (c == sep_ && !is_quoted) {
+      bounds.emplace_back(begin, _buffer->size());
+      begin = _buffer->size();
+    } else if (c == quotechar_) {
+      is_quoted = !is_quoted;
+    } else {
+      _buffer->push_back(c);
+    }
+  }
+
+  bounds.emplace_back(begin, _buffer->size());
+
+  for (const auto& [b, e] : bounds) {
+    _fields->push_back(std::string_view(_buffer->data() + b, e - b));
+  }
+
+  _fields->back() = trim(_fields->back());
+}
+
+// ----------------------------------------------------------------------------
+
+std::string_view ParallelCSVReader::trim(const std::string_view _field) {
+  constexpr const char* whitespace = "\t\v\f\r\n ";
+
+  const auto pos = _field.find_first_not_of(whitespace);
+
+  if (pos == std::string_view::npos) {
+    return std::string_view();
+  }
+
+  const auto len = _field.find_last_not_of(whitespace) - pos + 1;
+
+  return _field.substr(pos, len);
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace io
@@ -0,0 +1,344 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "io/TimeStampParser.hpp"
+
+#include <Poco/DateTime.h>
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/DateTimeParser.h>
+#include <Poco/Timestamp.h>
+
+namespace io {
+namespace {
+
+/// Removes all whitespaces at the beginning and end of the string, just like
+/// Parser::trim(...).
+std::string_view trim(const std::string_view _str) {
+  constexpr std::string_view whitespace = "\t\v\f\r\n ";
+
+  const auto pos = _str.find_first_not_of(whitespace);
+
+  if (pos == std::string_view::npos) {
+    return std::string_view();
+  }
+
+  const auto len = _str.find_last_not_of(whitespace) - pos + 1;
+
+  return _str.substr(pos, len);
+}
+
+/// The number of days since 1970-01-01 in the proleptic Gregorian calendar,
+/// which is what Poco::DateTime uses as well.
+std::int64_t days_from_civil(std::int64_t _year, const std::int64_t _month,
+                             const std::int64_t _day) {
+  _year -= _month <= 2 ? 1 : 0;
+  const auto era = (_year >= 0 ? _year : _year - 399) / 400;
+  const auto year_of_era = _year - era * 400;
+  const auto day_of_year =
+      (153 * (_month > 2 ? _month - 3 : _month + 9) + 2) / 5 + _day - 1;
+  const auto day_of_era =
+      year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return era * 146097 + day_of_era - 719468;
+}
+
+/// The number of days in a month.
+std::int64_t days_in_month(const std::int64_t _year,
+                           const std::int64_t _month) {
+  constexpr std::int64_t days[] = {31, 28, 31, 30, 31, 30,
+                                   31, 31, 30, 31, 30, 31};
+  const bool is_leap_year =
+      (_year % 4 == 0 && _year % 100 != 0) || _year % 400 == 0;
+  return _month == 2 && is_leap_year ? 29 : days[_month - 1];
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+TimeStampParser::TimeStampParser(const std::vector<std::string>& _time_formats)
+    : last_match_(0) {
+  for (const auto& fmt : _time_formats) {
+    formats_.push_back(compile(fmt));
+  }
+
+  for (size_t i = 0; i < formats_.size(); ++i) {
+    for (size_t j = 0; j < i && formats_[i].is_exclusive_; ++j) {
+      formats_[i].is_exclusive_ = !may_overlap(formats_[j], formats_[i]);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+TimeStampParser::TimeStampParser(const TimeStampParser& _other)
+    : formats_(_other.formats_),
+      last_match_(_other.last_match_.load(std::memory_order_relaxed)) {}
+
+// ----------------------------------------------------------------------------
+
+TimeStampParser::Format TimeStampParser::compile(const std::string& _fmt) {
+  auto format = Format{.fmt_ = _fmt,
+                       .is_compiled_ = false,
+                       .is_exclusive_ = true,
+                       .shape_ = "",
+                       .tokens_ = {}};
+
+  auto& shape = format.shape_;
+
+  std::uint32_t seen = 0;
+
+  const auto add_field = [&format, &shape, &seen](const Field _field,
+                                                  const size_t _width) {
+    const auto bit = std::uint32_t(1) << static_cast<std::uint32_t>(_field);
+    if (seen & bit) {
+      return false;
+    }
+    seen |= bit;
+    format.tokens_.push_back(
+        Token{.field_ = _field, .begin_ = shape.size(), .width_ = _width});
+    shape.append(_width, '\0');
+    return true;
+  };
+
+  for (size_t i = 0; i < _fmt.size(); ++i) {
+    if (_fmt[i] != '%') {
+      if (_fmt[i] == '\0' || (_fmt[i] >= '0' && _fmt[i] <= '9')) {
+        return format;
+      }
+      shape.push_back(_fmt[i]);
+      continue;
+    }
+
+    if (++i == _fmt.size()) {
+      return format;
+    }
+
+    bool success = true;
+
+    switch (_fmt[i]) {
+      case 'Y':
+        success = add_field(Field::year, 4);
+        break;
+
+      case 'm':
+        success = add_field(Field::month, 2);
+        break;
+
+      case 'd':
+        success = add_field(Field::day, 2);
+        break;
+
+      case 'H':
+        success = add_field(Field::hour, 2);
+        break;
+
+      case 'M':
+        success = add_field(Field::minute, 2);
+        break;
+
+      case 'S':
+        success = add_field(Field::second, 2);
+        break;
+
+      case 's':
+        success = add_field(Field::second, 2);
+        shape.push_back('.');
+        success = success && add_field(Field::fraction, 6);
+        break;
+
+      case 'F':
+        success = add_field(Field::fraction, 6);
+        break;
+
+      case 'i':
+        success = add_field(Field::fraction, 3);
+        break;
+
+      // Time stamps are always formatted as UTC.
+      case 'z':
+        shape.push_back('Z');
+        break;
+
+      case 'Z':
+        shape.append("GMT");
+        break;
+
+      case '%':
+        shape.push_back('%');
+        break;
+
+      default:
+        success = false;
+    }
+
+    if (!success) {
+      return format;
+    }
+  }
+
+  format.is_compiled_ = true;
+
+  return format;
+}
+
+// ----------------------------------------------------------------------------
+
+bool TimeStampParser::may_overlap(const Format& _f1, const Format& _f2) {
+  // Literals are never digits, so two compiled formats can only match the
+  // same string, if their shapes are identical.
+  return !_f1.is_compiled_ || !_f2.is_compiled_ || _f1.shape_ == _f2.shape_;
+}
+
+// ----------------------------------------------------------------------------
+
+std::pair<Float, bool> TimeStampParser::parse(
+    const std::string_view _str) const {
+  const auto trimmed = trim(_str);
+
+  const auto last = last_match_.load(std::memory_order_relaxed);
+
+  const bool try_last_first =
+      last < formats_.size() && formats_[last].is_exclusive_;
+
+  if (try_last_first) {
+    const auto result = parse(formats_[last], trimmed);
+    if (result.second) {
+      return result;
+    }
+  }
+
+  for (size_t i = 0; i < formats_.size(); ++i) {
+    if (try_last_first && i == last) {
+      continue;
+    }
+
+    const auto result = parse(formats_[i], trimmed);
+
+    if (result.second) {
+      if (i != last) {
+        last_match_.store(i, std::memory_order_relaxed);
+      }
+      return result;
+    }
+  }
+
+  return std::make_pair(0.0, false);
+}
+
+// ----------------------------------------------------------------------------
+
+std::pair<Float, bool> TimeStampParser::parse(const Format& _format,
+                                              const std::string_view _trimmed) {
+  if (_format.is_compiled_) {
+    return parse_compiled(_format, _trimmed);
+  }
+  return parse_with_poco(_format.fmt_, _trimmed);
+}
+
+// ----------------------------------------------------------------------------
+
+std::pair<Float, bool> TimeStampParser::parse_compiled(
+    const Format& _format, const std::string_view _trimmed) {
+  const auto& shape = _format.shape_;
+
+  if (_trimmed.size() != shape.size()) {
+    return std::make_pair(0.0, false);
+  }
+
+  for (size_t i = 0; i < shape.size(); ++i) {
+    const bool matches = shape[i] == '\0'
+                             ? (_trimmed[i] >= '0' && _trimmed[i] <= '9')
+                             : _trimmed[i] == shape[i];
+    if (!matches) {
+      return std::make_pair(0.0, false);
+    }
+  }
+
+  // Just like Poco, we fall back to 0000-01-01T00:00:00.
+  std::int64_t year = 0, month = 1, day = 1, hour = 0, minute = 0,
+               second = 0, microseconds = 0;
+
+  for (const auto& token : _format.tokens_) {
+    std::int64_t val = 0;
+
+    for (size_t i = token.begin_; i < token.begin_ + token.width_; ++i) {
+      val = val * 10 + (_trimmed[i] - '0');
+    }
+
+    switch (token.field_) {
+      case Field::year:
+        year = val;
+        break;
+
+      case Field::month:
+        month = val;
+        break;
+
+      case Field::day:
+        day = val;
+        break;
+
+      case Field::hour:
+        hour = val;
+        break;
+
+      case Field::minute:
+        minute = val;
+        break;
+
+      case Field::second:
+        second = val;
+        break;
+
+      case Field::fraction:
+        microseconds = token.width_ == 3 ? val * 1000 : val;
+        break;
+    }
+  }
+
+  // Values that Poco would reject or normalize never survive the round trip.
+  if (month < 1 || month > 12 || day < 1 || day > days_in_month(year, month) ||
+      hour > 23 || minute > 59 || second > 59) {
+    return std::make_pair(0.0, false);
+  }
+
+  const auto seconds =
+      ((days_from_civil(year, month, day) * 24 + hour) * 60 + minute) * 60 +
+      second;
+
+  const auto epoch_microseconds = seconds * 1000000 + microseconds;
+
+  return std::make_pair(static_cast<Float>(epoch_microseconds) / 1.0e6, true);
+}
+
+// ----------------------------------------------------------------------------
+
+std::pair<Float, bool> TimeStampParser::parse_with_poco(
+    const std::string& _fmt, const std::string_view _trimmed) {
+  const auto trimmed = std::string(_trimmed);
+
+  int utc = Poco::DateTimeFormatter::UTC;
+
+  Poco::DateTime date_time;
+
+  const auto success =
+      Poco::DateTimeParser::tryParse(_fmt, trimmed, date_time, utc);
+
+  const auto time_stamp = date_time.timestamp();
+
+  if (!success ||
+      Poco::DateTimeFormatter::format(time_stamp, _fmt) != trimmed) {
+    return std::make_pair(0.0, false);
+  }
+
+  return std::make_pair(
+      static_cast<Float>(time_stamp.epochMicroseconds()) / 1.0e6, true);
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace io
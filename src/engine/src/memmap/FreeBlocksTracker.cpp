@@ -111,7 +111,7 @@ void FreeBlocksTracker::free_block(const size_t _begin, const size_t _end) {
   for (auto it = free_blocks_.begin(); it != free_blocks_.end(); ++it) {
     auto& block = *it;
 
-    if (block.end_ == _begin && it != free_blocks_.end() &&
+    if (block.end_ == _begin && it + 1 != free_blocks_.end() &&
         (it + 1)->begin_ == _end) {
       (it + 1)->begin_ = block.begin_;
       free_blocks_.erase(it);
@@ -23,13 +23,24 @@
 
 namespace memmap {
 
-Pool::Pool(const std::string& _temp_dir)
-    : fd_data_(-1),
+Pool::Pool(const std::string& _temp_dir, const PoolOptions& _options)
+    : data_(nullptr),
+      fd_data_(-1),
       fd_pages_(-1),
+      num_allocated_pages_(0),
       num_pages_(0),
+      options_(_options),
       page_size_(static_cast<size_t>(getpagesize())),
       pages_(nullptr),
       temp_dir_(_temp_dir) {
+  if (options_.advice_ != "normal" && options_.advice_ != "random" &&
+      options_.advice_ != "sequential") {
+    throw std::runtime_error("Unknown memory mapping advice '" +
+                             options_.advice_ +
+                             "'. Supported are 'normal', 'random' and "
+                             "'sequential'.");
+  }
+
   std::tie(path_pages_, fd_pages_) = create_file(_temp_dir);
   std::tie(path_data_, fd_data_) = create_file(_temp_dir);
 
@@ -46,6 +57,21 @@ Pool::~Pool() {
 
 // ----------------------------------------------------------------------------
 
+void Pool::advise(const size_t _num_pages) const {
+  const auto advice = options_.advice_ == "random"       ? MADV_RANDOM
+                      : options_.advice_ == "sequential" ? MADV_SEQUENTIAL
+                                                         : MADV_NORMAL;
+
+  // These are mere hints, so we do not care whether the kernel follows them.
+  madvise(data_, _num_pages * page_size_, advice);
+
+  if (options_.huge_pages_) {
+    madvise(data_, _num_pages * page_size_, MADV_HUGEPAGE);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
 void Pool::allocate_page(const size_t _block_size, const size_t _page_num) {
   auto& new_page = pages_[_page_num];
   new_page.block_size_ = _block_size;
@@ -58,6 +84,14 @@ size_t Pool::allocate_block(const size_t _block_size,
                             const size_t _current_page) {
   assert_true(_block_size > 0);
 
+  // Blocks at the end of the pool are grown in place, so vectors that are
+  // filled one by one never need to be copied.
+  if (_current_page != NOT_ALLOCATED &&
+      _current_page + _block_size > num_pages_ &&
+      current_block_is_at_end(_current_page)) {
+    resize_pool(grow_to(_current_page + _block_size));
+  }
+
   const bool extend_current_block =
       current_block_can_be_extended(_block_size, _current_page);
 
@@ -67,6 +101,7 @@ size_t Pool::allocate_block(const size_t _block_size,
     const auto by = _block_size - pages_[_current_page].block_size_;
     free_blocks_tracker_.extend_block(page_num, by);
     allocate_page(_block_size, _current_page);
+    num_allocated_pages_ += by;
     return _current_page;
   }
 
@@ -75,12 +110,14 @@ size_t Pool::allocate_block(const size_t _block_size,
         free_blocks_tracker_.allocate_block(_block_size);
 
     if (!found) {
-      resize_pool(num_pages_ * 2);
+      resize_pool(grow_to(num_pages_ + _block_size));
       continue;
     }
 
     allocate_page(_block_size, page_num);
 
+    num_allocated_pages_ += _block_size;
+
     if (_current_page == NOT_ALLOCATED) {
       return page_num;
     }
@@ -138,7 +175,7 @@ bool Pool::current_block_can_be_extended(const size_t _block_size,
     return false;
   }
 
-  if (_current_page + _block_size >= num_pages_) {
+  if (_current_page + _block_size > num_pages_) {
     return false;
   }
 
@@ -156,6 +193,20 @@ bool Pool::current_block_can_be_extended(const size_t _block_size,
 
 // ----------------------------------------------------------------------------
 
+bool Pool::current_block_is_at_end(const size_t _current_page) const {
+  assert_true(_current_page < num_pages_);
+  assert_true(pages_[_current_page].is_allocated_);
+
+  const auto is_free = [](const Page& _page) -> bool {
+    return !_page.is_allocated_;
+  };
+
+  return std::all_of(pages_ + _current_page + pages_[_current_page].block_size_,
+                     pages_ + num_pages_, is_free);
+}
+
+// ----------------------------------------------------------------------------
+
 void Pool::deallocate(const size_t _page_num) {
   auto& old_page = pages_[_page_num];
 
@@ -164,6 +215,8 @@ void Pool::deallocate(const size_t _page_num) {
 
   free_blocks_tracker_.free_block(_page_num, _page_num + old_page.block_size_);
 
+  num_allocated_pages_ -= old_page.block_size_;
+
   old_page = Page();
 }
 
@@ -197,6 +250,20 @@ char* Pool::memmap(const int _fd, const size_t _length) const {
 
 // ----------------------------------------------------------------------------
 
+char* Pool::memremap(char* _addr, const size_t _old_length,
+                     const size_t _new_length) const {
+  auto addr = mremap(_addr, _old_length, _new_length, MREMAP_MAYMOVE);
+
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error("Could not remap file: " +
+                             std::string(strerror(errno)));
+  }
+
+  return reinterpret_cast<char*>(addr);
+}
+
+// ----------------------------------------------------------------------------
+
 void Pool::move_data_to_new_block(const size_t _old_page_num,
                                   const size_t _new_page_num) {
   assert_true(_old_page_num < num_pages_);
@@ -220,9 +287,18 @@ void Pool::move_data_to_new_block(const size_t _old_page_num,
 // ----------------------------------------------------------------------------
 
 void Pool::remap(const size_t _num_pages) {
-  data_ = memmap(fd_data_, _num_pages * page_size_);
-  pages_ =
-      reinterpret_cast<Page*>(memmap(fd_pages_, _num_pages * sizeof(Page)));
+  if (num_pages_ == 0) {
+    data_ = memmap(fd_data_, _num_pages * page_size_);
+    pages_ =
+        reinterpret_cast<Page*>(memmap(fd_pages_, _num_pages * sizeof(Page)));
+    return;
+  }
+
+  data_ = memremap(data_, num_pages_ * page_size_, _num_pages * page_size_);
+
+  pages_ = reinterpret_cast<Page*>(
+      memremap(reinterpret_cast<char*>(pages_), num_pages_ * sizeof(Page),
+               _num_pages * sizeof(Page)));
 }
 
 // ----------------------------------------------------------------------------
@@ -255,12 +331,10 @@ void Pool::resize_pool(const size_t _num_pages) {
   const auto additional_bytes =
       (_num_pages - num_pages_) * (page_size_ + sizeof(Page));
   check_space_left(additional_bytes);
-  if (num_pages_ != 0) {
-    unmap();
-  }
   resize_file(fd_pages_, _num_pages * sizeof(Page));
   resize_file(fd_data_, _num_pages * page_size_);
   remap(_num_pages);
+  advise(_num_pages);
   init_pages(num_pages_, _num_pages);
   num_pages_ = _num_pages;
   free_blocks_tracker_.increase_pool_size(num_pages_);
@@ -269,6 +343,9 @@ void Pool::resize_pool(const size_t _num_pages) {
 // ----------------------------------------------------------------------------
 
 void Pool::unmap() {
+  if (num_pages_ == 0) {
+    return;
+  }
   munmap(data_, num_pages_ * page_size_);
   munmap(pages_, num_pages_ * sizeof(Page));
 }
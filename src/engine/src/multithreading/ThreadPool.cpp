@@ -0,0 +1,282 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "multithreading/ThreadPool.hpp"
+
+#include "debug/assert_true.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace multithreading {
+namespace {
+
+/// The engine-wide pool.
+std::shared_ptr<ThreadPool> engine_pool;
+
+/// Protects the engine-wide pool.
+std::mutex engine_pool_mtx;
+
+/// The state shared between the calling thread and the helpers in
+/// parallel_for(...). The helpers hold a shared_ptr to it, so helpers that
+/// are only started after the call has returned find nothing left to do, but
+/// do not touch freed memory.
+struct ParallelForState {
+  ParallelForState(const std::function<void(size_t)>& _f,
+                   const std::shared_ptr<const CancellationToken>& _token,
+                   std::vector<std::chrono::nanoseconds>* _timings,
+                   const size_t _num_tasks)
+      : f_(_f),
+        token_(_token),
+        timings_(_timings),
+        num_tasks_(_num_tasks),
+        failed_(false),
+        next_(0),
+        num_done_(0) {}
+
+  /// The function to call.
+  const std::function<void(size_t)> f_;
+
+  /// Signals that we should stop.
+  const std::shared_ptr<const CancellationToken> token_;
+
+  /// Optional output for the timings.
+  std::vector<std::chrono::nanoseconds>* const timings_;
+
+  /// The total number of calls.
+  const size_t num_tasks_;
+
+  /// Whether any of the calls has thrown.
+  std::atomic<bool> failed_;
+
+  /// The next index to be processed.
+  std::atomic<size_t> next_;
+
+  /// The number of indices that have been processed.
+  std::atomic<size_t> num_done_;
+
+  /// The first exception thrown.
+  std::exception_ptr error_;
+
+  /// Protects error_ and is used by cond_.
+  std::mutex mtx_;
+
+  /// Signals to the calling thread that all indices have been processed.
+  std::condition_variable cond_;
+};
+
+/// Processes indices until there are none left.
+void run_parallel_for(ParallelForState* _state) {
+  while (true) {
+    const auto i = _state->next_.fetch_add(1);
+
+    if (i >= _state->num_tasks_) {
+      return;
+    }
+
+    const bool skip = _state->failed_.load() ||
+                      (_state->token_ && _state->token_->is_cancelled());
+
+    if (!skip) {
+      const auto begin = std::chrono::steady_clock::now();
+
+      try {
+        _state->f_(i);
+      } catch (...) {
+        const auto lock = std::lock_guard<std::mutex>(_state->mtx_);
+        if (!_state->error_) {
+          _state->error_ = std::current_exception();
+        }
+        _state->failed_ = true;
+      }
+
+      if (_state->timings_) {
+        (*_state->timings_)[i] = std::chrono::steady_clock::now() - begin;
+      }
+    }
+
+    if (_state->num_done_.fetch_add(1) + 1 == _state->num_tasks_) {
+      const auto lock = std::lock_guard<std::mutex>(_state->mtx_);
+      _state->cond_.notify_all();
+    }
+  }
+}
+
+}  // namespace
+
+// ----------------------------------------------------------------------------
+
+ThreadPool::ThreadPool(const size_t _num_threads)
+    : busy_time_(0),
+      max_task_time_(0),
+      num_tasks_(0),
+      stopped_(false),
+      wait_time_(0) {
+  const auto num_threads =
+      _num_threads > 0
+          ? _num_threads
+          : std::max(static_cast<size_t>(std::thread::hardware_concurrency()),
+                     static_cast<size_t>(1));
+
+  for (size_t i = 0; i < num_threads; ++i) {
+    workers_.emplace_back([this]() { run_worker(); });
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+ThreadPool::~ThreadPool() {
+  {
+    const auto lock = std::lock_guard<std::mutex>(mtx_);
+    stopped_ = true;
+  }
+
+  cond_.notify_all();
+
+  for (auto& w : workers_) {
+    w.join();
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void ThreadPool::enqueue(std::function<void()> _f) {
+  {
+    const auto lock = std::lock_guard<std::mutex>(mtx_);
+    assert_true(!stopped_);
+    queue_.push_back(Task{.f_ = std::move(_f),
+                          .enqueued_ = std::chrono::steady_clock::now()});
+  }
+  cond_.notify_one();
+}
+
+// ----------------------------------------------------------------------------
+
+ThreadPool& ThreadPool::get() {
+  const auto lock = std::lock_guard<std::mutex>(engine_pool_mtx);
+  if (!engine_pool) {
+    engine_pool = std::make_shared<ThreadPool>(0);
+  }
+  return *engine_pool;
+}
+
+// ----------------------------------------------------------------------------
+
+void ThreadPool::init(const std::shared_ptr<ThreadPool>& _pool) {
+  assert_true(_pool);
+  const auto lock = std::lock_guard<std::mutex>(engine_pool_mtx);
+  engine_pool = _pool;
+}
+
+// ----------------------------------------------------------------------------
+
+void ThreadPool::parallel_for(
+    const size_t _num_tasks, const std::function<void(size_t)>& _f,
+    const std::shared_ptr<const CancellationToken>& _token,
+    std::vector<std::chrono::nanoseconds>* _timings) {
+  if (_num_tasks == 0) {
+    return;
+  }
+
+  if (_timings) {
+    _timings->assign(_num_tasks, std::chrono::nanoseconds(0));
+  }
+
+  const auto state =
+      std::make_shared<ParallelForState>(_f, _token, _timings, _num_tasks);
+
+  const auto num_helpers = std::min(_num_tasks - 1, num_threads());
+
+  for (size_t i = 0; i < num_helpers; ++i) {
+    enqueue([state]() { run_parallel_for(state.get()); });
+  }
+
+  run_parallel_for(state.get());
+
+  {
+    auto lock = std::unique_lock<std::mutex>(state->mtx_);
+    state->cond_.wait(lock, [&state]() {
+      return state->num_done_.load() >= state->num_tasks_;
+    });
+  }
+
+  if (state->error_) {
+    std::rethrow_exception(state->error_);
+  }
+
+  if (_token && _token->is_cancelled()) {
+    throw std::runtime_error("Interrupted.");
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+void ThreadPool::run_worker() {
+  while (true) {
+    auto task = Task();
+
+    {
+      auto lock = std::unique_lock<std::mutex>(mtx_);
+
+      cond_.wait(lock, [this]() { return stopped_ || queue_.size() > 0; });
+
+      if (queue_.size() == 0) {
+        return;
+      }
+
+      task = std::move(queue_.front());
+
+      queue_.pop_front();
+    }
+
+    const auto begin = std::chrono::steady_clock::now();
+
+    task.f_();
+
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto busy =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin)
+            .count();
+
+    const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          begin - task.enqueued_)
+                          .count();
+
+    busy_time_.fetch_add(busy);
+
+    wait_time_.fetch_add(wait);
+
+    auto max_task_time = max_task_time_.load();
+
+    while (busy > max_task_time &&
+           !max_task_time_.compare_exchange_weak(max_task_time, busy)) {
+    }
+
+    num_tasks_.fetch_add(1);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+typename ThreadPool::Stats ThreadPool::stats() const {
+  const auto num_queued = [this]() -> size_t {
+    const auto lock = std::lock_guard<std::mutex>(mtx_);
+    return queue_.size();
+  };
+
+  return Stats{
+      .num_threads_ = num_threads(),
+      .num_tasks_ = num_tasks_.load(),
+      .num_queued_ = num_queued(),
+      .busy_time_ = std::chrono::nanoseconds(busy_time_.load()),
+      .max_task_time_ = std::chrono::nanoseconds(max_task_time_.load()),
+      .wait_time_ = std::chrono::nanoseconds(wait_time_.load())};
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace multithreading
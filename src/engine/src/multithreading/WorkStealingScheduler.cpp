@@ -0,0 +1,145 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "multithreading/WorkStealingScheduler.hpp"
+
+#include "debug/assert_true.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace multithreading {
+// ----------------------------------------------------------------------------
+
+WorkStealingScheduler::WorkStealingScheduler(
+    const std::shared_ptr<const std::vector<size_t>>& _boundaries,
+    const size_t _num_threads)
+    : boundaries_(_boundaries),
+      num_threads_(std::max(_num_threads, static_cast<size_t>(1))),
+      slots_(std::make_unique<Slot[]>(num_threads_)) {
+  assert_true(boundaries_);
+  assert_true(boundaries_->size() > 0);
+  assert_true(boundaries_->front() == 0);
+  assert_true(num_chunks() < std::numeric_limits<std::uint32_t>::max());
+
+  const auto n = static_cast<std::uint64_t>(num_chunks());
+
+  const auto t = static_cast<std::uint64_t>(num_threads_);
+
+  for (std::uint64_t i = 0; i < t; ++i) {
+    slots_[i].range_.store(pack((i * n) / t, ((i + 1) * n) / t),
+                           std::memory_order_relaxed);
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+std::shared_ptr<const std::vector<size_t>>
+WorkStealingScheduler::make_boundaries(const std::vector<size_t>& _weights,
+                                       const size_t _num_chunks,
+                                       const size_t _max_chunk_size) {
+  assert_true(_max_chunk_size > 0);
+
+  const auto total =
+      std::accumulate(_weights.begin(), _weights.end(), static_cast<size_t>(0));
+
+  const auto num_chunks = std::max(_num_chunks, static_cast<size_t>(1));
+
+  const auto target =
+      std::max((total + num_chunks - 1) / num_chunks, static_cast<size_t>(1));
+
+  auto boundaries = std::make_shared<std::vector<size_t>>(1, 0);
+
+  size_t weight = 0;
+
+  for (size_t i = 0; i < _weights.size(); ++i) {
+    weight += _weights[i];
+
+    const auto chunk_size = i + 1 - boundaries->back();
+
+    if (weight >= target || chunk_size >= _max_chunk_size) {
+      boundaries->push_back(i + 1);
+      weight = 0;
+    }
+  }
+
+  if (boundaries->back() != _weights.size()) {
+    boundaries->push_back(_weights.size());
+  }
+
+  return boundaries;
+}
+
+// ----------------------------------------------------------------------------
+
+std::optional<std::pair<size_t, size_t>> WorkStealingScheduler::next(
+    const size_t _thread_num) {
+  assert_true(_thread_num < num_threads_);
+
+  if (const auto chunk = pop_front(_thread_num)) {
+    return to_rows(*chunk);
+  }
+
+  for (size_t i = 1; i < num_threads_; ++i) {
+    if (const auto chunk = steal_back((_thread_num + i) % num_threads_)) {
+      return to_rows(*chunk);
+    }
+  }
+
+  return std::nullopt;
+}
+
+// ----------------------------------------------------------------------------
+
+std::optional<size_t> WorkStealingScheduler::pop_front(
+    const size_t _thread_num) {
+  auto& range = slots_[_thread_num].range_;
+
+  auto current = range.load(std::memory_order_acquire);
+
+  while (true) {
+    const auto begin = current >> 32;
+
+    const auto end = current & 0xffffffff;
+
+    if (begin >= end) {
+      return std::nullopt;
+    }
+
+    if (range.compare_exchange_weak(current, pack(begin + 1, end),
+                                    std::memory_order_acq_rel)) {
+      return static_cast<size_t>(begin);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+
+std::optional<size_t> WorkStealingScheduler::steal_back(const size_t _victim) {
+  auto& range = slots_[_victim].range_;
+
+  auto current = range.load(std::memory_order_acquire);
+
+  while (true) {
+    const auto begin = current >> 32;
+
+    const auto end = current & 0xffffffff;
+
+    if (begin >= end) {
+      return std::nullopt;
+    }
+
+    if (range.compare_exchange_weak(current, pack(begin, end - 1),
+                                    std::memory_order_acq_rel)) {
+      return static_cast<size_t>(end - 1);
+    }
+  }
+}
+
+// ----------------------------------------------------------------------------
+}  // namespace multithreading
@@ -202,7 +202,8 @@ std::vector<IntFeature> PredictorImpl::transform_encodings(
 
   const auto pool = _X_categorical.at(0).pool()
                         ? std::make_shared<memmap::Pool>(
-                              _X_categorical.at(0).pool()->temp_dir())
+                              _X_categorical.at(0).pool()->temp_dir(),
+                              _X_categorical.at(0).pool()->options())
                         : _X_categorical.at(0).pool();
 
   std::vector<IntFeature> transformed(encodings_.size());
@@ -89,7 +89,8 @@ XGBoostMatrix XGBoostPredictor::convert_to_memory_mapped_dmatrix_dense(
   assert_true(_X_numerical.at(0).pool());
 
   const auto pool =
-      std::make_shared<memmap::Pool>(_X_numerical.at(0).pool()->temp_dir());
+      std::make_shared<memmap::Pool>(_X_numerical.at(0).pool()->temp_dir(),
+                                     _X_numerical.at(0).pool()->options());
 
   auto iter = std::make_unique<XGBoostIteratorDense>(_X_numerical, _y, pool);
 
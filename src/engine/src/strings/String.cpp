@@ -7,40 +7,101 @@
 
 #include "strings/String.hpp"
 
+#include <new>
+
 namespace strings {
+namespace {
 
-String::String() : chars_(std::make_unique<char[]>(1)) {
-  chars_.get()[0] = '\0';
+/// The hash of the empty string, which is also used for NULL strings,
+/// because they compare equal.
+size_t empty_hash() {
+  static const size_t hash = std::hash<std::string_view>()(std::string_view());
+  return hash;
 }
 
-String::String(const std::string& _str)
-    : chars_(std::make_unique<char[]>(_str.size() + 1)) {
-  std::copy(_str.begin(), _str.end(), chars_.get());
-  chars_.get()[_str.size()] = '\0';
-}
+}  // namespace
 
-String::String(const uint64_t _size)
-    : chars_(std::make_unique<char[]>(_size + 1)) {
-  chars_.get()[_size] = '\0';
+// ----------------------------------------------------------------------------
+
+String::String() : size_(0), hash_(0) {
+  allocate(0);
+  finalize();
 }
 
+String::String(const std::string& _str) : String(_str.data(), _str.size()) {}
+
 String::String(const char* _str) : String(_str, _str ? strlen(_str) : 0) {}
 
 String::String(const char* _str, const size_t _size)
-    : chars_(_str ? std::make_unique<char[]>(_size + 1) : nullptr) {
-  if (chars_) {
-    std::copy(_str, _str + _size, chars_.get());
-    chars_.get()[_size] = '\0';
+    : size_(NULL_SIZE), hash_(0) {
+  data_.inline_[0] = '\0';
+  hash_ = empty_hash();
+  if (_str) {
+    std::copy(_str, _str + _size, allocate(_size));
+    finalize();
   }
 }
 
 String::String(const String& _other)
-    : chars_(_other ? std::make_unique<char[]>(_other.size() + 1) : nullptr) {
-  if (chars_) {
-    strcpy(chars_.get(), _other.c_str());
+    : size_(_other.size_), hash_(_other.hash_), data_(_other.data_) {
+  if (size_ > MAX_INLINE_SIZE && size_ != NULL_SIZE) {
+    data_.block_->ref_count_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+String::String(String&& _other) noexcept
+    : size_(NULL_SIZE), hash_(empty_hash()) {
+  take(&_other);
+}
+
+// ----------------------------------------------------------------------------
+
+char* String::allocate(const size_t _size) {
+  size_ = _size;
+
+  if (_size <= MAX_INLINE_SIZE) {
+    return data_.inline_;
+  }
+
+  auto* memory = ::operator new(sizeof(Block) + _size + 1);
+
+  data_.block_ = new (memory) Block{.ref_count_ = 1};
+
+  return data_.block_->chars();
+}
+
+// ----------------------------------------------------------------------------
+
+void String::finalize() {
+  auto* chars = const_cast<char*>(c_str());
+  chars[size_] = '\0';
+  hash_ = std::hash<std::string_view>()(std::string_view(chars, size_));
+}
+
+// ----------------------------------------------------------------------------
+
+void String::release() noexcept {
+  if (size_ <= MAX_INLINE_SIZE || size_ == NULL_SIZE) {
+    return;
+  }
+
+  if (data_.block_->ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    data_.block_->~Block();
+    ::operator delete(data_.block_);
   }
 }
 
-String::String(String&& _other) noexcept : chars_(std::move(_other.chars_)) {}
+// ----------------------------------------------------------------------------
+
+void String::take(String* _other) noexcept {
+  size_ = _other->size_;
+  hash_ = _other->hash_;
+  data_ = _other->data_;
+  _other->size_ = NULL_SIZE;
+  _other->hash_ = empty_hash();
+  _other->data_.inline_[0] = '\0';
+}
+
+// ----------------------------------------------------------------------------
 
 }  // namespace strings
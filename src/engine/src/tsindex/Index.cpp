@@ -9,6 +9,17 @@
 
 namespace tsindex {
 
-Index::Index(const IndexParams& _params) : impl_(InMemoryIndex(_params)) {}
+Index::Index(const IndexParams& _params) : impl_(make_impl(_params)) {}
+
+// ----------------------------------------------------------------------------
+
+typename Index::ImplType Index::make_impl(const IndexParams& _params) {
+  if (_params.pool_) {
+    return ImplType(std::in_place_type<MemoryMappedIndex>, _params);
+  }
+  return ImplType(std::in_place_type<InMemoryIndex>, _params);
+}
+
+// ----------------------------------------------------------------------------
 
 }  // namespace tsindex
@@ -0,0 +1,39 @@
+// Copyright 2024 Code17 GmbH
+//
+// This file is licensed under the Elastic License 2.0 (ELv2).
+// Refer to the LICENSE.txt file in the root of the repository
+// for details.
+//
+
+#include "tsindex/MemoryMappedIndex.hpp"
+
+#include "debug/assert_true.hpp"
+#include "tsindex/IndexBuilder.hpp"
+
+#include <type_traits>
+
+namespace tsindex {
+
+// ----------------------------------------------------------------------------
+
+MemoryMappedIndex::MemoryMappedIndex(const IndexParams& _params)
+    : is_dense_(true),
+      join_keys_(_params.pool_),
+      memory_(_params.memory_),
+      offsets_(_params.pool_),
+      row_indices_(_params.pool_),
+      time_stamps_(_params.pool_) {
+  assert_true(_params.pool_);
+
+  const auto alloc = [&_params](auto* _vec, const size_t _size) {
+    using VectorType = std::remove_cvref_t<decltype(*_vec)>;
+    *_vec = VectorType(_params.pool_, _size);
+  };
+
+  is_dense_ = IndexBuilder::build(_params, alloc, &join_keys_, &offsets_,
+                                  &row_indices_, &time_stamps_);
+}
+
+// ----------------------------------------------------------------------------
+
+}  // namespace tsindex
@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "fastprop/algorithm/Aggregator.hpp"
+#include "fastprop/algorithm/CompiledConditions.hpp"
+#include "fastprop/algorithm/MatchCache.hpp"
+#include "fastprop/algorithm/Memoization.hpp"
+#include "fastprop/algorithm/TableHolder.hpp"
+#include "fastprop/algorithm/TableHolderParams.hpp"
+#include "fastprop/algorithm/WindowAggregator.hpp"
+#include "fastprop/containers/AbstractFeature.hpp"
+#include "fastprop/enums/Aggregation.hpp"
+#include "fastprop/enums/DataUsed.hpp"
+#include "gwt.h"
+#include "helpers/DataFrame.hpp"
+#include "helpers/DataFrameView.hpp"
+#include "helpers/Index.hpp"
+#include "helpers/Macros.hpp"
+#include "helpers/Placeholder.hpp"
+
+namespace {
+
+using fastprop::Float;
+
+auto make_float_column(std::vector<Float> const& values,
+                       std::string const& name) -> helpers::Column<Float> {
+  return helpers::Column<Float>(
+      std::make_shared<const std::vector<Float>>(values), name, {}, "");
+}
+
+// All rows share the same join key, so the whole table is a single time
+// series.
+auto make_join_key(std::size_t const nrows)
+    -> std::pair<helpers::Column<helpers::Int>,
+                 std::shared_ptr<helpers::Index>> {
+  auto const keys = std::vector<helpers::Int>(nrows, 0);
+  auto pairs = std::vector<std::pair<helpers::Int, std::size_t>>();
+  for (std::size_t i = 0; i < nrows; ++i) {
+    pairs.emplace_back(keys[i], i);
+  }
+  auto index = std::make_shared<helpers::Index>(
+      std::in_place_type<helpers::InMemoryIndex>, nullptr);
+  std::get<helpers::InMemoryIndex>(*index).append(pairs);
+  return std::make_pair(
+      helpers::Column<helpers::Int>(
+          std::make_shared<const std::vector<helpers::Int>>(keys), "jk", {},
+          ""),
+      index);
+}
+
+auto make_placeholder() -> helpers::Placeholder {
+  using P = helpers::Placeholder;
+
+  auto const peripheral = P(P::NeededForTraining(
+      P::f_allow_lagged_targets({}), P::f_joined_tables({}),
+      P::f_join_keys_used({}), P::f_name("PERIPHERAL"),
+      P::f_other_join_keys_used({}), P::f_other_time_stamps_used({}),
+      P::f_propositionalization({}), P::f_time_stamps_used({}),
+      P::f_upper_time_stamps_used({})));
+
+  return P(P::NeededForTraining(
+      P::f_allow_lagged_targets({false}), P::f_joined_tables({peripheral}),
+      P::f_join_keys_used({"jk"}), P::f_name("POPULATION"),
+      P::f_other_join_keys_used({"jk"}), P::f_other_time_stamps_used({"ts"}),
+      P::f_propositionalization({false}), P::f_time_stamps_used({"ts"}),
+      P::f_upper_time_stamps_used(
+          {"ts" + helpers::Macros::generated_ts()})));
+}
+
+// Every row in the population table matches the peripheral row with the same
+// time stamp and the one before, so the window slides by one row at a time.
+auto make_match_cache(std::vector<Float> const& values)
+    -> std::shared_ptr<const fastprop::algorithm::MatchCache> {
+  auto const nrows = values.size();
+
+  auto time_stamps = std::vector<Float>(nrows);
+  auto upper_time_stamps = std::vector<Float>(nrows);
+  for (std::size_t i = 0; i < nrows; ++i) {
+    time_stamps[i] = static_cast<Float>(i);
+    upper_time_stamps[i] = static_cast<Float>(i + 2);
+  }
+
+  auto const [population_jk, population_index] = make_join_key(nrows);
+
+  auto const population = helpers::DataFrame(helpers::DataFrameParams{
+      .indices_ = {population_index},
+      .join_keys_ = {population_jk},
+      .name_ = "POPULATION",
+      .time_stamps_ = {make_float_column(time_stamps, "ts")}});
+
+  auto const [peripheral_jk, peripheral_index] = make_join_key(nrows);
+
+  auto const peripheral = helpers::DataFrame(helpers::DataFrameParams{
+      .indices_ = {peripheral_index},
+      .join_keys_ = {peripheral_jk},
+      .name_ = "PERIPHERAL",
+      .numericals_ = {make_float_column(values, "val")},
+      .time_stamps_ = {make_float_column(time_stamps, "ts"),
+                       make_float_column(
+                           upper_time_stamps,
+                           "ts" + helpers::Macros::generated_ts())}});
+
+  auto const rownums = std::make_shared<const std::vector<std::size_t>>(
+      std::views::iota(0uz, nrows) | std::ranges::to<std::vector>());
+
+  auto const table_holder =
+      std::make_shared<const fastprop::algorithm::TableHolder>(
+          fastprop::algorithm::TableHolderParams{
+              .peripheral_ = {peripheral},
+              .peripheral_names_ = {"PERIPHERAL"},
+              .placeholder_ = make_placeholder(),
+              .population_ = helpers::DataFrameView(population, rownums)});
+
+  return std::make_shared<const fastprop::algorithm::MatchCache>(
+      table_holder, rownums,
+      fastprop::algorithm::MatchCache::default_memory_budget(std::nullopt),
+      std::nullopt);
+}
+
+// Applies the aggregation to every row, once by sliding the window and once
+// row by row.
+auto compare(fastprop::algorithm::MatchCache const& match_cache,
+             fastprop::enums::Aggregation const aggregation)
+    -> std::pair<std::vector<Float>, std::vector<Float>> {
+  auto const abstract_feature = fastprop::containers::AbstractFeature(
+      aggregation, {}, fastprop::enums::DataUsed::make<"numerical">(), 0, 0);
+
+  auto const conditions = fastprop::algorithm::CompiledConditions({}, {});
+
+  auto const nrows = match_cache.rownums().size();
+
+  EXPECT_TRUE(fastprop::algorithm::WindowAggregator::is_supported(
+      match_cache, abstract_feature, conditions));
+
+  auto sliding = std::vector<Float>(nrows);
+  auto workspace = fastprop::algorithm::WindowAggregator::Workspace();
+  fastprop::algorithm::WindowAggregator::apply_aggregation(
+      match_cache, abstract_feature, conditions, 0, nrows, &workspace,
+      sliding.data(), 1);
+
+  auto const& table_holder = match_cache.table_holder();
+  auto const memoization = rfl::Ref<fastprop::algorithm::Memoization>::make();
+  auto buffer = std::vector<fastprop::containers::Match>();
+  auto row_by_row = std::vector<Float>(nrows);
+  for (std::size_t i = 0; i < nrows; ++i) {
+    memoization->reset();
+    row_by_row[i] = fastprop::algorithm::Aggregator::apply_aggregation(
+        table_holder.main_tables().at(0).df(),
+        table_holder.peripheral_tables().at(0), std::nullopt,
+        match_cache.matches(0, i, &buffer), conditions, abstract_feature,
+        memoization);
+  }
+
+  return std::make_pair(sliding, row_by_row);
+}
+
+auto expect_near(std::vector<Float> const& expected,
+                 std::vector<Float> const& actual) -> void {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(actual[i])) << "row: " << i;
+      continue;
+    }
+    auto const tolerance = 1e-9 * std::max(1.0, std::abs(expected[i]));
+    EXPECT_NEAR(expected[i], actual[i], tolerance) << "row: " << i;
+  }
+}
+
+}  // namespace
+
+TEST(TestWindowAggregator, TestLargeValuesLeavingTheWindow) {
+  GWT::given([]() {
+    return make_match_cache(
+        {1e17, 1.0, 1.0, 3.0, -2e16, 5.0, 2.0, 2.0, 1e17, 1e17, 4.0, 1.0});
+  })
+      .when([](auto&& match_cache) {
+        auto results = std::vector<std::pair<std::vector<Float>,
+                                             std::vector<Float>>>();
+        results.push_back(compare(
+            *match_cache, fastprop::enums::Aggregation::make<"AVG">()));
+        results.push_back(compare(
+            *match_cache, fastprop::enums::Aggregation::make<"COUNT">()));
+        results.push_back(compare(
+            *match_cache, fastprop::enums::Aggregation::make<"STDDEV">()));
+        results.push_back(compare(
+            *match_cache, fastprop::enums::Aggregation::make<"SUM">()));
+        results.push_back(compare(
+            *match_cache, fastprop::enums::Aggregation::make<"VAR">()));
+        return results;
+      })
+      .then([](auto&& results) {
+        for (auto const& [sliding, row_by_row] : results) {
+          expect_near(row_by_row, sliding);
+        }
+        // The second window is [1e17, 1], the third one is [1, 1].
+        auto const& sum = results.at(3).first;
+        EXPECT_EQ(2.0, sum.at(2));
+        auto const& var = results.at(4).first;
+        EXPECT_EQ(0.0, var.at(2));
+      });
+}
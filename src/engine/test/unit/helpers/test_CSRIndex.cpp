@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+#include <malloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "containers/Column.hpp"
+#include "containers/Index.hpp"
+#include "containers/Int.hpp"
+#include "gwt.h"
+#include "helpers/CSRIndex.hpp"
+#include "memmap/Pool.hpp"
+
+namespace {
+
+// Tracks the heap usage while enabled, so we can check that the
+// memory-mapped variant does not rebuild its arrays on the heap.
+std::atomic<bool> track_heap = false;
+
+std::atomic<std::ptrdiff_t> heap_bytes = 0;
+
+std::atomic<std::ptrdiff_t> peak_heap_bytes = 0;
+
+auto on_allocate(void* const ptr) -> void {
+  if (!ptr || !track_heap) {
+    return;
+  }
+  auto const current =
+      heap_bytes += static_cast<std::ptrdiff_t>(malloc_usable_size(ptr));
+  auto peak = peak_heap_bytes.load();
+  while (current > peak &&
+         !peak_heap_bytes.compare_exchange_weak(peak, current)) {
+  }
+}
+
+auto on_deallocate(void* const ptr) -> void {
+  if (ptr && track_heap) {
+    heap_bytes -= static_cast<std::ptrdiff_t>(malloc_usable_size(ptr));
+  }
+}
+
+}  // namespace
+
+auto operator new(std::size_t const size) -> void* {
+  auto const ptr = std::malloc(std::max(size, static_cast<std::size_t>(1)));
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  on_allocate(ptr);
+  return ptr;
+}
+
+auto operator delete(void* const ptr) noexcept -> void {
+  on_deallocate(ptr);
+  std::free(ptr);
+}
+
+auto operator delete(void* const ptr, std::size_t) noexcept -> void {
+  on_deallocate(ptr);
+  std::free(ptr);
+}
+
+namespace {
+
+using Pairs = std::vector<std::pair<containers::Int, std::size_t>>;
+
+using Expected = std::map<containers::Int, std::vector<std::size_t>>;
+
+template <bool _memory_mapped>
+struct Variant {
+  using IndexType =
+      helpers::CSRIndex<containers::Int, std::hash<containers::Int>,
+                        _memory_mapped>;
+
+  static auto make_pool() -> std::shared_ptr<memmap::Pool> {
+    if constexpr (_memory_mapped) {
+      return std::make_shared<memmap::Pool>(
+          (std::filesystem::temp_directory_path() / "getml_test_CSRIndex")
+              .string());
+    } else {
+      return nullptr;
+    }
+  }
+};
+
+template <class VariantType>
+class TestCSRIndex : public ::testing::Test {};
+
+using Variants = ::testing::Types<Variant<false>, Variant<true>>;
+
+TYPED_TEST_SUITE(TestCSRIndex, Variants);
+
+// Generates _num_rows pairs beginning with row _begin. The keys repeat every
+// _num_keys rows.
+auto make_pairs(std::size_t const begin, std::size_t const num_rows,
+                std::size_t const num_keys) -> Pairs {
+  auto pairs = Pairs();
+  for (auto i = begin; i < begin + num_rows; ++i) {
+    pairs.emplace_back(static_cast<containers::Int>((i * 7) % num_keys), i);
+  }
+  return pairs;
+}
+
+auto add_to_expected(Pairs const& pairs, Expected* expected) -> void {
+  for (auto const& [key, rownum] : pairs) {
+    (*expected)[key].push_back(rownum);
+  }
+}
+
+template <class IndexType>
+auto expect_matches(IndexType const& index, Expected const& expected)
+    -> void {
+  for (auto const& [key, rownums] : expected) {
+    auto const [begin, end] = index.find(key);
+    ASSERT_NE(nullptr, begin) << "key: " << key;
+    EXPECT_EQ(rownums, std::vector<std::size_t>(begin, end)) << "key: " << key;
+  }
+}
+
+}  // namespace
+
+TYPED_TEST(TestCSRIndex, TestAppendThroughDeltaBuffer) {
+  GWT::given([]() {
+    auto batches = std::vector<Pairs>();
+    // The first batch is frozen right away, the smaller ones go into the
+    // delta buffer until it becomes too large.
+    batches.push_back(make_pairs(0, 1000, 50));
+    for (std::size_t i = 0; i < 40; ++i) {
+      batches.push_back(make_pairs(1000 + i * 10, 10, 60));
+    }
+    return batches;
+  })
+      .when([](auto&& batches) {
+        auto index = typename TypeParam::IndexType(TypeParam::make_pool());
+        auto expected = Expected();
+        auto num_rownums = std::vector<std::size_t>();
+        for (auto const& batch : batches) {
+          index.append(batch);
+          add_to_expected(batch, &expected);
+          expect_matches(index, expected);
+          num_rownums.push_back(index.size());
+        }
+        return num_rownums;
+      })
+      .then([](auto&& num_rownums) {
+        EXPECT_EQ(1000uz, num_rownums.front());
+        EXPECT_EQ(1400uz, num_rownums.back());
+      });
+}
+
+TYPED_TEST(TestCSRIndex, TestFindMissingKeys) {
+  GWT::given([]() {
+    auto index = typename TypeParam::IndexType(TypeParam::make_pool());
+    index.append(make_pairs(0, 100, 10));
+    index.append(make_pairs(100, 5, 20));
+    return std::make_shared<typename TypeParam::IndexType>(std::move(index));
+  })
+      .when([](auto&& index) {
+        // 14 is only contained in the delta buffer.
+        return std::vector{index->find(1000), index->find(14)};
+      })
+      .then([](auto&& ranges) {
+        EXPECT_EQ(nullptr, ranges.at(0).first);
+        EXPECT_EQ(nullptr, ranges.at(0).second);
+        EXPECT_NE(nullptr, ranges.at(1).first);
+      });
+}
+
+TYPED_TEST(TestCSRIndex, TestNullKeysAreNotIndexed) {
+  GWT::given([]() {
+    // The CSRIndex itself does not know about NULL values, the
+    // containers::Index filters them out before appending.
+    auto const keys = std::make_shared<std::vector<containers::Int>>(
+        std::vector<containers::Int>{3, -1, 5, -1, 3});
+    auto index = containers::Index<containers::Int>(TypeParam::make_pool());
+    index.calculate(containers::Column<containers::Int>(keys));
+    return index;
+  })
+      .when([](auto&& index) {
+        return std::vector{index.find(-1), index.find(3), index.find(5)};
+      })
+      .then([](auto&& ranges) {
+        EXPECT_EQ(nullptr, ranges.at(0).first);
+        EXPECT_EQ(nullptr, ranges.at(0).second);
+        EXPECT_EQ((std::vector<std::size_t>{0, 4}),
+                  std::vector<std::size_t>(ranges.at(1).first,
+                                           ranges.at(1).second));
+        EXPECT_EQ((std::vector<std::size_t>{2}),
+                  std::vector<std::size_t>(ranges.at(2).first,
+                                           ranges.at(2).second));
+      });
+}
+
+TYPED_TEST(TestCSRIndex, TestFindOnEmptyIndex) {
+  GWT::given(
+      []() { return typename TypeParam::IndexType(TypeParam::make_pool()); })
+      .when([](auto&& index) { return index.find(0); })
+      .then([](auto&& range) {
+        EXPECT_EQ(nullptr, range.first);
+        EXPECT_EQ(nullptr, range.second);
+      });
+}
+
+TYPED_TEST(TestCSRIndex, TestParallelRebuild) {
+  using IndexType = typename TypeParam::IndexType;
+  GWT::given([]() {
+    return std::vector{make_pairs(0, IndexType::MIN_PARALLEL_SIZE, 5003),
+                       make_pairs(IndexType::MIN_PARALLEL_SIZE, 100, 7001),
+                       make_pairs(IndexType::MIN_PARALLEL_SIZE + 100,
+                                  IndexType::MIN_PARALLEL_SIZE, 9001)};
+  })
+      .when([](auto&& batches) {
+        auto index = IndexType(TypeParam::make_pool());
+        auto expected = Expected();
+        for (auto const& batch : batches) {
+          index.append(batch);
+          add_to_expected(batch, &expected);
+        }
+        return std::make_tuple(std::make_shared<IndexType>(std::move(index)),
+                               expected);
+      })
+      .then([](auto&& result) {
+        auto const& [index, expected] = result;
+        EXPECT_EQ(2 * IndexType::MIN_PARALLEL_SIZE + 100, index->size());
+        expect_matches(*index, expected);
+      });
+}
+
+TYPED_TEST(TestCSRIndex, TestClear) {
+  GWT::given([]() {
+    auto index = typename TypeParam::IndexType(TypeParam::make_pool());
+    index.append(make_pairs(0, 100, 10));
+    return std::make_shared<typename TypeParam::IndexType>(std::move(index));
+  })
+      .when([](auto&& index) {
+        index->clear();
+        index->append(make_pairs(0, 10, 5));
+        return index;
+      })
+      .then([](auto&& index) {
+        auto expected = Expected();
+        add_to_expected(make_pairs(0, 10, 5), &expected);
+        EXPECT_EQ(10uz, index->size());
+        expect_matches(*index, expected);
+        EXPECT_EQ(nullptr, index->find(9).first);
+      });
+}
+
+TEST(TestCSRIndex, TestMemoryMappedRebuildStaysInPool) {
+  using IndexType =
+      helpers::CSRIndex<containers::Int, std::hash<containers::Int>, true>;
+  constexpr std::size_t num_rows = 4 * IndexType::MIN_PARALLEL_SIZE;
+  constexpr std::size_t num_keys = 1000;
+  GWT::given([]() {
+    auto pool = Variant<true>::make_pool();
+    auto index = std::make_shared<IndexType>(pool);
+    index->append(make_pairs(0, num_rows, num_keys));
+    return std::make_tuple(pool, index);
+  })
+      .when([](auto&& given) {
+        auto const& [pool, index] = given;
+        // Large enough to trigger a rebuild of the frozen part.
+        auto const batch = make_pairs(
+            num_rows, num_rows / IndexType::MAX_DELTA_RATIO, num_keys);
+        heap_bytes = 0;
+        peak_heap_bytes = 0;
+        track_heap = true;
+        index->append(batch);
+        track_heap = false;
+        return std::make_tuple(pool, index, peak_heap_bytes.load());
+      })
+      .then([](auto&& result) {
+        auto const& [pool, index, peak] = result;
+        auto const rownums_bytes =
+            static_cast<std::ptrdiff_t>(index->size() * sizeof(std::size_t));
+        EXPECT_EQ(num_rows + num_rows / IndexType::MAX_DELTA_RATIO,
+                  index->size());
+        // Only the bookkeeping for the keys and the new pairs may live on
+        // the heap, the rebuilt rownums alone are larger than that.
+        EXPECT_LT(peak, rownums_bytes);
+        EXPECT_GE(
+            static_cast<std::ptrdiff_t>(pool->num_allocated_pages() *
+                                        pool->page_size()),
+            rownums_bytes);
+      });
+}
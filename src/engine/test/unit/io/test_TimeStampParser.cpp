@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <Poco/DateTime.h>
+#include <Poco/DateTimeFormatter.h>
+#include <Poco/DateTimeParser.h>
+
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "gwt.h"
+#include "io/TimeStampParser.hpp"
+
+using namespace std::literals::string_literals;
+
+namespace {
+
+using Results = std::vector<std::pair<io::Float, bool>>;
+
+// What Poco::DateTimeParser makes of the string: The first format that
+// parses the string and reproduces it when formatting the result is used.
+auto parse_with_poco(std::vector<std::string> const& formats,
+                     std::string const& str) -> std::pair<io::Float, bool> {
+  for (auto const& fmt : formats) {
+    int utc = Poco::DateTimeFormatter::UTC;
+    auto date_time = Poco::DateTime();
+    if (!Poco::DateTimeParser::tryParse(fmt, str, date_time, utc)) {
+      continue;
+    }
+    auto const time_stamp = date_time.timestamp();
+    if (Poco::DateTimeFormatter::format(time_stamp, fmt) == str) {
+      return std::make_pair(
+          static_cast<io::Float>(time_stamp.epochMicroseconds()) / 1.0e6,
+          true);
+    }
+  }
+  return std::make_pair(0.0, false);
+}
+
+auto parse_all(std::vector<std::string> const& formats,
+               std::vector<std::string> const& strings) -> Results {
+  auto const parser = io::TimeStampParser(formats);
+  auto results = Results();
+  for (auto const& str : strings) {
+    results.push_back(parser.parse(str));
+  }
+  return results;
+}
+
+auto expect_same_as_poco(std::vector<std::string> const& formats,
+                         std::vector<std::string> const& strings,
+                         Results const& results) -> void {
+  ASSERT_EQ(strings.size(), results.size());
+  for (std::size_t i = 0; i < strings.size(); ++i) {
+    auto const [expected, expected_success] =
+        parse_with_poco(formats, strings[i]);
+    EXPECT_EQ(expected_success, results[i].second) << "string: " << strings[i];
+    if (expected_success && results[i].second) {
+      EXPECT_DOUBLE_EQ(expected, results[i].first) << "string: " << strings[i];
+    }
+  }
+}
+
+}  // namespace
+
+TEST(TestTimeStampParser, TestCompiledFormatsMatchPoco) {
+  GWT::given(std::make_pair(
+                 std::vector{"%Y-%m-%d %H:%M:%S.%F"s, "%Y-%m-%d %H:%M:%S.%i"s,
+                             "%Y-%m-%dT%H:%M:%S%z"s, "%Y-%m-%d %H:%M:%S %Z"s,
+                             "%Y-%m-%d"s},
+                 std::vector{"2024-01-01 12:00:00.123456"s,
+                             "2024-01-01 12:00:00.123"s,
+                             "1969-12-31 23:59:59.000001"s,
+                             "2024-06-01T08:30:00Z"s,
+                             "2024-06-01T08:30:00+02:00"s,
+                             "2024-06-01 08:30:00 GMT"s, "2024-02-29"s,
+                             "2023-02-29"s, "2024-04-31"s, "2024-13-01"s,
+                             "2024-00-10"s, "2024-01-01 24:00:00.000"s,
+                             "2024-01-01 12:60:00.000"s, "2024-1-01"s,
+                             "not a date"s, ""s}))
+      .when([](auto const&& args) {
+        auto const& [formats, strings] = args;
+        return std::make_tuple(formats, strings, parse_all(formats, strings));
+      })
+      .then([](auto const&& result) {
+        auto const& [formats, strings, results] = result;
+        expect_same_as_poco(formats, strings, results);
+        EXPECT_TRUE(results.at(0).second);
+        EXPECT_DOUBLE_EQ(1704110400.123456, results.at(0).first);
+        EXPECT_DOUBLE_EQ(1704110400.123, results.at(1).first);
+        EXPECT_FALSE(results.at(7).second);
+      });
+}
+
+TEST(TestTimeStampParser, TestWhitespaceIsIgnored) {
+  GWT::given(std::vector{"%Y-%m-%d %H:%M:%S"s})
+      .when([](auto const&& formats) {
+        return parse_all(formats, {" 2024-01-01 12:00:00\t"s});
+      })
+      .then([](auto const&& results) {
+        EXPECT_TRUE(results.at(0).second);
+        EXPECT_DOUBLE_EQ(1704110400.0, results.at(0).first);
+      });
+}
+
+TEST(TestTimeStampParser, TestFallbackToPoco) {
+  // %b and %A cannot be compiled, so these formats are handled by Poco.
+  GWT::given(std::make_pair(
+                 std::vector{"%d %b %Y"s, "%A, %d %b %Y %H:%M:%S"s,
+                             "%Y-%m-%d"s},
+                 std::vector{"01 Jan 2024"s, "29 Feb 2023"s,
+                             "Monday, 01 Jan 2024 12:00:00"s,
+                             "Tuesday, 01 Jan 2024 12:00:00"s,
+                             "2024-01-01"s, "01 Foo 2024"s}))
+      .when([](auto const&& args) {
+        auto const& [formats, strings] = args;
+        return std::make_tuple(formats, strings, parse_all(formats, strings));
+      })
+      .then([](auto const&& result) {
+        auto const& [formats, strings, results] = result;
+        expect_same_as_poco(formats, strings, results);
+        EXPECT_TRUE(results.at(0).second);
+        EXPECT_DOUBLE_EQ(1704067200.0, results.at(0).first);
+        EXPECT_TRUE(results.at(2).second);
+        EXPECT_DOUBLE_EQ(1704110400.0, results.at(2).first);
+      });
+}
+
+TEST(TestTimeStampParser, TestStaleHintWithAlternatingFormats) {
+  // The first two formats have the same shape, so the format that matched
+  // the last string must not be tried first. The third one is exclusive.
+  GWT::given(std::make_pair(
+                 std::vector{"%Y-%m-%d"s, "%Y-%d-%m"s, "%d.%m.%Y"s},
+                 std::vector{"2024-13-06"s, "2024-05-06"s, "06.05.2024"s,
+                             "2024-05-06"s, "2024-13-06"s, "06.05.2024"s,
+                             "2024-13-06"s, "2024-05-06"s}))
+      .when([](auto const&& args) {
+        auto const& [formats, strings] = args;
+        return std::make_tuple(formats, strings, parse_all(formats, strings));
+      })
+      .then([](auto const&& result) {
+        auto const& [formats, strings, results] = result;
+        expect_same_as_poco(formats, strings, results);
+        // 2024-05-06 is the 6th of May, even right after the 13th of June.
+        auto const may_6 = 1714953600.0;
+        auto const june_13 = 1718236800.0;
+        EXPECT_DOUBLE_EQ(june_13, results.at(0).first);
+        EXPECT_DOUBLE_EQ(may_6, results.at(1).first);
+        EXPECT_DOUBLE_EQ(may_6, results.at(2).first);
+        EXPECT_DOUBLE_EQ(may_6, results.at(3).first);
+        EXPECT_DOUBLE_EQ(june_13, results.at(6).first);
+        EXPECT_DOUBLE_EQ(may_6, results.at(7).first);
+      });
+}